@@ -0,0 +1,64 @@
+/**
+ * @file AdaptiveTriangulation.hpp
+ * @author King Attalus II
+ * @brief This file contains the AdaptiveTriangulation class, which is used to triangulate a terrain grid with as few
+ * triangles as a maximum height error allows.
+ * @details A uniform grid spends as many triangles on a flat plain or ocean floor as it does on a cliff. The adaptive
+ * triangulation is a right-triangulated irregular network: the grid is covered by two right triangles that are
+ * repeatedly split in half across their hypotenuse, and a triangle is only split when the heights it covers are
+ * further than the maximum error from the plane through its corners. An error map is built first so that neighbouring
+ * triangles always split together, which keeps the mesh free of cracks and T-junctions.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef ADAPTIVETRIANGULATION_HPP
+#define ADAPTIVETRIANGULATION_HPP
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief This class contains the static functions that build the error map and index buffer of an adaptive
+ * triangulation.
+ *
+ * @details The grids are square with numberOfVerticesPerAxis vertices per axis and vertex (x, z) has the index
+ * z * numberOfVerticesPerAxis + x, the same as the grids from MeshIndexing. The triangles have the same winding as the
+ * grid triangles and only use the vertices of the grid, so the vertex buffer of a uniform mesh can be drawn with an
+ * adaptive index buffer. The triangulation needs 2^k + 1 vertices per axis, so smaller grids are triangulated within
+ * the next size up and the triangles that cross the edge of the grid are always split.
+ *
+ */
+class AdaptiveTriangulation
+{
+private:
+    // The constructor is private as we do not want to instantiate this class
+    inline AdaptiveTriangulation(){};
+    inline ~AdaptiveTriangulation(){};
+
+    static void emitTriangle(
+        const vector<float> &errors,
+        int gridSize,
+        int numberOfVerticesPerAxis,
+        float maxError,
+        int ax,
+        int az,
+        int bx,
+        int bz,
+        int cx,
+        int cz,
+        vector<unsigned int> &indices
+    );
+public:
+    static int getGridSize(int numberOfVerticesPerAxis);
+    static vector<float> computeErrors(const float *heights, int numberOfVerticesPerAxis);
+    static vector<unsigned int> generateIndices(const float *heights, int numberOfVerticesPerAxis, float maxError);
+    static vector<unsigned int> generateIndicesFromErrors(
+        const vector<float> &errors,
+        int numberOfVerticesPerAxis,
+        float maxError
+    );
+};
+
+#endif // ADAPTIVETRIANGULATION_HPP
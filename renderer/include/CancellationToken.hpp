@@ -0,0 +1,45 @@
+/**
+ * @file CancellationToken.hpp
+ * @author King Attalus II
+ * @brief This file contains the CancellationToken class, which is used to abandon background work that belongs to a
+ * previous generation of the world.
+ * @details Each world holds a generation epoch that is bumped whenever its contents are thrown away (regeneration,
+ * seed change or shutdown). Background tasks capture a token when they are launched and poll it at convenient points
+ * so that they can stop as soon as the epoch they were started in is no longer current.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef CANCELLATIONTOKEN_HPP
+#define CANCELLATIONTOKEN_HPP
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief This class represents a lightweight handle that can be queried to determine if a piece of background work
+ * has been cancelled.
+ *
+ * @details The token stores the epoch that was current when it was created along with a shared reference to the
+ * epoch counter. The work is considered cancelled once the counter has moved on. A default constructed token is never
+ * cancelled, which allows callers that do not care about cancellation to pass an empty token.
+ *
+ */
+class CancellationToken
+{
+private:
+    shared_ptr<const atomic<uint64_t>> source; // The epoch counter that this token is tied to
+    uint64_t epoch; // The epoch that was current when this token was created
+public:
+    CancellationToken();
+    CancellationToken(shared_ptr<const atomic<uint64_t>> inSource);
+    ~CancellationToken() {};
+
+    bool isCancelled() const;
+    uint64_t getEpoch() const {return epoch;}
+};
+
+#endif // CANCELLATIONTOKEN_HPP
@@ -11,12 +11,18 @@
 
 #ifdef DEPARTMENT_BUILD
     #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+    #include "/dcs/large/efogahlewem/.local/include/glad/glad.h"
 #else
     #include <glm/glm.hpp>
+    #include <glad/glad.h>
 #endif
 
 
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <utility>
 
 #include "Settings.hpp"
 #include "IRenderable.hpp"
@@ -25,13 +31,43 @@
 #include "Texture.hpp"
 #include "Light.hpp"
 #include "WaterFrameBuffer.hpp"
+#include "ChunkQuadtree.hpp"
+#include "WorkerPool.hpp"
+#include "CancellationToken.hpp"
+#include "GpuBufferPool.hpp"
+#include "SubChunkCache.hpp"
+#include "HeightPyramid.hpp"
+#include "SlabPool.hpp"
 
 using namespace std;
 
 class SubChunk; // Forward declaration of the SubChunk class
 
+/**
+ * @brief This struct holds the settings that the level of detail of the subchunks depends on, so that the chunk can
+ * tell when one of them has changed.
+ *
+ */
+struct SubChunkLodSettings {
+    int renderDistance; // The render distance in subchunks
+    float subChunkResolution; // The resolution of the subchunks closest to the player
+    int windowHeight; // The height of the window in pixels
+    float lodPixelError; // The largest projected error allowed in pixels
+    float fieldOfView; // The vertical field of view of the camera in degrees used to project the error
+    float lodMorphRatio; // The fraction of each distance band over which the subchunks morph
+
+    bool operator==(const SubChunkLodSettings &other) const {
+        return renderDistance == other.renderDistance && subChunkResolution == other.subChunkResolution &&
+            windowHeight == other.windowHeight && lodPixelError == other.lodPixelError &&
+            fieldOfView == other.fieldOfView && lodMorphRatio == other.lodMorphRatio;
+    }
+    bool operator!=(const SubChunkLodSettings &other) const { return !(*this == other); }
+};
+
 class Chunk: public IRenderable, public enable_shared_from_this<Chunk> {
 private:
+    static const size_t SUBCHUNK_CONTROL_BYTES = 64; // The room left in a subchunk slot for the shared pointer counts
+    static const int SUBCHUNKS_PER_SLAB = 64; // The number of subchunks allocated together in the subchunk pool
     long id; // Unique identifier for the chunk
     int size; // The size of the chunk
     int subChunkSize; // The size of the subchunks within the chunk
@@ -43,9 +79,20 @@ private:
     // This is the heightmap data for the chunk
     vector<vector<float>> heightmapData;
     vector<vector<uint8_t>> biomeData; // The biome data for the chunk
-    // Using ids 0-1023 we can have a unique id for each subchunk within the chunk
+    // Using ids 0-1088 we can have a unique id for each subchunk within the chunk, the quadtree
+    // patches that cover several subchunks use the ids after these
     vector<shared_ptr<SubChunk>> loadedSubChunks; // Tracks the subchunks that are loaded
     vector<shared_ptr<SubChunk>> cachedSubChunks; // Tracks the subchunks that are cached
+    shared_ptr<SlabPool> subChunkPool; // The contiguous storage that the subchunks of the chunk are allocated from
+    shared_ptr<ChunkQuadtree> quadtree; // Selects which subchunks are merged into coarser patches
+    shared_ptr<HeightPyramid> heightPyramid; // The min/max pyramid of the heightmap used for height bound queries
+    bool subChunksEvaluated; // Whether the subchunks have been evaluated yet
+    glm::ivec2 lastPlayerCell; // The subchunk cell the player was in when the subchunks were last evaluated
+    SubChunkLodSettings lastLodSettings; // The level of detail settings used when the subchunks were last evaluated
+    // The nodes that have had a loaded or cached subchunk, some of which may since have been dropped, so that the
+    // subchunks can be evaluated without visiting every node of the quadtree
+    vector<int> residentNodes;
+    vector<uint8_t> residentListed; // Whether each node is in residentNodes
     shared_ptr<Shader> terrainShader; // The shader for the terrain object
     shared_ptr<Shader> oceanShader; // The shader for the ocean object
     vector<shared_ptr<Texture>> terrainTextures; // The textures for the terrain
@@ -54,6 +101,40 @@ private:
     shared_ptr<WaterFrameBuffer> refractionBuffer; // The framebuffer that will be used for the refraction
     vector<shared_ptr<Texture>> oceanTextures; // The textures for the ocean
     const int* subbiomeTextureArrayMap; // The texture array map for the subbiomes
+    bool placeholder; // Whether the chunk holds approximate terrain while the real chunk is generated
+    bool fading; // Whether the chunk is currently cross-fading
+    bool fadingOut; // Whether the chunk is fading out rather than in
+    double fadeStartTime; // The time the fade started at, negative until the first update
+    float fade; // The visible fraction of the chunk
+    shared_ptr<WorkerPool> meshWorkers; // The threads that build subchunk meshes, null to build on the main thread
+    unordered_map<int, float> pendingBuilds; // The resolution of each subchunk that is being built in the background
+    vector<shared_ptr<SubChunk>> builtSubChunks; // The subchunks that have been built but not yet uploaded
+    mutex builtMutex; // Guards builtSubChunks as it is filled by the mesh workers
+    CancellationToken buildToken; // The token of the world generation the chunk belongs to, which stops its mesh tasks
+    atomic<bool> retired; // Whether the world has let go of the chunk, which also stops its mesh tasks
+    shared_ptr<atomic<int>> buildsInFlight; // The number of mesh tasks of the chunk that have not been destroyed yet
+    // The node id and status of every selected or resident node, waiting for the subchunks to finish building
+    vector<pair<int, int>> pendingStatus;
+    vector<int> nodeStatus; // The status of each node in pendingStatus by node id, zero for the other nodes
+    bool hasPendingStatus; // Whether pendingStatus still needs to be applied
+    int outstandingBuilds; // The number of subchunks in pendingStatus that are still being built
+    mutable mutex texturesMutex; // Guards the terrain textures when they are copied or replaced
+    // The pool that the subchunks check their GPU buffers out from, a private pool that keeps nothing for reuse until
+    // the world gives the chunk its pool, which must happen before any subchunk is uploaded
+    shared_ptr<GpuBufferPool> bufferPool;
+    GLuint heightTextureID; // The heightmap texture used to displace the terrain on the GPU, zero until requested
+    // The normal of every heightmap value as signed x and z components, held until it is uploaded and empty when the
+    // normals are not baked
+    vector<int8_t> normalMapData;
+    GLuint normalTextureID; // The normal map texture that the terrain is lit from, zero until requested
+    GLuint biomeTextureID; // The biome map texture shared by every subchunk, zero until requested
+    shared_ptr<SubChunkCache> subChunkCache; // Decides how long the cached subchunks are kept, null to keep them all
+
+    void cacheSubChunk(int id, shared_ptr<SubChunk> subChunk);
+    shared_ptr<SubChunk> takeCachedSubChunk(int id);
+    void dropCachedSubChunk(int id);
+    void markResident(int id);
+    void bakeNormalMap();
 
 public:
     Chunk(
@@ -81,7 +162,10 @@ public:
     int getSubChunkSize() { return subChunkSize; }
     int getSubChunkResolution() { return subChunkResolution; }
     shared_ptr<Settings> getSettings() { return settings; }
-    void setHeightmapData(vector<vector<float>> inHeightmapData) { heightmapData = inHeightmapData; }
+    shared_ptr<ChunkQuadtree> getQuadtree() { return quadtree; }
+    shared_ptr<HeightPyramid> getHeightPyramid() { return heightPyramid; }
+    shared_ptr<SlabPool> getSubChunkPool() { return subChunkPool; }
+    void setHeightmapData(vector<vector<float>> inHeightmapData);
     void setBiomeData(vector<vector<uint8_t>> inBiomeData) { biomeData = inBiomeData; }
     void setChunkCoords(vector<int> inChunkCoords) { chunkCoords = inChunkCoords; }
     void setId(long inId) { id = inId; }
@@ -91,20 +175,54 @@ public:
     vector<float> getChunkWorldCoords();
     vector<float> getSubChunkWorldCoords(int id);
     vector<shared_ptr<SubChunk>> getLoadedSubChunks();
-    vector<shared_ptr<TextureArray>> getTerrainTextureArrays() { return terrainTextureArrays; }
-    vector<shared_ptr<Texture>> getTerrainTextures() { return terrainTextures; }
-    void setTerrainTextures(vector<shared_ptr<Texture>> inTerrainTextures) { terrainTextures = inTerrainTextures; }
-    void setTerrainTextureArrays(vector<shared_ptr<TextureArray>> inTerrainTextureArrays) { terrainTextureArrays = inTerrainTextureArrays; }
+    void appendLoadedSubChunks(vector<SubChunk *> &subChunks);
+    vector<shared_ptr<TextureArray>> getTerrainTextureArrays() { lock_guard<mutex> lock(texturesMutex); return terrainTextureArrays; }
+    vector<shared_ptr<Texture>> getTerrainTextures() { lock_guard<mutex> lock(texturesMutex); return terrainTextures; }
+    void setTerrainTextures(vector<shared_ptr<Texture>> inTerrainTextures) { lock_guard<mutex> lock(texturesMutex); terrainTextures = inTerrainTextures; }
+    void setTerrainTextureArrays(vector<shared_ptr<TextureArray>> inTerrainTextureArrays) { lock_guard<mutex> lock(texturesMutex); terrainTextureArrays = inTerrainTextureArrays; }
+    shared_ptr<WorkerPool> getMeshWorkers() { return meshWorkers; }
+    void setMeshWorkers(shared_ptr<WorkerPool> inMeshWorkers) { meshWorkers = inMeshWorkers; }
+    CancellationToken getBuildToken() { return buildToken; }
+    void setBuildToken(CancellationToken inBuildToken) { buildToken = inBuildToken; }
+    bool isRetired() { return retired.load(); }
+    void retire() { retired.store(true); }
+    bool hasBuildsInFlight() { return buildsInFlight->load() > 0; }
+    shared_ptr<GpuBufferPool> getBufferPool() { return bufferPool; }
+    void setBufferPool(shared_ptr<GpuBufferPool> inBufferPool) { bufferPool = inBufferPool; }
+    shared_ptr<SubChunkCache> getSubChunkCache() { return subChunkCache; }
+    void setSubChunkCache(shared_ptr<SubChunkCache> inSubChunkCache) { subChunkCache = inSubChunkCache; }
+    GLuint getHeightTexture();
+    GLuint getNormalTexture();
+    GLuint getBiomeTexture();
     const int* getSubbiomeTextureArrayMap() { return subbiomeTextureArrayMap; }
+    bool isPlaceholder() { return placeholder; }
+    void setPlaceholder(bool inPlaceholder) { placeholder = inPlaceholder; }
+    bool isFading() { return fading; }
+    bool isFadingOut() { return fadingOut; }
+    float getFade() { return fade; }
+
+    void startFade(bool out);
+    void updateFade(double time, float duration);
 
 
     int getSubChunkId(glm::vec3 position);
     void addSubChunk(int id, float resolution);
-    void updateLoadedSubChunks(glm::vec3 playerPos, Settings settings);
+    shared_ptr<SubChunk> buildSubChunk(int id, float resolution);
+    vector<shared_ptr<SubChunk>> buildSubChunks(const vector<pair<int, float>> &requests);
+    void requestSubChunkBuilds(const vector<pair<int, float>> &requests);
+    void collectBuiltSubChunks();
+    bool isSubChunkReady(int id, float resolution);
+    void applySubChunkStatus(const vector<pair<int, int>> &subChunksToLoad);
+    bool needsSubChunkUpdate(glm::vec3 playerPos, float fieldOfView, Settings &settings);
+    void updateMorphRange(int id, shared_ptr<SubChunk> subChunk);
+    void updateLoadedSubChunks(glm::vec3 playerPos, float fieldOfView, Settings &settings);
     void unloadSubChunk(int id);
     void deleteSubChunk(int id);
-    vector<int> checkRenderDistance(glm::vec3 playerPos, Settings settings);
+    void checkRenderDistance(glm::vec3 playerPos, float fieldOfView, Settings &settings);
+    const vector<pair<int, int>> &getPendingStatus() { return pendingStatus; }
     float getDistanceToChunk(glm::vec3 playerPos);
+    glm::vec2 getHeightBounds(int minX, int minZ, int maxX, int maxZ);
+    glm::vec2 getSubChunkHeightBounds(int id);
 
     // Testing function
     void loadAllSubChunks();
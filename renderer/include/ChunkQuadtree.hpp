@@ -0,0 +1,94 @@
+/**
+ * @file ChunkQuadtree.hpp
+ * @author King Attalus II
+ * @brief This file contains the ChunkQuadtree class, which is used to choose which parts of a chunk are drawn as large
+ * coarse patches and which are drawn as individual subchunks.
+ * @details The quadtree is built on top of the subchunk grid. The leaves are the subchunks and every node above them
+ * covers a square block of 2^level x 2^level subchunks that is drawn as a single patch with the same number of vertices
+ * as a subchunk, sampling the heightmap every 2^level vertices. Nodes are refined while their geometric error projected
+ * onto the screen is larger than a pixel threshold, so distant terrain is drawn with a handful of large patches and
+ * only the terrain close to the player is drawn with individual subchunks.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef CHUNKQUADTREE_HPP
+#define CHUNKQUADTREE_HPP
+
+#include <vector>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+using namespace std;
+
+/**
+ * @brief This structure identifies a node of the quadtree.
+ *
+ * @details The coordinates are those of the bottom left subchunk covered by the node, so a node at level L always has
+ * coordinates that are multiples of 2^L.
+ *
+ */
+struct QuadtreeNode
+{
+    int level; // The level of the node where 0 is a single subchunk
+    int x; // The column of the bottom left subchunk covered by the node
+    int z; // The row of the bottom left subchunk covered by the node
+};
+
+/**
+ * @brief This class stores the geometric error of every node of a chunk's quadtree and selects the nodes to draw.
+ *
+ * @details The geometric error of a node is the largest vertical distance between the heights of its children's
+ * vertices and the surface of the node's own coarser patch, accumulated up the tree so that it never decreases from a
+ * child to its parent. Nodes that only partially overlap the chunk are never drawn and are always refined, which keeps
+ * every patch inside the chunk's heightmap.
+ *
+ */
+class ChunkQuadtree
+{
+private:
+    int chunkSize; // The number of vertices per axis of the chunk (excluding the border)
+    int leafSize; // The number of world units covered by a subchunk
+    int leavesPerAxis; // The number of subchunks per axis of the chunk
+    int levelCount; // The number of levels in the tree including the subchunk level
+    vector<vector<float>> nodeErrors; // The geometric error of each node indexed by [level][z * nodesPerAxis + x]
+
+    float sampleHeight(const vector<vector<float>> &heightmap, int localX, int localZ) const;
+    void computeErrors(const vector<vector<float>> &heightmap, float heightScale);
+    void selectNode(
+        int level,
+        int nodeX,
+        int nodeZ,
+        glm::vec2 position,
+        float maxDistance,
+        float projectionScale,
+        float pixelError,
+        vector<QuadtreeNode> &selected
+    ) const;
+public:
+    ChunkQuadtree(const vector<vector<float>> &heightmap, int inChunkSize, int subChunkSize, float heightScale);
+    ~ChunkQuadtree() {};
+
+    int getLevelCount() const { return levelCount; }
+    int getLeavesPerAxis() const { return leavesPerAxis; }
+    int getNodesPerAxis(int level) const { return (leavesPerAxis + (1 << level) - 1) >> level; }
+    int getNodeCount() const { return levelCount * leavesPerAxis * leavesPerAxis; }
+    int getNodeSpan(int level) const { return leafSize << level; }
+
+    int getNodeKey(QuadtreeNode node) const;
+    QuadtreeNode getNodeFromKey(int key) const;
+    bool isInsideChunk(QuadtreeNode node) const;
+    float getNodeError(QuadtreeNode node) const;
+    float getDistanceToNode(QuadtreeNode node, glm::vec2 position) const;
+    float getRefineDistance(QuadtreeNode node, float projectionScale, float pixelError) const;
+    glm::vec2 getMorphRange(QuadtreeNode node, float projectionScale, float pixelError, float morphRatio) const;
+    vector<QuadtreeNode> selectNodes(glm::vec2 position, float maxDistance, float projectionScale, float pixelError) const;
+
+    static float getProjectionScale(float viewportHeight, float fieldOfView);
+};
+
+#endif // CHUNKQUADTREE_HPP
@@ -0,0 +1,117 @@
+/**
+ * @file GpuBufferPool.hpp
+ * @author King Attalus II
+ * @brief This file contains the GpuBufferPool class, which is used to recycle the vertex arrays and buffers of
+ * subchunks as they are streamed in and out.
+ * @details Subchunks are created and destroyed constantly as the player moves around the world. Allocating new GPU
+ * storage for every subchunk makes the driver do a lot of work in the middle of a frame, which shows up as stutters.
+ * The pool keeps the storage of released subchunks and hands it to the next subchunk with the same mesh size, which
+ * only has to overwrite the contents with glBufferSubData.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef GPUBUFFERPOOL_HPP
+#define GPUBUFFERPOOL_HPP
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glad/glad.h"
+#else
+    #include <glad/glad.h>
+#endif
+
+#include "Vertex.hpp"
+#include "TerrainVertex.hpp"
+
+using namespace std;
+
+/**
+ * @brief The attribute layouts that the vertex arrays of the pool can be set up with.
+ *
+ */
+enum class VertexLayout {
+    STANDARD, // The Vertex class with a full precision position, normal and texture coordinates
+    COMPACT_TERRAIN // The TerrainVertex class with grid indices, quantised heights and a packed normal
+};
+
+/**
+ * @brief This structure holds the vertex array and buffers of a single mesh along with the size of their storage.
+ *
+ */
+struct MeshBuffers {
+    GLuint VAO = 0; // The vertex array object
+    GLuint VBO = 0; // The vertex buffer object
+    GLuint EBO = 0; // The element buffer object owned by the mesh, zero when it uses a shared index buffer
+    size_t vertexBytes = 0; // The size of the vertex buffer storage in bytes
+    size_t indexBytes = 0; // The size of the element buffer storage in bytes
+    VertexLayout layout = VertexLayout::STANDARD; // The layout the attribute pointers are set up for
+};
+
+/**
+ * @brief This structure holds an index buffer that has been uploaded once for many meshes.
+ *
+ */
+struct SharedIndexBuffer {
+    shared_ptr<const vector<unsigned int>> indices; // The CPU copy, held so that its address stays unique
+    GLuint buffer = 0; // The element buffer
+    GLenum type = GL_UNSIGNED_INT; // The type of the indices in the element buffer
+};
+
+/**
+ * @brief This class owns the GPU storage of released meshes so that it can be reused.
+ *
+ * @details Meshes are pooled by their vertex layout and the size of their vertex and index storage, so the attribute
+ * pointers are only set when a vertex array is first created. The
+ * number of unused objects kept for each size is limited and anything released beyond the limit is deleted. The pool
+ * must only be used on the thread that owns the OpenGL context.
+ *
+ * Index buffers that are shared by many meshes are uploaded once and kept for the lifetime of the pool. Meshes that
+ * use them are checked out without an element buffer of their own. A shared index buffer is stored with 16 bit
+ * indices when every index fits, which halves its size for all but the finest meshes. Whole meshes that are shared, such as the flat
+ * grids that are displaced on the GPU, are kept in the same way and are never released.
+ *
+ */
+class GpuBufferPool
+{
+private:
+    map<tuple<VertexLayout, size_t, size_t>, vector<MeshBuffers>> freeMeshes; // The unused meshes keyed by layout and storage sizes
+    map<const vector<unsigned int>*, SharedIndexBuffer> sharedIndexBuffers; // The uploaded shared index buffers keyed by their CPU copy
+    // The uploaded shared meshes keyed by the CPU copy of their vertices, which is held for the same reason
+    map<const vector<Vertex>*, pair<shared_ptr<const vector<Vertex>>, MeshBuffers>> sharedMeshes;
+    int maxFreePerSize; // The number of unused objects of each size that are kept for reuse
+    int createdCount; // The number of meshes that have been allocated
+    int reusedCount; // The number of meshes that have been handed out from the pool
+
+    void uploadBuffers(const MeshBuffers &mesh, const void *vertexData, const void *indexData);
+
+public:
+    GpuBufferPool(int inMaxFreePerSize);
+    ~GpuBufferPool();
+
+    int getMaxFreePerSize() { return maxFreePerSize; }
+    void setMaxFreePerSize(int inMaxFreePerSize) { maxFreePerSize = inMaxFreePerSize; }
+    int getCreatedCount() { return createdCount; }
+    int getReusedCount() { return reusedCount; }
+    int getFreeMeshCount();
+    int getSharedIndexBufferCount() { return static_cast<int>(sharedIndexBuffers.size()); }
+
+    MeshBuffers acquireMesh(size_t vertexBytes, size_t indexBytes, VertexLayout layout = VertexLayout::STANDARD);
+    void uploadMesh(const MeshBuffers &mesh, const vector<Vertex> &vertices, const vector<unsigned int> &indices);
+    void uploadMesh(const MeshBuffers &mesh, const vector<TerrainVertex> &vertices);
+    void uploadMesh(const MeshBuffers &mesh, const vector<TerrainVertex> &vertices, const vector<uint16_t> &indices);
+    void uploadMesh(const MeshBuffers &mesh, const vector<TerrainVertex> &vertices, const vector<unsigned int> &indices);
+    void releaseMesh(const MeshBuffers &mesh);
+    GLuint getSharedIndexBuffer(shared_ptr<const vector<unsigned int>> indices);
+    GLenum getSharedIndexType(shared_ptr<const vector<unsigned int>> indices);
+    void attachIndexBuffer(const MeshBuffers &mesh, GLuint indexBuffer);
+    MeshBuffers getSharedMesh(shared_ptr<const vector<Vertex>> vertices, shared_ptr<const vector<unsigned int>> indices);
+};
+
+#endif // GPUBUFFERPOOL_HPP
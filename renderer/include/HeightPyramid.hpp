@@ -0,0 +1,72 @@
+/**
+ * @file HeightPyramid.hpp
+ * @author King Attalus II
+ * @brief This file contains the HeightPyramid class, which stores the lowest and highest heights of a heightmap at
+ * several scales so that the height bounds of any part of it can be found quickly.
+ * @details The heightmap is split into tiles of 8x8 values and the first level of the pyramid holds the bounds of each
+ * tile. Every level above it merges 2x2 tiles of the level below until a single tile covers the whole heightmap. A
+ * query walks down from the top and only visits the tiles along the edges of the requested rectangle, so the bounds of
+ * a subchunk cost a few dozen lookups instead of a pass over all of its heights.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef HEIGHTPYRAMID_HPP
+#define HEIGHTPYRAMID_HPP
+
+#include <vector>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+using namespace std;
+
+/**
+ * @brief This class holds the min/max pyramid of a heightmap and answers height bound queries over rectangles of it.
+ *
+ * @details Rectangles are given as inclusive ranges of heightmap indices, so x and z index heightmap[z][x], and are
+ * clamped to the heightmap. When the heightmap is passed to a query the tiles that are only partly covered are
+ * scanned, which makes the bounds exact. Without it the bounds of those tiles are used instead, which is conservative
+ * and within one tile of exact.
+ *
+ */
+class HeightPyramid
+{
+private:
+    int width; // The number of heights along x
+    int height; // The number of heights along z
+    vector<int> tilesPerAxisX; // The number of tiles along x at each level
+    vector<int> tilesPerAxisZ; // The number of tiles along z at each level
+    vector<vector<glm::vec2>> levels; // The lowest and highest height of each tile indexed by [level][z * tilesX + x]
+
+    void queryTile(
+        const vector<vector<float>> *heightmap,
+        int level,
+        int tileX,
+        int tileZ,
+        int minX,
+        int minZ,
+        int maxX,
+        int maxZ,
+        glm::vec2 &bounds
+    ) const;
+public:
+    static const int TILE_SIZE = 8; // The number of heights along each side of a tile of the first level
+
+    HeightPyramid(const vector<vector<float>> &heightmap);
+    ~HeightPyramid() {};
+
+    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    int getTilesPerAxisX(int level) const { return tilesPerAxisX[level]; }
+    int getTilesPerAxisZ(int level) const { return tilesPerAxisZ[level]; }
+    glm::vec2 getTileBounds(int level, int tileX, int tileZ) const;
+
+    glm::vec2 getBounds() const;
+    glm::vec2 getBounds(int minX, int minZ, int maxX, int maxZ) const;
+    glm::vec2 getBounds(const vector<vector<float>> &heightmap, int minX, int minZ, int maxX, int maxZ) const;
+};
+
+#endif // HEIGHTPYRAMID_HPP
@@ -0,0 +1,67 @@
+/**
+ * @file HeightUpsampler.hpp
+ * @author King Attalus II
+ * @brief This file contains the HeightUpsampler class, which is used to upsample a block of heights by an integer
+ * factor with bicubic interpolation.
+ * @details Meshes finer than the heightmap place a vertex every 1 / factor heightmap values, so the fraction of the way
+ * between two heights only takes factor different values. The Catmull-Rom weights for each of them are worked out
+ * once, and as the interpolation is separable the block is upsampled along each row and then down each column. Both
+ * passes are plain weighted sums over contiguous memory, which the compiler turns into SIMD instructions. The shipped
+ * subchunk size and resolutions get their own copies of the kernel with the loop bounds fixed at compile time.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef HEIGHTUPSAMPLER_HPP
+#define HEIGHTUPSAMPLER_HPP
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief This structure is a read only view of a block of heights stored row by row.
+ *
+ */
+struct HeightView {
+    const float *data; // The first height of the block
+    int width; // The number of heights along x
+    int height; // The number of heights along z
+    int stride; // The number of floats between the starts of consecutive rows
+
+    float at(int x, int z) const { return data[z * stride + x]; }
+};
+
+/**
+ * @brief This class contains the static functions that upsample blocks of heights with bicubic interpolation.
+ *
+ * @details The output of a block of width x height heights upsampled by a factor f has width * f x height * f heights,
+ * where output (i, j) is the bicubic interpolation at (i / f, j / f). The heights used by the interpolation are clamped
+ * to the edges of the block, which gives the same result as Utility::bicubic_interpolation.
+ *
+ */
+class HeightUpsampler
+{
+private:
+    // The constructor is private as we do not want to instantiate this class
+    inline HeightUpsampler(){};
+    inline ~HeightUpsampler(){};
+
+    template <int FIXED_SIZE, int FIXED_FACTOR>
+    static void upsampleBlock(const HeightView &heights, int factor, float *output, float *scratch);
+    static void computeFractionWeights(float t, float *weights);
+public:
+    // The number of heights per axis of a subchunk of 32 vertices with its border, which has kernels compiled for the
+    // factors 1, 2 and 4
+    static const int SPECIALISED_SIZE = 34;
+
+    static vector<float> computeWeights(int factor);
+    static void computeWeights(int factor, float *weights);
+    static size_t getScratchSize(int width, int height, int factor);
+    static vector<float> upsample(const HeightView &heights, int factor);
+    static void upsample(const HeightView &heights, int factor, float *output, float *scratch);
+    static float sample(const HeightView &heights, float x, float z);
+};
+
+#endif // HEIGHTUPSAMPLER_HPP
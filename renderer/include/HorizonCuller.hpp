@@ -0,0 +1,93 @@
+/**
+ * @file HorizonCuller.hpp
+ * @author King Attalus II
+ * @brief This file contains the HorizonCuller class, which is used to skip subchunks that are hidden behind the terrain
+ * in front of them.
+ * @details The subchunks are walked front to back from the camera while a horizon is kept for a ring of azimuth bins
+ * around it. The horizon of a bin is the steepest slope from the camera that the terrain already walked is known to
+ * rise above along every ray in the bin. A subchunk whose highest point stays below the horizon of every bin it
+ * touches cannot be seen and is not drawn. In mountainous terrain most subchunks behind a ridge are skipped this way.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef HORIZONCULLER_HPP
+#define HORIZONCULLER_HPP
+
+#include <vector>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+using namespace std;
+
+/**
+ * @brief This structure holds the world space footprint and height range of a subchunk.
+ *
+ * @details Only opaque terrain that is fully drawn may raise the horizon, so subchunks that are fading or belong to
+ * placeholder chunks are tested but are not occluders.
+ *
+ */
+struct HorizonBounds
+{
+    float minX; // The smallest world x covered by the subchunk
+    float minZ; // The smallest world z covered by the subchunk
+    float maxX; // The largest world x covered by the subchunk
+    float maxZ; // The largest world z covered by the subchunk
+    float minHeight; // The lowest point of the terrain surface
+    float maxHeight; // The highest point drawn by the subchunk, including its ocean
+    bool occluder; // Whether the subchunk may hide the subchunks behind it
+};
+
+/**
+ * @brief This class performs the horizon culling pass over a set of subchunk bounds.
+ *
+ * @details The test is conservative. A subchunk only raises the horizon of the bins that lie entirely inside its
+ * footprint, using its lowest height at its farthest distance, and only once every subchunk left to test is farther
+ * away than it. A subchunk is only culled when its highest height at its closest distance is below the horizon of
+ * every bin that it overlaps. The buffers of a pass are kept and reused by the next pass, so culling every frame does
+ * not allocate once they have grown to the number of subchunks.
+ *
+ */
+class HorizonCuller
+{
+private:
+    /**
+     * @brief A subchunk that has been drawn but is not yet in front of every subchunk left to test
+     */
+    struct PendingOccluder
+    {
+        float maxDistance; // The distance to the farthest corner of the subchunk
+        float slope; // The lowest slope of the terrain surface from the camera
+        float start; // The first bin coordinate covered by the subchunk
+        float end; // The last bin coordinate covered by the subchunk
+
+        bool operator>(const PendingOccluder &other) const { return maxDistance > other.maxDistance; }
+    };
+
+    int binCount; // The number of azimuth bins around the camera
+    vector<float> horizon; // The horizon slope of each bin
+    int culledCount; // The number of subchunks culled by the last pass
+    vector<bool> visible; // Whether each subchunk of the last pass is visible
+    vector<float> minDistances; // The distance to the closest point of each subchunk of the pass
+    vector<float> maxDistances; // The distance to the farthest corner of each subchunk of the pass
+    vector<size_t> order; // The subchunks of the pass from the closest to the farthest
+    vector<PendingOccluder> pending; // The pending occluders as a heap with the closest at the front
+
+    void getAngularSpan(const HorizonBounds &bounds, glm::vec2 viewPos, float &start, float &end) const;
+public:
+    static const int DEFAULT_BIN_COUNT = 1024;
+
+    HorizonCuller(int inBinCount = DEFAULT_BIN_COUNT);
+    ~HorizonCuller() {};
+
+    int getBinCount() const { return binCount; }
+    int getCulledCount() const { return culledCount; }
+
+    const vector<bool> &cull(const vector<HorizonBounds> &bounds, glm::vec3 viewPos);
+};
+
+#endif // HORIZONCULLER_HPP
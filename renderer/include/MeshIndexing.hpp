@@ -0,0 +1,45 @@
+/**
+ * @file MeshIndexing.hpp
+ * @author King Attalus II
+ * @brief This file contains the MeshIndexing class, which is used to generate grid index buffers in an order that
+ * makes good use of the post-transform vertex cache of the GPU.
+ * @details Emitting the quads of a grid one full row at a time means the vertices shared with the previous row have
+ * long been evicted from the vertex cache by the time they are used again, so nearly every vertex is transformed
+ * twice. Splitting the grid into vertical stripes that are narrow enough for two rows to fit in the cache lets every
+ * vertex be transformed close to once. As every subchunk is drawn in the reflection, refraction and main passes, the
+ * saving applies three times per frame.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef MESHINDEXING_HPP
+#define MESHINDEXING_HPP
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief This class contains the static functions that generate and measure grid index buffers.
+ *
+ * @details The grids are square with numberOfVerticesPerAxis vertices per axis and vertex (a, b) has the index
+ * a * numberOfVerticesPerAxis + b. Every quad is split along the same diagonal regardless of the order it is emitted
+ * in, so the triangles only change order and not shape.
+ *
+ */
+class MeshIndexing
+{
+private:
+    // The constructor is private as we do not want to instantiate this class
+    inline MeshIndexing(){};
+    inline ~MeshIndexing(){};
+public:
+    static const int DEFAULT_CACHE_SIZE = 32; // The vertex cache size that the index buffers are ordered for
+
+    static int getStripeWidth(int cacheSize);
+    static vector<unsigned int> generateRowOrderIndices(int numberOfVerticesPerAxis);
+    static vector<unsigned int> generateStripeOrderIndices(int numberOfVerticesPerAxis, int stripeWidth);
+    static float computeAcmr(const vector<unsigned int> &indices, int cacheSize);
+};
+
+#endif // MESHINDEXING_HPP
@@ -23,6 +23,7 @@
 #include "IRenderable.hpp"
 #include "Vertex.hpp"
 #include "Settings.hpp"
+#include "GpuBufferPool.hpp"
 #include "Shader.hpp"
 #include "WaterFrameBuffer.hpp"
 
@@ -37,31 +38,37 @@ class Ocean : public Object, public IRenderable{
 private:
     int size; // The size of the ocean chunk
     float seaLevel; // The sea level of the ocean as a fraction of the maximum height
-    shared_ptr<Settings> settings; // The settings for the renderer
+    // The shader, framebuffers, textures, settings and buffer pool are owned by the parent chunk, which outlives its
+    // ocean, so they are not shared by every ocean
+    Shader *shader; // The shader for the ocean
+    Settings *settings; // The settings for the renderer
     vector<float> oceanQuadOrigin; // The origin of the ocean quad in world space
     vector<Vertex> vertices; // The vertices of the ocean quad
     vector<unsigned int> indices; // The indices of the ocean quad
     vector<float> worldCoords; // The world coordinates of the ocean quad
-    shared_ptr<WaterFrameBuffer> reflectionBuffer; // The framebuffer that will be used for the reflection
-    shared_ptr<WaterFrameBuffer> refractionBuffer; // The framebuffer that will be used for the refraction
-    vector<shared_ptr<Texture>> oceanTextures; // The textures for the ocean object
+    WaterFrameBuffer *reflectionBuffer; // The framebuffer that will be used for the reflection
+    WaterFrameBuffer *refractionBuffer; // The framebuffer that will be used for the refraction
+    const vector<shared_ptr<Texture>> *oceanTextures; // The textures for the ocean object
 
     float waveSpeed; // The speed of the waves per second
     float currentTime; // The current time of the ocean
     float previousTime; // The previous time of the ocean
     float moveFactor;
+    GpuBufferPool *bufferPool; // The pool that the GPU buffers are checked out from
+    MeshBuffers meshBuffers; // The GPU buffers checked out for the ocean quad
 
 public:
     Ocean(
         vector<float> inOceanQuadOrigin,
         vector<float> inWorldCoords,
-        shared_ptr<Settings> inSettings,
-        shared_ptr<Shader> inShader,
-        shared_ptr<WaterFrameBuffer> inReflectionBuffer,
-        shared_ptr<WaterFrameBuffer> inRefractionBuffer,
-        vector<shared_ptr<Texture>> inOceanTextures
+        Settings *inSettings,
+        Shader *inShader,
+        WaterFrameBuffer *inReflectionBuffer,
+        WaterFrameBuffer *inRefractionBuffer,
+        const vector<shared_ptr<Texture>> *inOceanTextures,
+        float inScale = 1.0f
     );
-    ~Ocean(){};
+    ~Ocean();
 
     int getSize(){return size;}
     float getSeaLevel(){return seaLevel;}
@@ -74,6 +81,10 @@ public:
     void setOceanQuadOrigin(vector<float> inOceanQuadOrigin){oceanQuadOrigin = inOceanQuadOrigin;}
     void setVertices(vector<Vertex> inVertices){vertices = inVertices;}
     void setIndices(vector<unsigned int> inIndices){indices = inIndices;}
+    GpuBufferPool *getBufferPool(){return bufferPool;}
+    void setBufferPool(GpuBufferPool *inBufferPool){bufferPool = inBufferPool;}
+    size_t getGpuBytes(){return meshBuffers.vertexBytes + meshBuffers.indexBytes;}
+    void releaseData();
     void addVertex(Vertex inVertex){vertices.push_back(inVertex);}
     void addIndex(unsigned int inIndex){indices.push_back(inIndex);}
 
@@ -0,0 +1,61 @@
+/**
+ * @file PlaceholderTerrain.hpp
+ * @author King Attalus II
+ * @brief This file contains the PlaceholderTerrain class, which is used to produce an approximate heightmap for chunks
+ * that are still being generated by the server.
+ * @details The real terrain for a superchunk can take a long time to arrive when the server is busy. The placeholder
+ * generator uses seeded value noise shaped by the ocean and continent parameters to produce a coarse heightmap that
+ * can be rendered immediately and then cross-faded into the real terrain once it arrives.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef PLACEHOLDERTERRAIN_HPP
+#define PLACEHOLDERTERRAIN_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "Settings.hpp"
+#include "Parameters.hpp"
+
+using namespace std;
+
+/**
+ * @brief This class generates coarse approximate heightmaps and biome maps for any chunk coordinate.
+ *
+ * @details The noise is sampled on a lattice in world space, so neighbouring placeholder chunks line up exactly along
+ * their shared border. Only one noise sample is taken every sampleSpacing world units and the rest of the heightmap is
+ * bilinearly interpolated, which keeps generation fast enough to run as soon as a chunk is requested.
+ *
+ */
+class PlaceholderTerrain
+{
+private:
+    uint32_t seed; // The seed used to hash the noise lattice
+    int chunkSize; // The number of vertices per axis of a chunk (excluding the border)
+    int sampleSpacing; // The number of world units between noise samples
+    float seaLevel; // The sea level as a fraction of the maximum height
+    float oceanCoverage; // The fraction of the noise range that is placed below sea level
+    float continentScale; // The wavelength in world units of the lowest frequency octave
+    float landHeight; // The fraction of the height above sea level that the tallest land reaches
+    float persistence; // The amplitude falloff between octaves, higher values are more rugged
+    int octaves; // The number of octaves of value noise
+
+    float latticeValue(int x, int z, uint32_t octave) const;
+    float valueNoise(float x, float z, uint32_t octave) const;
+    float fractalNoise(float x, float z) const;
+public:
+    PlaceholderTerrain(long inSeed, shared_ptr<Settings> settings);
+    ~PlaceholderTerrain() {};
+
+    int getSampleSpacing() const {return sampleSpacing;}
+    void setSampleSpacing(int inSampleSpacing) {sampleSpacing = inSampleSpacing > 0 ? inSampleSpacing : 1;}
+
+    float sampleHeight(float worldX, float worldZ) const;
+    vector<vector<float>> generateHeightmap(int cx, int cz) const;
+    vector<vector<uint8_t>> generateBiomes(const vector<vector<float>> &heightmap) const;
+};
+
+#endif // PLACEHOLDERTERRAIN_HPP
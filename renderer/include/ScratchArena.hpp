@@ -0,0 +1,112 @@
+/**
+ * @file ScratchArena.hpp
+ * @author King Attalus II
+ * @brief This file contains the ScratchArena class, which hands out the temporary memory used while building subchunk
+ * meshes without going through the heap for every build.
+ * @details Each thread has its own arena made of a few large blocks. Memory is taken from the current block by moving a
+ * pointer along it, and everything taken within a scope is given back at once when the scope ends by moving the pointer
+ * back. The blocks are kept for the life of the thread, so once the first few builds have grown the arena to the size
+ * of a build no more memory is allocated. Only the final results of a build, which outlive it, are stored elsewhere.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef SCRATCHARENA_HPP
+#define SCRATCHARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+using namespace std;
+
+/**
+ * @brief This class is a bump allocator for the short lived memory of a single thread.
+ *
+ * @details Only trivially copyable types can be allocated as nothing is constructed or destroyed, and the memory is
+ * not initialised. Scopes must be closed in the reverse order to the one they were opened in, which the Scope guard
+ * does by itself.
+ *
+ */
+class ScratchArena
+{
+private:
+    static const size_t BLOCK_SIZE = 1 << 20; // The smallest number of bytes allocated for a block
+    static const size_t ALIGNMENT = 64; // The alignment of every allocation so that it starts on a cache line
+
+    /**
+     * @brief A block of memory that allocations are taken from
+     */
+    struct Block
+    {
+        unique_ptr<unsigned char[]> memory; // The memory of the block, over allocated to be aligned
+        unsigned char *start; // The first aligned byte of the block
+        size_t capacity; // The number of usable bytes from start
+    };
+
+    vector<Block> blocks; // The blocks of the arena, which are never freed while the arena exists
+    size_t currentBlock; // The block allocations are currently taken from
+    size_t used; // The number of bytes taken from the current block
+    size_t peakBytes; // The most bytes that have been in use at once
+
+    void *allocateBytes(size_t bytes);
+    size_t getUsedBytes() const;
+public:
+    /**
+     * @brief A position in the arena that allocations can be rewound to
+     */
+    struct Marker
+    {
+        size_t block; // The block that was current
+        size_t used; // The number of bytes that were taken from it
+    };
+
+    /**
+     * @brief This class gives back everything taken from an arena while it is alive when it is destroyed.
+     */
+    class Scope
+    {
+    private:
+        ScratchArena &arena; // The arena being rewound
+        Marker marker; // The position of the arena when the scope was opened
+    public:
+        Scope(ScratchArena &inArena) : arena(inArena), marker(inArena.getMarker()) {}
+        ~Scope() { arena.rewind(marker); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    ScratchArena();
+    ~ScratchArena() {};
+    ScratchArena(const ScratchArena &) = delete;
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    static ScratchArena &forThread();
+
+    /**
+     * @brief This function will take uninitialised memory for a number of values from the arena
+     *
+     * @tparam T The type of the values, which must be trivially copyable
+     *
+     * @param count [in] size_t The number of values
+     *
+     * @return T* The memory for the values, which stays valid until the enclosing scope is closed
+     *
+     */
+    template <typename T>
+    T *allocate(size_t count){
+        static_assert(is_trivially_copyable<T>::value, "Only trivially copyable types can be held in a scratch arena");
+        return static_cast<T *>(allocateBytes(count * sizeof(T)));
+    }
+
+    Marker getMarker() const { return Marker{currentBlock, used}; }
+    void rewind(Marker marker);
+    void reset();
+
+    size_t getCapacity() const;
+    size_t getPeakBytes() const { return peakBytes; }
+    int getBlockCount() const { return static_cast<int>(blocks.size()); }
+};
+
+#endif // SCRATCHARENA_HPP
@@ -57,6 +57,25 @@ private:
 
     bool use1kTextures; // Whether to use 1k textures or not
 
+    /*Streaming settings*/
+    bool placeholderTerrain = true; // Whether to render approximate terrain while chunks are being generated
+    float chunkFadeDuration = 1.0f; // The time in seconds to cross-fade from placeholder to generated terrain
+    int meshBuildThreads = 2; // The number of threads that build subchunk meshes, 0 builds them on the main thread
+    int bufferPoolLimit = 64; // The number of unused GPU buffers and textures of each size kept for reuse
+    int gpuCacheBudget = 256; // The megabytes of GPU memory kept for subchunks that are cached but not drawn
+    int cpuCacheBudget = 512; // The megabytes of CPU memory kept for cached subchunks whose GPU buffers were freed
+
+    /*Level of detail settings*/
+    float lodMorphRatio = 0.3f; // The fraction of each LOD band over which vertices morph to the next coarser level
+    float lodSkirtDepth = 1.0f; // The extra depth of the subchunk skirts below the lowest edge vertex
+    float lodPixelError = 2.0f; // The largest terrain error in pixels before a quadtree patch is refined
+    bool gpuHeightDisplacement = false; // Whether subchunks draw a shared flat grid displaced by the chunk height texture
+    bool horizonCulling = true; // Whether subchunks hidden behind the terrain in front of them are skipped
+    float adaptiveMeshError = 0.0f; // The largest height error of the adaptively triangulated subchunk meshes, 0 draws full grids
+    bool hardwareTessellation = false; // Whether the terrain is refined by tessellation shaders when OpenGL 4.0 is available
+    float tessellationEdgePixels = 8.0f; // The screen length in pixels that the tessellated terrain edges are refined to
+    bool bakedNormalMaps = true; // Whether the terrain is lit from a normal map baked per chunk rather than its vertex normals
+
 public:
     Settings(
         int inWindowWidth,
@@ -150,10 +169,41 @@ public:
 
     bool getUse1kTextures() { return use1kTextures; }
 
+    bool getPlaceholderTerrain() { return placeholderTerrain; }
+    float getChunkFadeDuration() { return chunkFadeDuration; }
+    int getMeshBuildThreads() { return meshBuildThreads; }
+    int getBufferPoolLimit() { return bufferPoolLimit; }
+    int getGpuCacheBudget() { return gpuCacheBudget; }
+    int getCpuCacheBudget() { return cpuCacheBudget; }
+    float getLodMorphRatio() { return lodMorphRatio; }
+    float getLodSkirtDepth() { return lodSkirtDepth; }
+    float getLodPixelError() { return lodPixelError; }
+    bool getGpuHeightDisplacement() { return gpuHeightDisplacement; }
+    bool getHorizonCulling() { return horizonCulling; }
+    float getAdaptiveMeshError() { return adaptiveMeshError; }
+    bool getHardwareTessellation() { return hardwareTessellation; }
+    float getTessellationEdgePixels() { return tessellationEdgePixels; }
+    bool getBakedNormalMaps() { return bakedNormalMaps; }
+
     void setUIWidth(int inUIWidth) { UIWidth = inUIWidth; }
     void setCurrentPage(UIPage inCurrentPage) { currentPage = inCurrentPage; }
     void setParameters(shared_ptr<Parameters> inParameters) { parameters = inParameters; }
     void setCurrentWorld(string inCurrentWorld) { currentWorld = inCurrentWorld; }
+    void setPlaceholderTerrain(bool inPlaceholderTerrain) { placeholderTerrain = inPlaceholderTerrain; }
+    void setChunkFadeDuration(float inChunkFadeDuration) { chunkFadeDuration = inChunkFadeDuration; }
+    void setMeshBuildThreads(int inMeshBuildThreads) { meshBuildThreads = inMeshBuildThreads; }
+    void setBufferPoolLimit(int inBufferPoolLimit) { bufferPoolLimit = inBufferPoolLimit; }
+    void setGpuCacheBudget(int inGpuCacheBudget) { gpuCacheBudget = inGpuCacheBudget; }
+    void setCpuCacheBudget(int inCpuCacheBudget) { cpuCacheBudget = inCpuCacheBudget; }
+    void setLodMorphRatio(float inLodMorphRatio) { lodMorphRatio = inLodMorphRatio; }
+    void setLodSkirtDepth(float inLodSkirtDepth) { lodSkirtDepth = inLodSkirtDepth; }
+    void setLodPixelError(float inLodPixelError) { lodPixelError = inLodPixelError; }
+    void setGpuHeightDisplacement(bool inGpuHeightDisplacement) { gpuHeightDisplacement = inGpuHeightDisplacement; }
+    void setHorizonCulling(bool inHorizonCulling) { horizonCulling = inHorizonCulling; }
+    void setAdaptiveMeshError(float inAdaptiveMeshError) { adaptiveMeshError = inAdaptiveMeshError; }
+    void setHardwareTessellation(bool inHardwareTessellation) { hardwareTessellation = inHardwareTessellation; }
+    void setTessellationEdgePixels(float inTessellationEdgePixels) { tessellationEdgePixels = inTessellationEdgePixels; }
+    void setBakedNormalMaps(bool inBakedNormalMaps) { bakedNormalMaps = inBakedNormalMaps; }
 
     void updateSettings(
         int inWindowWidth,
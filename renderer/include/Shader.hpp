@@ -42,6 +42,8 @@ private:
     string vertexPath;
     string fragmentPath;
     optional<string> geometryPath;
+    optional<string> tessControlPath;
+    optional<string> tessEvaluationPath;
 
     void checkCompileErrors(GLuint shader, string type, string shaderName);
 
@@ -54,7 +56,11 @@ private:
         const char* fragmentCode,
         string fragmentName,
         optional<const char*> geometryCode,
-        optional<string> geometryName
+        optional<string> geometryName,
+        optional<const char*> tessControlCode = nullopt,
+        optional<string> tessControlName = nullopt,
+        optional<const char*> tessEvaluationCode = nullopt,
+        optional<string> tessEvaluationName = nullopt
     );
 
 public:
@@ -62,6 +68,12 @@ public:
     Shader(const char* vertexPath, const char* fragmentPath);
     Shader(const string vertexPath, const string fragmentPath, const string geometryPath);
     Shader(const string vertexPath, const string fragmentPath);
+    Shader(
+        const string vertexPath,
+        const string tessControlPath,
+        const string tessEvaluationPath,
+        const string fragmentPath
+    );
     Shader(){}; // Default constructor
     ~Shader();
 
@@ -73,6 +85,8 @@ public:
     string getVertexPath(){return vertexPath;}
     string getFragmentPath(){return fragmentPath;}
     optional<string> getGeometryPath(){return geometryPath;}
+    optional<string> getTessControlPath(){return tessControlPath;}
+    optional<string> getTessEvaluationPath(){return tessEvaluationPath;}
     void setId(unsigned int id){this->id = id;}
     void setVertex(unsigned int vertex){this->vertex = vertex;}
     void setFragment(unsigned int fragment){this->fragment = fragment;}
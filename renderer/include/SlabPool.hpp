@@ -0,0 +1,124 @@
+/**
+ * @file SlabPool.hpp
+ * @author King Attalus II
+ * @brief This file contains the SlabPool class, which hands out fixed size slots of memory from large contiguous slabs,
+ * and the SlabAllocator that lets shared pointers be allocated from it.
+ * @details Every subchunk used to be a separate heap allocation, as were its terrain and ocean, so the subchunks of a
+ * chunk ended up scattered around the heap. A chunk instead keeps a pool whose slabs each hold many subchunks side by
+ * side, so walking the subchunks for rendering and level of detail touches neighbouring memory. Released slots are
+ * handed out again before a new slab is allocated, so streaming subchunks in and out does not go back to the heap.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef SLABPOOL_HPP
+#define SLABPOOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief This class hands out slots of a fixed size from slabs that are kept for the life of the pool.
+ *
+ * @details Nothing is constructed or destroyed by the pool, it only manages the memory. The pool is guarded by a mutex
+ * so that slots can be taken by the mesh workers while the main thread gives others back.
+ *
+ */
+class SlabPool
+{
+private:
+    static const size_t ALIGNMENT = 64; // The alignment of every slot so that it starts on a cache line
+
+    size_t slotSize; // The number of bytes in each slot, rounded up to ALIGNMENT
+    int slotsPerSlab; // The number of slots allocated together in each slab
+    vector<unique_ptr<unsigned char[]>> slabs; // The slabs of the pool, which are never freed while the pool exists
+    vector<void *> freeSlots; // The slots that are not in use, the lowest address is at the back
+    int usedCount; // The number of slots that are in use
+    mutable mutex poolMutex; // Guards the slabs and the free slots
+
+    void addSlab();
+public:
+    SlabPool(size_t inSlotSize, int inSlotsPerSlab);
+    ~SlabPool() {};
+    SlabPool(const SlabPool &) = delete;
+    SlabPool &operator=(const SlabPool &) = delete;
+
+    void *allocate();
+    void deallocate(void *slot);
+    bool fits(size_t bytes, size_t alignment) const { return bytes <= slotSize && alignment <= ALIGNMENT; }
+
+    size_t getSlotSize() const { return slotSize; }
+    int getSlotsPerSlab() const { return slotsPerSlab; }
+    int getSlabCount() const;
+    int getFreeCount() const;
+    int getUsedCount() const;
+};
+
+/**
+ * @brief This class is a standard allocator that takes single objects from a slab pool.
+ *
+ * @details It is meant for allocate_shared, which places the object and its reference counts in a single slot. Any
+ * allocation that does not fit in a slot falls back to the heap. Every copy holds the pool, so the pool lives until
+ * the last object taken from it has been freed.
+ *
+ * @tparam T The type of the objects that are allocated
+ *
+ */
+template <typename T>
+class SlabAllocator
+{
+private:
+    shared_ptr<SlabPool> pool; // The pool that the objects are taken from
+public:
+    using value_type = T;
+
+    SlabAllocator(shared_ptr<SlabPool> inPool) : pool(inPool) {}
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U> &other) : pool(other.getPool()) {}
+
+    shared_ptr<SlabPool> getPool() const { return pool; }
+
+    /**
+     * @brief This function will allocate uninitialised memory for a number of objects
+     *
+     * @param count [in] size_t The number of objects
+     *
+     * @return T* The memory for the objects
+     *
+     */
+    T *allocate(size_t count){
+        if (count == 1 && pool->fits(sizeof(T), alignof(T))){
+            return static_cast<T *>(pool->allocate());
+        }
+        return static_cast<T *>(::operator new(count * sizeof(T)));
+    }
+
+    /**
+     * @brief This function will free memory allocated for a number of objects
+     *
+     * @param pointer [in] T* The memory returned by allocate
+     * @param count [in] size_t The number of objects it was allocated for
+     *
+     * @return void
+     *
+     */
+    void deallocate(T *pointer, size_t count){
+        if (count == 1 && pool->fits(sizeof(T), alignof(T))){
+            pool->deallocate(pointer);
+            return;
+        }
+        ::operator delete(pointer);
+    }
+
+    template <typename U>
+    bool operator==(const SlabAllocator<U> &other) const { return pool == other.getPool(); }
+    template <typename U>
+    bool operator!=(const SlabAllocator<U> &other) const { return pool != other.getPool(); }
+};
+
+#endif // SLABPOOL_HPP
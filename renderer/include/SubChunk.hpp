@@ -28,6 +28,7 @@
 #include "Texture.hpp"
 #include "Light.hpp"
 #include "WaterFrameBuffer.hpp"
+#include "HorizonCuller.hpp"
 
 
 using namespace std;
@@ -49,62 +50,101 @@ private:
     int id; // Unique identifier for the subchunk within the chunk
     int size; // The size of the subchunk
     float resolution; // The resolution of the subchunk where 1 is the same resolution as the heightmap
-    shared_ptr<Chunk> parentChunk; // The parent chunk of the subchunk
+    // The parent chunk of the subchunk, which is not owned as the chunk owns its subchunks and outlives them
+    Chunk *parentChunk;
     vector<int> subChunkCoords; // The subchunks coordinates within the chunk space
-    vector<vector<float>> heights; // The heightmap data for the subchunk
-    vector<vector<uint8_t>> biomes; // The biome data for the subchunk
-    shared_ptr<Terrain> terrain; // The terrain object for the subchunk
-    shared_ptr<Shader> terrainShader; // The shader for the terrain object
-    shared_ptr<Ocean> ocean; // The ocean object for the subchunk
-    shared_ptr<Shader> oceanShader; // The shader for the ocean object
-    vector<shared_ptr<Texture>> terrainTextures; // The textures for the terrain object
-    shared_ptr<WaterFrameBuffer> reflectionBuffer; // The framebuffer that will be used for the reflection
-    shared_ptr<WaterFrameBuffer> refractionBuffer; // The framebuffer that will be used for the refraction
-    vector<shared_ptr<Texture>> oceanTextures; // The textures for the ocean object
+    vector<float> heights; // The heightmap data for the subchunk including the border stored row by row
+    bool fadingOut = false; // Whether the subchunk belongs to a placeholder chunk that is being replaced
+    float spacing = 1.0f; // The number of world units between the heightmap values of the subchunk
+    float minHeight = 0.0f; // The lowest world height of the heightmap data of the subchunk
+    float maxHeight = 0.0f; // The highest world height of the heightmap data of the subchunk
+    bool occluded = false; // Whether the subchunk was hidden behind the horizon in the last culling pass
+    HorizonBounds horizonBounds = HorizonBounds(); // The bounds used by the horizon culling pass, fixed once built
+    // The terrain and ocean are held in the subchunk itself so that the three share one allocation, they are built
+    // last as they are made from the members above
+    Terrain terrain; // The terrain object for the subchunk
+    Ocean ocean; // The ocean object for the subchunk
+
+    void computeHeightRange();
+    HeightView getHeightView();
+    void computeHorizonBounds(Settings *settings);
+    static vector<int> getMorphOffset(int size, float resolution, const vector<int> &subChunkCoords, float spacing);
 
 public:
     SubChunk(
         int inId,
-        shared_ptr<Chunk> inParentChunk,
-        shared_ptr<Settings> settings,
+        Chunk *inParentChunk,
+        Settings *settings,
         vector<int> inSubChunkCoords,
-        vector<vector<float>> inHeights,
-        vector<vector<uint8_t>> inBiomes,
-        shared_ptr<Shader> inTerrainShader,
-        shared_ptr<Shader> inOceanShader,
-        vector<shared_ptr<Texture>> inTerrainTextures,
-        shared_ptr<WaterFrameBuffer> inReflectionBuffer,
-        shared_ptr<WaterFrameBuffer> inRefractionBuffer,
-        vector<shared_ptr<Texture>> inOceanTextures
+        vector<float> inHeights,
+        Shader *inTerrainShader,
+        Shader *inOceanShader,
+        const vector<shared_ptr<Texture>> *inTerrainTextures,
+        const vector<shared_ptr<TextureArray>> *inTerrainTextureArrays,
+        WaterFrameBuffer *inReflectionBuffer,
+        WaterFrameBuffer *inRefractionBuffer,
+        const vector<shared_ptr<Texture>> *inOceanTextures
     );
     SubChunk(
         int inId,
-        shared_ptr<Chunk> inParentChunk,
-        shared_ptr<Settings> settings,
+        Chunk *inParentChunk,
+        Settings *settings,
         float inResolution,
         vector<int> inSubChunkCoords,
-        vector<vector<float>> inHeights,
-        vector<vector<uint8_t>> inBiomes,
-        shared_ptr<Shader> inTerrainShader,
-        shared_ptr<Shader> inOceanShader,
-        vector<shared_ptr<Texture>> inTerrainTextures,
-        shared_ptr<WaterFrameBuffer> inReflectionBuffer,
-        shared_ptr<WaterFrameBuffer> inRefractionBuffer,
-        vector<shared_ptr<Texture>> inOceanTextures
+        vector<float> inHeights,
+        Shader *inTerrainShader,
+        Shader *inOceanShader,
+        const vector<shared_ptr<Texture>> *inTerrainTextures,
+        const vector<shared_ptr<TextureArray>> *inTerrainTextureArrays,
+        WaterFrameBuffer *inReflectionBuffer,
+        WaterFrameBuffer *inRefractionBuffer,
+        const vector<shared_ptr<Texture>> *inOceanTextures,
+        float inSpacing = 1.0f
     );
     ~SubChunk();
+    SubChunk(const SubChunk &) = delete;
+    SubChunk &operator=(const SubChunk &) = delete;
 
     int getId() { return id; }
     vector<int> getSubChunkCoords() { return subChunkCoords; }
-    vector<vector<float>> getHeights() { return heights; }
-    vector<vector<uint8_t>> getBiomes() { return biomes; }
+    const vector<float> &getHeights() { return heights; }
     float getResolution() { return resolution; }
-    shared_ptr<Chunk> getParentChunk() { return parentChunk; }
+    float getSpacing() { return spacing; }
+    float getMinHeight() { return minHeight; }
+    float getMaxHeight() { return maxHeight; }
+    bool isOccluded() { return occluded; }
+    void setOccluded(bool inOccluded) { occluded = inOccluded; }
+    Chunk *getParentChunk() { return parentChunk; }
     void setSubChunkCoords(vector<int> inSubChunkCoords) { subChunkCoords = inSubChunkCoords; }
     void setId(int inId) { id = inId; }
 
-    vector<float> getSubChunkWorldCoords(shared_ptr<Settings> settings);
+    vector<float> getSubChunkWorldCoords(Settings *settings);
+    void setFade(float fade, bool fadeOut);
+    void setMorphRange(glm::vec2 morphRange);
+    const HorizonBounds &getHorizonBounds() const { return horizonBounds; }
+    bool isUploaded() { return terrain.isUploaded(); }
+    size_t getGpuBytes();
+    size_t getCpuBytes();
+    void releaseGpuData();
 
+    void renderTerrain(
+        glm::mat4 view,
+        glm::mat4 projection,
+        vector<shared_ptr<Light>> lights,
+        glm::vec3 viewPos,
+        bool isWaterPass,
+        bool isShadowPass,
+        glm::vec4 plane
+    );
+    void renderOcean(
+        glm::mat4 view,
+        glm::mat4 projection,
+        vector<shared_ptr<Light>> lights,
+        glm::vec3 viewPos,
+        bool isWaterPass,
+        bool isShadowPass,
+        glm::vec4 plane
+    );
     void render(
         glm::mat4 view,
         glm::mat4 projection,
@@ -0,0 +1,113 @@
+/**
+ * @file SubChunkCache.hpp
+ * @author King Attalus II
+ * @brief This file contains the SubChunkCache class, which decides how long the subchunks that are no longer drawn are
+ * kept and in what form.
+ * @details A subchunk that leaves the set being drawn first stays in the GPU tier with its buffers still uploaded, so
+ * it can be drawn again straight away. When the GPU tier is over its byte budget the least recently used subchunks are
+ * demoted to the CPU tier, which frees their GPU buffers and keeps only the packed mesh, so bringing them back is a
+ * single upload. When the CPU tier is over its byte budget the least recently used subchunks are evicted and have to
+ * be rebuilt from the heightmap of their chunk. The budgets are shared by every chunk in the world.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef SUBCHUNKCACHE_HPP
+#define SUBCHUNKCACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief This enum identifies the tier a cached subchunk is held in.
+ *
+ */
+enum class CacheTier {
+    GPU, // The GPU buffers are uploaded and the subchunk can be drawn immediately
+    CPU // Only the packed mesh is kept and it has to be uploaded before it is drawn
+};
+
+/**
+ * @brief This class tracks the cached subchunks of every chunk, enforces the tier budgets and counts the cache hits.
+ *
+ * @details The subchunks themselves stay owned by their chunk. Each entry holds the callbacks that demote or evict it,
+ * which the cache calls when a budget is exceeded and then forgets or moves the entry. The callbacks must not call
+ * back into the cache. The entries are guarded by a mutex so that a chunk destroyed on another thread can still
+ * remove its own entries, but the subchunks are only inserted, taken and evicted on the main thread as demoting a
+ * subchunk releases GPU buffers.
+ *
+ */
+class SubChunkCache
+{
+private:
+    /**
+     * @brief A subchunk held by the cache
+     */
+    struct Entry
+    {
+        const void *owner; // The chunk that owns the subchunk
+        int id; // The id of the subchunk within the chunk
+        CacheTier tier; // The tier the subchunk is held in
+        size_t gpuBytes; // The GPU memory used by the subchunk while it is in the GPU tier
+        size_t cpuBytes; // The CPU memory used by the packed mesh of the subchunk
+        function<void()> demote; // Frees the GPU buffers of the subchunk
+        function<void()> evict; // Destroys the subchunk
+    };
+
+    list<Entry> entries; // The entries from the most to the least recently used
+    map<pair<const void *, int>, list<Entry>::iterator> lookup; // Finds the entry of a subchunk
+    size_t gpuBudget; // The most GPU memory the GPU tier may use in bytes
+    size_t cpuBudget; // The most CPU memory the CPU tier may use in bytes
+    size_t gpuTierBytes; // The GPU memory used by the GPU tier in bytes
+    size_t cpuTierBytes; // The CPU memory used by the CPU tier in bytes
+    long gpuHits; // The number of subchunks taken back from the GPU tier
+    long cpuHits; // The number of subchunks taken back from the CPU tier
+    long misses; // The number of subchunks that had to be built
+    long demotions; // The number of subchunks demoted from the GPU tier to the CPU tier
+    long evictions; // The number of subchunks evicted from the CPU tier
+    mutable mutex cacheMutex; // Guards the entries, the tier sizes and the counters
+
+    void enforceBudgets();
+    void erase(list<Entry>::iterator entry);
+public:
+    SubChunkCache(size_t inGpuBudget, size_t inCpuBudget);
+    ~SubChunkCache() {};
+
+    void insert(
+        const void *owner,
+        int id,
+        size_t gpuBytes,
+        size_t cpuBytes,
+        function<void()> demote,
+        function<void()> evict
+    );
+    bool contains(const void *owner, int id) const;
+    CacheTier getTier(const void *owner, int id) const;
+    void take(const void *owner, int id);
+    void remove(const void *owner, int id);
+    void removeOwner(const void *owner);
+    void retainOwners(const vector<const void *> &owners);
+    void clear();
+    void recordMiss();
+
+    size_t getGpuBudget() const { return gpuBudget; }
+    size_t getCpuBudget() const { return cpuBudget; }
+    size_t getGpuTierBytes() const { lock_guard<mutex> lock(cacheMutex); return gpuTierBytes; }
+    size_t getCpuTierBytes() const { lock_guard<mutex> lock(cacheMutex); return cpuTierBytes; }
+    int getEntryCount() const { lock_guard<mutex> lock(cacheMutex); return static_cast<int>(entries.size()); }
+    long getGpuHits() const { lock_guard<mutex> lock(cacheMutex); return gpuHits; }
+    long getCpuHits() const { lock_guard<mutex> lock(cacheMutex); return cpuHits; }
+    long getMisses() const { lock_guard<mutex> lock(cacheMutex); return misses; }
+    long getDemotions() const { lock_guard<mutex> lock(cacheMutex); return demotions; }
+    long getEvictions() const { lock_guard<mutex> lock(cacheMutex); return evictions; }
+    float getHitRate() const;
+};
+
+#endif // SUBCHUNKCACHE_HPP
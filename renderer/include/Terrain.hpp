@@ -30,6 +30,10 @@
 #include "Vertex.hpp"
 #include "Settings.hpp"
 #include "TextureArray.hpp"
+#include "GpuBufferPool.hpp"
+#include "TerrainVertex.hpp"
+#include "ScratchArena.hpp"
+#include "HeightUpsampler.hpp"
 
 using namespace std;
 
@@ -44,53 +48,95 @@ using namespace std;
  */
 class Terrain : public Object, public IRenderable{
 private:
-    vector<Vertex> vertices; // The vertices of the terrain
-    vector<unsigned int> indices; // The indices of the terrain
-    shared_ptr<vector<vector<uint8_t>>> biomes; // The biomes of the subchunk
+    vector<TerrainVertex> compactVertices; // The vertices of the terrain in the compact layout that is uploaded
+    glm::vec2 heightRange; // The lowest height and the size of the height range the compact vertices are quantised over
+    GLenum indexType; // The type of the indices in the shared element buffer
+    shared_ptr<const vector<unsigned int>> indices; // The indices of the terrain, shared with every terrain of the same size
+    bool adaptiveIndices; // Whether the indices are an adaptive triangulation owned by this terrain rather than shared
     float resolution; // The resolution of the terrain
     int size;  // The number of vertices per axis in the heightmap data
     vector<float> worldCoords; // The world coordinates of origin of the terrain subchunk
-    GLuint biomeTextureID; // The texture ID of the biome map texture
-    vector<shared_ptr<Texture>> textures; // The textures for the terrain
-    vector<shared_ptr<TextureArray>> textureArrays; // The texture arrays for the terrain
-    shared_ptr<Settings> settings; // The settings for the terrain
+    glm::vec2 biomeMapOrigin; // The texel of the biome map of the parent chunk under the origin of the terrain
+    // The shader, textures, settings and buffer pool are owned by the parent chunk, which outlives its terrain, so they
+    // are not shared by every terrain
+    Shader *shader; // The shader for the terrain
+    const vector<shared_ptr<Texture>> *textures; // The textures for the terrain
+    const vector<shared_ptr<TextureArray>> *textureArrays; // The texture arrays for the terrain
+    Settings *settings; // The settings for the terrain
     const int* subbiomeTextureArrayMap; // The texture array map for the subbiomes
+    float fade; // The visible fraction of the terrain while it is cross-fading
+    bool fadeOut; // Whether the terrain is fading out rather than in
+    glm::vec2 morphRange; // The camera distances over which the terrain morphs to the next level of detail
+    float spacing; // The number of world units between the heightmap values of the terrain
+    vector<int> morphOffset; // The parity offset of the next coarser grid along the x and z axes
+    GpuBufferPool *bufferPool; // The pool that the GPU buffers are checked out from
+    MeshBuffers meshBuffers; // The GPU buffers checked out for the terrain mesh
+    // The flat grid shared by every terrain of the same size when the heights are displaced on the GPU, null when the
+    // heights are baked into the vertices
+    shared_ptr<const vector<Vertex>> gridVertices;
+    float skirtHeight; // The height of the bottom of the skirts when the heights are displaced on the GPU
+    bool tessellated; // Whether the flat grid is drawn as patches that the tessellation shaders refine
+    glm::vec2 heightMapOrigin; // The texel of the heightmap texture of the parent chunk under the first vertex of the grid
+    bool normalMapped; // Whether the terrain is lit from the baked normal map of the parent chunk rather than the vertex normals
+    glm::vec2 normalMapOrigin; // The texel of the normal map texture under the origin of the terrain
 
-    glm::vec3 computeNormalContribution(glm::vec3 A, glm::vec3 B, glm::vec3 C);
-    void createMesh(vector<vector<float>> inHeights, float heightScalingFactor);
-    vector<vector<glm::vec3>> generateRenderVertices(vector<vector<float>> inHeights, float heightScalingFactor);
-    vector<unsigned int> generateIndexBuffer(int numberOfVerticesPerAxis);
-    vector<vector<glm::vec3>> generateNormals(vector<vector<glm::vec3>> inVertices, vector<unsigned int> indicies);
-    vector<vector<vector<glm::vec3>>> cropBorderVerticesAndNormals(
-        vector<vector<glm::vec3>> inVertices,
-        vector<vector<glm::vec3>> inNormals
+    void createMesh(const HeightView &inHeights, float heightScalingFactor);
+    void createDisplacedMesh(const HeightView &inHeights, float heightScalingFactor);
+    float *generateRenderHeights(const HeightView &inHeights, float heightScalingFactor, ScratchArena &arena);
+    void buildCompactVertices(const float *renderHeights);
+    static vector<unsigned int> generateIndexBuffer(int numberOfVerticesPerAxis);
+    static vector<unsigned int> generateSkirtIndices(int numberOfVerticesPerAxis);
+    static shared_ptr<const vector<unsigned int>> generateAdaptiveIndices(
+        const float *inHeights,
+        int numberOfVerticesPerAxis,
+        float maxError
     );
-    vector<glm::vec3> flatten2DVector(vector<vector<glm::vec3>> inVector);
     glm::mat4 generateTransformMatrix();
 public:
     Terrain(
-        vector<vector<float>> inHeights,
-        shared_ptr<vector<vector<uint8_t>>> inBiomes,
-        shared_ptr<Settings> inSettings,
+        const HeightView &inHeights,
+        Settings *inSettings,
         vector<float> inWorldCoords,
-        shared_ptr<Shader> inShader,
-        vector<shared_ptr<Texture>> inTextures,
-        vector<shared_ptr<TextureArray>> inTextureArrays,
+        Shader *inShader,
+        const vector<shared_ptr<Texture>> *inTextures,
+        const vector<shared_ptr<TextureArray>> *inTextureArrays,
         const int* subbiomeTextureArrayMap
     );
     Terrain(
-        vector<vector<float>> inHeights,
-        shared_ptr<vector<vector<uint8_t>>> inBiomes,
+        const HeightView &inHeights,
         float inResolution,
-        shared_ptr<Settings> inSettings,
+        Settings *inSettings,
         vector<float> inWorldCoords,
-        shared_ptr<Shader> inShader,
-        vector<shared_ptr<Texture>> inTextures,
-        vector<shared_ptr<TextureArray>> inTextureArrays,
-        const int* subbiomeTextureArrayMap
+        Shader *inShader,
+        const vector<shared_ptr<Texture>> *inTextures,
+        const vector<shared_ptr<TextureArray>> *inTextureArrays,
+        const int* subbiomeTextureArrayMap,
+        float inSpacing = 1.0f,
+        vector<int> inMorphOffset = vector<int>{0, 0}
     );
     ~Terrain();
 
+    static shared_ptr<const vector<unsigned int>> getSharedIndexBuffer(int numberOfVerticesPerAxis, bool withSkirts);
+    static shared_ptr<const vector<Vertex>> getSharedFlatGrid(int numberOfVerticesPerAxis, float resolution);
+    static int getHeightMapUnit(int textureCount, int textureArrayCount);
+
+    float getFade() { return fade; }
+    bool getFadeOut() { return fadeOut; }
+    void setFade(float inFade, bool inFadeOut) { fade = inFade; fadeOut = inFadeOut; }
+    glm::vec2 getMorphRange() { return morphRange; }
+    void setMorphRange(glm::vec2 inMorphRange) { morphRange = inMorphRange; }
+    float getSpacing() { return spacing; }
+    bool isDisplacedOnGpu() { return gridVertices != nullptr; }
+    bool isTessellated() { return tessellated; }
+    void setHeightMapOrigin(glm::vec2 inHeightMapOrigin) { heightMapOrigin = inHeightMapOrigin; }
+    void setBiomeMapOrigin(glm::vec2 inBiomeMapOrigin) { biomeMapOrigin = inBiomeMapOrigin; }
+    void setNormalMapOrigin(glm::vec2 inNormalMapOrigin) { normalMapped = true; normalMapOrigin = inNormalMapOrigin; }
+    GpuBufferPool *getBufferPool() { return bufferPool; }
+    void setBufferPool(GpuBufferPool *inBufferPool) { bufferPool = inBufferPool; }
+    bool isUploaded() { return VAO != 0; }
+    size_t getGpuBytes();
+    size_t getCpuBytes();
+    void releaseData();
 
     void render(
         glm::mat4 view,
@@ -0,0 +1,50 @@
+/**
+ * @file TerrainLod.hpp
+ * @author King Attalus II
+ * @brief This file contains the TerrainLod class, which is used to select the resolution of subchunk meshes based on
+ * their distance from the camera.
+ * @details The render distance is split into bands that double in width moving away from the camera. The closest band
+ * uses the highest power of two resolution that does not exceed the subchunk resolution in the settings and every
+ * band after it halves the resolution down to 1 at the edge of the render distance. Vertices morph towards the next
+ * coarser level over the last part of each band so that switching between levels does not pop.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef TERRAINLOD_HPP
+#define TERRAINLOD_HPP
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+#include "Settings.hpp"
+
+using namespace std;
+
+/**
+ * @brief This class contains the static functions that map camera distances onto subchunk resolutions and morph
+ * ranges.
+ *
+ * @details Level 0 is the finest level and level getLevelCount() - 1 always has a resolution of 1. The outer edge of
+ * level k lies at renderDistance * subChunkSize / 2^(levels - 1 - k) so the coarsest level ends at the render
+ * distance.
+ *
+ */
+class TerrainLod
+{
+private:
+    // The constructor is private as we do not want to instantiate this class
+    inline TerrainLod(){};
+    inline ~TerrainLod(){};
+public:
+    static int getMaxResolution(Settings &settings);
+    static int getLevelCount(Settings &settings);
+    static float getLevelDistance(int level, Settings &settings);
+    static int selectResolution(float distance, Settings &settings);
+    static glm::vec2 getMorphRange(float resolution, Settings &settings);
+};
+
+#endif // TERRAINLOD_HPP
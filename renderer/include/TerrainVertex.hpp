@@ -0,0 +1,153 @@
+/**
+ * @file TerrainVertex.hpp
+ * @author King Attalus II
+ * @brief This file contains the TerrainVertex class, which is a compact 12 byte vertex used by the terrain meshes.
+ * @details The general Vertex class stores full precision positions, normals and texture coordinates in 32 bytes. The
+ * terrain does not need most of that as its vertices lie on a regular grid, so the x and z are stored as grid
+ * indices, the height and morph target height are quantised to 16 bits over the height range of the mesh and the
+ * normal is packed into two 16 bit values with an octahedral mapping.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef TERRAINVERTEX_HPP
+#define TERRAINVERTEX_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+/**
+ * @brief This class represents a single terrain vertex in the compact layout that is uploaded to the GPU.
+ *
+ * @details The layout is read by terrain_shader.vs as three attributes: the grid indices as two unsigned shorts, the
+ * height and morph target as two normalised unsigned shorts and the normal as two normalised shorts. The members are
+ * stored in that order without padding.
+ *
+ */
+class TerrainVertex
+{
+private:
+    uint16_t grid[2]; // The x and z index of the vertex on the grid of the mesh
+    uint16_t heights[2]; // The quantised height and morph target height
+    int16_t normal[2]; // The octahedral encoding of the normal
+public:
+    TerrainVertex(){
+        grid[0] = 0;
+        grid[1] = 0;
+        heights[0] = 0;
+        heights[1] = 0;
+        normal[0] = 0;
+        normal[1] = 32767;
+    };
+    TerrainVertex(int gridX, int gridZ, uint16_t height, uint16_t morphTarget, glm::vec3 inNormal){
+        grid[0] = static_cast<uint16_t>(gridX);
+        grid[1] = static_cast<uint16_t>(gridZ);
+        heights[0] = height;
+        heights[1] = morphTarget;
+        encodeNormal(inNormal, normal);
+    };
+    ~TerrainVertex() {};
+
+    int getGridX() const { return grid[0]; }
+    int getGridZ() const { return grid[1]; }
+    uint16_t getHeight() const { return heights[0]; }
+    uint16_t getMorphTarget() const { return heights[1]; }
+    glm::vec3 getNormal() const { return decodeNormal(normal[0], normal[1]); }
+
+    /**
+     * @brief This function will quantise a height to 16 bits over a height range
+     *
+     * @param value [in] float The height to quantise
+     * @param minimum [in] float The lowest height of the range
+     * @param range [in] float The size of the range, zero maps everything to the lowest height
+     *
+     * @return uint16_t The quantised height
+     *
+     */
+    static uint16_t quantiseHeight(float value, float minimum, float range){
+        if (range <= 0.0f){
+            return 0;
+        }
+        float normalised = std::clamp((value - minimum) / range, 0.0f, 1.0f);
+        return static_cast<uint16_t>(normalised * 65535.0f + 0.5f);
+    }
+
+    /**
+     * @brief This function will recover a height that has been quantised with quantiseHeight
+     *
+     * @param value [in] uint16_t The quantised height
+     * @param minimum [in] float The lowest height of the range
+     * @param range [in] float The size of the range
+     *
+     * @return float The height
+     *
+     */
+    static float dequantiseHeight(uint16_t value, float minimum, float range){
+        return minimum + range * (static_cast<float>(value) / 65535.0f);
+    }
+
+    /**
+     * @brief This function will pack a unit normal into two signed 16 bit values
+     *
+     * @details The normal is projected onto an octahedron which is unfolded onto a square, so the
+     * precision is spread evenly over every direction. The shader decodes it with the inverse
+     * mapping.
+     *
+     * @param inNormal [in] glm::vec3 The unit normal
+     * @param out [out] int16_t[2] The encoded normal
+     *
+     * @return void
+     *
+     */
+    static void encodeNormal(glm::vec3 inNormal, int16_t out[2]){
+        float sum = std::abs(inNormal.x) + std::abs(inNormal.y) + std::abs(inNormal.z);
+        if (sum <= 0.0f){
+            out[0] = 0;
+            out[1] = 32767;
+            return;
+        }
+        // The octahedron is folded around the y axis as terrain normals mostly point up
+        float u = inNormal.x / sum;
+        float v = inNormal.z / sum;
+        if (inNormal.y < 0.0f){
+            float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+            float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+            u = foldedU;
+            v = foldedV;
+        }
+        out[0] = static_cast<int16_t>(std::round(std::clamp(u, -1.0f, 1.0f) * 32767.0f));
+        out[1] = static_cast<int16_t>(std::round(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    /**
+     * @brief This function will unpack a normal that has been packed with encodeNormal
+     *
+     * @param u [in] int16_t The first encoded value
+     * @param v [in] int16_t The second encoded value
+     *
+     * @return glm::vec3 The unit normal
+     *
+     */
+    static glm::vec3 decodeNormal(int16_t u, int16_t v){
+        float x = std::max(static_cast<float>(u) / 32767.0f, -1.0f);
+        float z = std::max(static_cast<float>(v) / 32767.0f, -1.0f);
+        float y = 1.0f - std::abs(x) - std::abs(z);
+        if (y < 0.0f){
+            float unfoldedX = (1.0f - std::abs(z)) * (x >= 0.0f ? 1.0f : -1.0f);
+            float unfoldedZ = (1.0f - std::abs(x)) * (z >= 0.0f ? 1.0f : -1.0f);
+            x = unfoldedX;
+            z = unfoldedZ;
+        }
+        float length = std::sqrt(x * x + y * y + z * z);
+        return glm::vec3(x / length, y / length, z / length);
+    }
+};
+
+#endif // TERRAINVERTEX_HPP
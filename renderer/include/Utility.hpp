@@ -63,7 +63,7 @@ public:
     // Write a function prototype for bicubic interpolation
     static float bicubic_interpolation(
         glm::vec2 position,
-        vector<vector<float>> heightmap
+        const vector<vector<float>> &heightmap
     );
     static float cubic_interpolation(
         float p0,
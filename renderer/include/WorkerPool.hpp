@@ -0,0 +1,58 @@
+/**
+ * @file WorkerPool.hpp
+ * @author King Attalus II
+ * @brief This file contains the WorkerPool class, which is used to run CPU heavy tasks such as building subchunk
+ * meshes on a small set of background threads.
+ * @details Tasks are run in the order they are submitted. The pool does not provide any way to return a result, so
+ * tasks are expected to hand their results back through a structure of their own that the main thread polls. A task
+ * can be submitted with a cancellation token, in which case it is dropped without running if the token has been
+ * cancelled by the time a worker reaches it.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+
+#include "CancellationToken.hpp"
+
+using namespace std;
+
+/**
+ * @brief This class owns a fixed number of worker threads that run submitted tasks.
+ *
+ * @details Destroying the pool discards the tasks that have not started yet and waits for the running tasks to
+ * finish, so tasks must not hold anything that needs the pool to outlive them. Tasks must also not hold the last
+ * reference to anything whose destruction needs the main thread or the pool itself, as a discarded task is destroyed
+ * on whichever thread discards it.
+ *
+ */
+class WorkerPool
+{
+private:
+    vector<thread> workers; // The worker threads
+    deque<pair<function<void()>, CancellationToken>> tasks; // The tasks that are waiting to run and their tokens
+    mutex taskMutex; // The mutex for the task queue
+    condition_variable taskCondition; // Signalled when a task is submitted or the pool is stopping
+    bool stopping; // Whether the pool is shutting down
+
+    void workerLoop();
+public:
+    WorkerPool(int threadCount);
+    ~WorkerPool();
+
+    void submit(function<void()> task, CancellationToken token = CancellationToken());
+    void shutdown();
+    int getThreadCount() { return static_cast<int>(workers.size()); }
+    int getQueuedTaskCount();
+};
+
+#endif // WORKERPOOL_HPP
@@ -21,6 +21,9 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <curl/curl.h> // This will be used to complete the http requests
 #include <nlohmann/json.hpp> // This will be used to parse the json data
 
@@ -31,7 +34,13 @@
 #endif
 
 #include "IRenderable.hpp"
+#include "CancellationToken.hpp"
 #include "Chunk.hpp"
+#include "PlaceholderTerrain.hpp"
+#include "WorkerPool.hpp"
+#include "GpuBufferPool.hpp"
+#include "HorizonCuller.hpp"
+#include "SubChunkCache.hpp"
 #include "SkyBox.hpp"
 #include "Terrain.hpp"
 #include "Settings.hpp"
@@ -75,10 +84,23 @@ class World : public IRenderable {
 private:
     long seed; // The seed for the world
     std::vector<std::shared_ptr<Chunk>> chunks; // The chunks that are loaded in the world
+    std::vector<std::shared_ptr<Chunk>> placeholderChunks; // Approximate chunks shown while the real chunks are generated
+    std::vector<std::shared_ptr<Chunk>> retiredChunks; // Removed chunks kept until their mesh tasks are gone so they are destroyed on the main thread
+    std::shared_ptr<PlaceholderTerrain> placeholderTerrain; // The generator for the placeholder chunks
+    std::shared_ptr<WorkerPool> meshWorkers; // The threads that build subchunk meshes for every chunk
+    std::shared_ptr<GpuBufferPool> bufferPool; // Recycles the GPU buffers of subchunks as they are streamed in and out
+    HorizonCuller horizonCuller; // Skips the subchunks hidden behind the terrain in front of them
+    std::vector<SubChunk*> cullSubChunks; // The subchunks of the last culling pass, kept to reuse its storage
+    std::vector<HorizonBounds> cullBounds; // The bounds of the subchunks of the last culling pass
+    std::shared_ptr<SubChunkCache> subChunkCache; // Keeps recently drawn subchunks of every chunk within memory budgets
     std::vector<std::pair<int, int>> chunkRequests; // The chunks that are currently being generated to duplicate generation requests
     std::mutex chunkMutex; // The mutex for the chunk requests
     std::mutex requestMutex; // The mutex for the chunk requests
     std::mutex terrainTextureArraysMutex; // The mutex for the terrain texture arrays
+    std::shared_ptr<std::atomic<uint64_t>> generationEpoch; // Bumped whenever in-flight work becomes stale
+    int inFlightRequests; // The number of detached request threads that are still running
+    std::mutex inFlightMutex; // The mutex for the in-flight request count
+    std::condition_variable inFlightCondition; // Signalled when a detached request thread finishes
 
     std::shared_ptr<Settings> settings; // The settings for the world
     std::shared_ptr<Player> player; // The player object in the world
@@ -131,9 +153,23 @@ private:
 
 
     /*Functions required for async requesting*/
-    std::unique_ptr<PacketData> readPacketData(char *data, int size);
+    std::unique_ptr<PacketData> readPacketData(char *data, int size, const CancellationToken &token);
     static size_t writeCallback(void *contents, size_t size, size_t nmemb, void *userp);
-    std::unique_ptr<PacketData> requestNewChunk(int cx, int cz);
+    static int progressCallback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+    std::unique_ptr<PacketData> requestNewChunk(int cx, int cz, CancellationToken token);
+    std::shared_ptr<Chunk> createChunk(std::unique_ptr<PacketData> packetData, const CancellationToken &token);
+    std::shared_ptr<Chunk> createPlaceholderChunk(
+        int cx,
+        int cz,
+        std::shared_ptr<PlaceholderTerrain> generator,
+        const CancellationToken &token
+    );
+    bool addPlaceholderChunk(std::shared_ptr<Chunk> chunk, const CancellationToken &token);
+    void updatePlaceholderChunks();
+    void cullHiddenSubChunks(glm::vec3 viewPos);
+    void releaseCachedSubChunks();
+    void retireChunks(std::vector<std::shared_ptr<Chunk>> &list, const std::function<bool(const std::shared_ptr<Chunk>&)> &shouldRetire);
+    void releaseRetiredChunks();
     int requestInitialChunks(std::vector<std::pair<int, int>> initialChunks);
 
 public:
@@ -149,18 +185,22 @@ public:
         std::shared_ptr<WaterFrameBuffer> reflectionBuffer,
         std::shared_ptr<WaterFrameBuffer> refractionBuffer
     );
-    ~World() {};
+    ~World();
 
     // These are the mutex controlled functions
     void addChunk(shared_ptr<Chunk> chunk);
+    bool commitChunk(shared_ptr<Chunk> chunk, const CancellationToken &token);
     void removeChunk(int cx, int cz);
     std::shared_ptr<Chunk> getChunk(int cx, int cz);
     std::shared_ptr<Chunk> getChunk(int cx, int cz, bool &found);
     void clearChunks();
     int getChunkCount();
     bool isChunkRequested(int cx, int cz);
-    void addChunkRequest(int cx, int cz);
+    CancellationToken addChunkRequest(int cx, int cz);
     void removeChunkRequest(int cx, int cz);
+    void releaseChunkRequest(int cx, int cz, const CancellationToken &token);
+    void cancelInFlightWork();
+    CancellationToken getCancellationToken();
     void printRequests();
     void printChunks();
     int regenerateSpawnChunks(glm::vec3 playerPos);
@@ -169,6 +209,7 @@ public:
     long getSeed() {return seed;}
     void setSeed(long inSeed) {seed = inSeed;}
     std::shared_ptr<Settings> getSettings() {return settings;}
+    std::shared_ptr<SubChunkCache> getSubChunkCache() {return subChunkCache;}
     void setSettings(std::shared_ptr<Settings> inSettings) {settings = inSettings;}
     std::shared_ptr<SkyBox> getSkyBox() {return skyBox;}
     void setSkyBox(std::shared_ptr<SkyBox> inSkyBox) {skyBox = inSkyBox;}
@@ -0,0 +1,220 @@
+/**
+ * @file AdaptiveTriangulation.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the AdaptiveTriangulation class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "AdaptiveTriangulation.hpp"
+
+using namespace std;
+
+/**
+ * @brief This function will return the number of vertices per axis the triangulation is built over
+ *
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the grid
+ *
+ * @return int The smallest 2^k + 1 that is at least the number of vertices per axis of the grid
+ *
+ */
+int AdaptiveTriangulation::getGridSize(int numberOfVerticesPerAxis){
+    int tileSize = 1;
+    while (tileSize + 1 < numberOfVerticesPerAxis){
+        tileSize *= 2;
+    }
+    return tileSize + 1;
+}
+
+/**
+ * @brief This function will compute the error map of a grid
+ *
+ * @details Every triangle of the hierarchy has a grid vertex at the middle of its hypotenuse, which
+ * is where it is split. The error stored at that vertex is the largest distance between the heights
+ * covered by either triangle sharing the hypotenuse and the plane through its corners, raised to the
+ * errors of their children. A triangle is therefore split whenever it or any triangle below it is
+ * too far from the heights, and both triangles on a hypotenuse always split together. The error of
+ * a triangle that crosses the edge of the grid is infinite so it is always split. The triangles are
+ * visited from the smallest to the largest following the heap order of the hierarchy.
+ *
+ * @param heights [in] const float* The heights of the grid indexed by z * numberOfVerticesPerAxis + x
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the grid
+ *
+ * @return std::vector<float> The error of each vertex of the triangulation grid
+ *
+ */
+vector<float> AdaptiveTriangulation::computeErrors(const float *heights, int numberOfVerticesPerAxis){
+    int gridSize = getGridSize(numberOfVerticesPerAxis);
+    int tileSize = gridSize - 1;
+    int last = numberOfVerticesPerAxis - 1;
+    vector<float> errors = vector<float>(gridSize * gridSize, 0.0f);
+    if (numberOfVerticesPerAxis < 2){
+        return errors;
+    }
+    int numberOfTriangles = tileSize * tileSize * 2 - 2;
+    int numberOfParentTriangles = numberOfTriangles - tileSize * tileSize;
+    for (int i = numberOfTriangles - 1; i >= 0; i--){
+        // Walk down the hierarchy to find the corners of the triangle, c is the right angle
+        int id = i + 2;
+        int ax = 0, az = 0, bx = 0, bz = 0, cx = 0, cz = 0;
+        if (id & 1){
+            bx = bz = cx = tileSize;
+        } else {
+            ax = az = cz = tileSize;
+        }
+        while ((id >>= 1) > 1){
+            int mx = (ax + bx) >> 1;
+            int mz = (az + bz) >> 1;
+            if (id & 1){
+                bx = ax; bz = az;
+                ax = cx; az = cz;
+            } else {
+                ax = bx; az = bz;
+                bx = cx; bz = cz;
+            }
+            cx = mx;
+            cz = mz;
+        }
+        int middle = ((az + bz) >> 1) * gridSize + ((ax + bx) >> 1);
+        float error = 0.0f;
+        if (max(ax, max(bx, cx)) > last || max(az, max(bz, cz)) > last){
+            error = numeric_limits<float>::infinity();
+        } else {
+            // Measure every height covered by the triangle against the plane through its corners
+            float heightA = heights[az * numberOfVerticesPerAxis + ax];
+            float heightB = heights[bz * numberOfVerticesPerAxis + bx];
+            float heightC = heights[cz * numberOfVerticesPerAxis + cx];
+            float area = static_cast<float>((bx - ax) * (cz - az) - (bz - az) * (cx - ax));
+            for (int z = min(az, min(bz, cz)); z <= max(az, max(bz, cz)); z++){
+                for (int x = min(ax, min(bx, cx)); x <= max(ax, max(bx, cx)); x++){
+                    float weightA = static_cast<float>((bx - x) * (cz - z) - (bz - z) * (cx - x)) / area;
+                    float weightB = static_cast<float>((cx - x) * (az - z) - (cz - z) * (ax - x)) / area;
+                    float weightC = 1.0f - weightA - weightB;
+                    if (weightA < 0.0f || weightB < 0.0f || weightC < -1e-6f){
+                        continue;
+                    }
+                    float planeHeight = weightA * heightA + weightB * heightB + weightC * heightC;
+                    error = max(error, abs(heights[z * numberOfVerticesPerAxis + x] - planeHeight));
+                }
+            }
+        }
+        errors[middle] = max(errors[middle], error);
+        if (i < numberOfParentTriangles){
+            int leftChild = ((az + cz) >> 1) * gridSize + ((ax + cx) >> 1);
+            int rightChild = ((bz + cz) >> 1) * gridSize + ((bx + cx) >> 1);
+            errors[middle] = max(errors[middle], max(errors[leftChild], errors[rightChild]));
+        }
+    }
+    return errors;
+}
+
+/**
+ * @brief This function will generate the index buffer of the adaptive triangulation of a grid
+ *
+ * @param heights [in] const float* The heights of the grid indexed by z * numberOfVerticesPerAxis + x
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the grid
+ * @param maxError [in] float The largest distance allowed between the mesh and the heights
+ *
+ * @return std::vector<unsigned int> The index buffer
+ *
+ */
+vector<unsigned int> AdaptiveTriangulation::generateIndices(
+    const float *heights,
+    int numberOfVerticesPerAxis,
+    float maxError
+){
+    return generateIndicesFromErrors(computeErrors(heights, numberOfVerticesPerAxis), numberOfVerticesPerAxis, maxError);
+}
+
+/**
+ * @brief This function will generate the index buffer of the adaptive triangulation from an error map
+ *
+ * @details The error map only depends on the heights, so it can be kept to triangulate the same
+ * grid at several maximum errors. A maximum error of zero still merges triangles that are exactly
+ * planar.
+ *
+ * @param errors [in] const std::vector<float>& The error map from computeErrors
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the grid
+ * @param maxError [in] float The largest distance allowed between the mesh and the heights
+ *
+ * @return std::vector<unsigned int> The index buffer
+ *
+ */
+vector<unsigned int> AdaptiveTriangulation::generateIndicesFromErrors(
+    const vector<float> &errors,
+    int numberOfVerticesPerAxis,
+    float maxError
+){
+    vector<unsigned int> indices;
+    if (numberOfVerticesPerAxis < 2){
+        return indices;
+    }
+    int gridSize = getGridSize(numberOfVerticesPerAxis);
+    int tileSize = gridSize - 1;
+    // The triangles crossing the edge of the grid have an infinite error and must always be split
+    maxError = min(max(maxError, 0.0f), numeric_limits<float>::max());
+    emitTriangle(errors, gridSize, numberOfVerticesPerAxis, maxError, 0, 0, tileSize, tileSize, tileSize, 0, indices);
+    emitTriangle(errors, gridSize, numberOfVerticesPerAxis, maxError, tileSize, tileSize, 0, 0, 0, tileSize, indices);
+    return indices;
+}
+
+/**
+ * @brief This function will add a triangle to the index buffer or split it across its hypotenuse
+ *
+ * @details Triangles that lie outside the grid are dropped, which only happens when the grid is
+ * smaller than the triangulation grid. The corners are reordered where needed so the triangle has
+ * the same winding as the grid triangles.
+ *
+ * @param errors [in] const std::vector<float>& The error map from computeErrors
+ * @param gridSize [in] int The number of vertices per axis of the triangulation grid
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the grid
+ * @param maxError [in] float The largest distance allowed between the mesh and the heights
+ * @param ax [in] int The x coordinate of the first end of the hypotenuse
+ * @param az [in] int The z coordinate of the first end of the hypotenuse
+ * @param bx [in] int The x coordinate of the second end of the hypotenuse
+ * @param bz [in] int The z coordinate of the second end of the hypotenuse
+ * @param cx [in] int The x coordinate of the right angle
+ * @param cz [in] int The z coordinate of the right angle
+ * @param indices [in/out] std::vector<unsigned int>& The index buffer
+ *
+ * @return void
+ *
+ */
+void AdaptiveTriangulation::emitTriangle(
+    const vector<float> &errors,
+    int gridSize,
+    int numberOfVerticesPerAxis,
+    float maxError,
+    int ax,
+    int az,
+    int bx,
+    int bz,
+    int cx,
+    int cz,
+    vector<unsigned int> &indices
+){
+    int last = numberOfVerticesPerAxis - 1;
+    if (min(ax, min(bx, cx)) >= last || min(az, min(bz, cz)) >= last){
+        return;
+    }
+    int mx = (ax + bx) >> 1;
+    int mz = (az + bz) >> 1;
+    if (abs(ax - cx) + abs(az - cz) > 1 && !(errors[mz * gridSize + mx] <= maxError)){
+        emitTriangle(errors, gridSize, numberOfVerticesPerAxis, maxError, cx, cz, ax, az, mx, mz, indices);
+        emitTriangle(errors, gridSize, numberOfVerticesPerAxis, maxError, bx, bz, cx, cz, mx, mz, indices);
+        return;
+    }
+    unsigned int a = az * numberOfVerticesPerAxis + ax;
+    unsigned int b = bz * numberOfVerticesPerAxis + bx;
+    unsigned int c = cz * numberOfVerticesPerAxis + cx;
+    // The grid triangles turn clockwise when looking down the y axis in x and z
+    if ((bx - ax) * (cz - az) - (bz - az) * (cx - ax) > 0){
+        swap(b, c);
+    }
+    indices.insert(indices.end(), {a, b, c});
+}
@@ -0,0 +1,53 @@
+/**
+ * @file CancellationToken.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the CancellationToken class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+#include "CancellationToken.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new empty Cancellation Token object
+ *
+ * @details An empty token is not tied to any epoch counter and so it will never report that it
+ * has been cancelled.
+ *
+ */
+CancellationToken::CancellationToken():
+    source(nullptr),
+    epoch(0)
+{}
+
+/**
+ * @brief Construct a new Cancellation Token object tied to the given epoch counter
+ *
+ * @details The current value of the counter is captured so that any later change to the counter
+ * will cancel the token.
+ *
+ * @param inSource [in] shared_ptr<const atomic<uint64_t>> The epoch counter to observe
+ *
+ */
+CancellationToken::CancellationToken(shared_ptr<const atomic<uint64_t>> inSource):
+    source(inSource),
+    epoch(inSource != nullptr ? inSource->load(memory_order_acquire) : 0)
+{}
+
+/**
+ * @brief This function will determine if the work associated with the token has been cancelled
+ *
+ * @details This is safe to call from any thread and is cheap enough to be polled inside loops.
+ *
+ * @return bool Whether or not the epoch has moved on since the token was created
+ *
+ */
+bool CancellationToken::isCancelled() const {
+    return source != nullptr && source->load(memory_order_acquire) != epoch;
+}
@@ -15,12 +15,16 @@
 #include <unordered_map>
 #include <memory>
 #include <cmath>
+#include <algorithm>
+#include <utility>
 #include <omp.h>
 
 #ifdef DEPARTMENT_BUILD
     #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+    #include "/dcs/large/efogahlewem/.local/include/glad/glad.h"
 #else
     #include <glm/glm.hpp>
+    #include <glad/glad.h>
 #endif
 
 #include "Chunk.hpp"
@@ -29,9 +33,27 @@
 #include "IRenderable.hpp"
 #include "Shader.hpp"
 #include "Utility.hpp"
+#include "TerrainLod.hpp"
+#include "ChunkQuadtree.hpp"
 #include "Texture.hpp"
 #include "WaterFrameBuffer.hpp"
 
+/**
+ * @brief This struct counts a mesh task of a chunk as in flight for as long as the task exists
+ *
+ * @details The count only drops once the task has been destroyed, whether it ran or was discarded
+ * by the workers, so once it reaches zero no worker can hold the chunk any more.
+ *
+ */
+struct BuildTicket {
+    shared_ptr<atomic<int>> count; // The count of the mesh tasks of the chunk that are in flight
+
+    BuildTicket(shared_ptr<atomic<int>> inCount) : count(inCount) { count->fetch_add(1); }
+    ~BuildTicket() { count->fetch_sub(1); }
+    BuildTicket(const BuildTicket &) = delete;
+    BuildTicket &operator=(const BuildTicket &) = delete;
+};
+
 /**
  * @brief Construct a new Chunk object from the given parameters, other values are set to default values.
  *
@@ -77,6 +99,9 @@ Chunk::Chunk(
     chunkCoords(inChunkCoords),
     heightmapData(inHeightmapData),
     biomeData(inBiomeData),
+    subChunksEvaluated(false),
+    lastPlayerCell(0, 0),
+    lastLodSettings(),
     terrainShader(inTerrainShader),
     oceanShader(inOceanShader),
     terrainTextures(inTerrainTextures),
@@ -84,16 +109,41 @@ Chunk::Chunk(
     reflectionBuffer(inReflectionBuffer),
     refractionBuffer(inRefractionBuffer),
     oceanTextures(inOceanTextures),
-    subbiomeTextureArrayMap(subbiomeTextureArrayMap)
+    subbiomeTextureArrayMap(subbiomeTextureArrayMap),
+    placeholder(false),
+    fading(false),
+    fadingOut(false),
+    fadeStartTime(-1.0),
+    fade(1.0f),
+    meshWorkers(nullptr),
+    retired(false),
+    buildsInFlight(make_shared<atomic<int>>(0)),
+    hasPendingStatus(false),
+    outstandingBuilds(0),
+    bufferPool(make_shared<GpuBufferPool>(0)),
+    heightTextureID(0),
+    normalTextureID(0),
+    biomeTextureID(0)
 {
-    // Initialize the loadedSubChunks and cachedSubChunks vectors to the size of the chunk
-    loadedSubChunks = vector<shared_ptr<SubChunk>>((size - 1) / (subChunkSize - 1) * (size - 1) / (subChunkSize - 1));
-    cachedSubChunks = vector<shared_ptr<SubChunk>>((size - 1) / (subChunkSize - 1) * (size - 1) / (subChunkSize - 1));
+    // Build the quadtree that decides which subchunks are drawn as coarser patches
+    quadtree = make_shared<ChunkQuadtree>(heightmapData, size, subChunkSize, settings->getMaximumHeight());
+    // Build the pyramid that bounds the heights of any part of the chunk
+    heightPyramid = make_shared<HeightPyramid>(heightmapData);
+    // Bake the normals of the whole chunk once so that the meshes do not need to work out their own
+    bakeNormalMap();
+    // Every slot of the subchunk pool holds a subchunk, its terrain and ocean and the reference
+    // counts of the shared pointer, and a slab holds enough for the subchunks around the player
+    subChunkPool = make_shared<SlabPool>(sizeof(SubChunk) + SUBCHUNK_CONTROL_BYTES, SUBCHUNKS_PER_SLAB);
+    // Initialize the loadedSubChunks and cachedSubChunks vectors to hold every quadtree node
+    loadedSubChunks = vector<shared_ptr<SubChunk>>(quadtree->getNodeCount());
+    cachedSubChunks = vector<shared_ptr<SubChunk>>(quadtree->getNodeCount());
     // Make all of the entries in the loadedSubChunks map nullptr
-    for (int i = 0; i < ((size - 1) / (subChunkSize - 1)) * ((size - 1) / (subChunkSize - 1)); i++){
+    for (int i = 0; i < quadtree->getNodeCount(); i++){
         loadedSubChunks[i] = nullptr;
         cachedSubChunks[i] = nullptr;
     }
+    nodeStatus = vector<int>(quadtree->getNodeCount(), 0);
+    residentListed = vector<uint8_t>(quadtree->getNodeCount(), 0);
     setupData();
 }
 
@@ -111,6 +161,54 @@ vector<float> Chunk::getChunkWorldCoords()
     return worldCoords;
 }
 
+/**
+ * @brief This method will start cross-fading the chunk in or out
+ *
+ * @details The start time is captured on the next call to updateFade so that the fade can be
+ * started from any thread before the chunk is shared with the render thread.
+ *
+ * @param out [in] bool Whether the chunk should fade out rather than in
+ *
+ * @returns void
+ *
+ */
+void Chunk::startFade(bool out)
+{
+    fading = true;
+    fadingOut = out;
+    fadeStartTime = -1.0;
+    fade = 0.0f;
+}
+
+/**
+ * @brief This method will advance the cross-fade of the chunk
+ *
+ * @details The fade value always runs from 0 to 1. When fading in it is the visible fraction of the
+ * chunk and when fading out it is the hidden fraction, which lets both chunks use the same value
+ * with complementary dither thresholds in the terrain shader. A chunk that has finished fading in
+ * stops fading, while a chunk that has finished fading out stays at 1 until it is removed.
+ *
+ * @param time [in] double The current time in seconds
+ * @param duration [in] float The duration of the fade in seconds
+ *
+ * @returns void
+ *
+ */
+void Chunk::updateFade(double time, float duration)
+{
+    if (!fading){
+        return;
+    }
+    if (fadeStartTime < 0.0){
+        fadeStartTime = time;
+    }
+    fade = duration > 0.0f ? static_cast<float>((time - fadeStartTime) / duration) : 1.0f;
+    fade = max(0.0f, min(fade, 1.0f));
+    if (fade >= 1.0f && !fadingOut){
+        fading = false;
+    }
+}
+
 /**
  * @brief This method will return a vector of all the loaded subchunks within the chunk
  *
@@ -120,14 +218,35 @@ vector<float> Chunk::getChunkWorldCoords()
 vector<shared_ptr<SubChunk>> Chunk::getLoadedSubChunks()
 {
     vector<shared_ptr<SubChunk>> subChunks;
-    for (auto subChunk : loadedSubChunks){
-        if (subChunk != nullptr){
-            subChunks.push_back(subChunk);
+    for (int key : residentNodes){
+        if (loadedSubChunks[key] != nullptr){
+            subChunks.push_back(loadedSubChunks[key]);
         }
     }
     return subChunks;
 }
 
+/**
+ * @brief This method will add the loaded subchunks of the chunk to the end of a list
+ *
+ * @details Unlike getLoadedSubChunks this neither allocates a new list nor copies the shared
+ * pointers, so it suits passes that run every frame. The pointers are only valid until the
+ * subchunks of the chunk are next updated.
+ *
+ * @param subChunks [out] std::vector<SubChunk*>& The list to add the loaded subchunks to
+ *
+ * @returns void
+ *
+ */
+void Chunk::appendLoadedSubChunks(vector<SubChunk *> &subChunks)
+{
+    for (int key : residentNodes){
+        if (loadedSubChunks[key] != nullptr){
+            subChunks.push_back(loadedSubChunks[key].get());
+        }
+    }
+}
+
 
 /**
  * @brief This method will take a world position and return the subchunk id of that position within the
@@ -192,65 +311,110 @@ void Chunk::addSubChunk(int id, float resolution){
         if (subChunkResolution != resolution){
             // If the subchunk is already loaded but the resolution is different then we need to
             // reload the subchunk with the new resolution
-            cachedSubChunks[id].reset();
-            cachedSubChunks[id] = nullptr;
+            dropCachedSubChunk(id);
             addSubChunk(id, resolution);
         } else {
             // If the subchunk is in the cachedSubChunks map and the resolution is the same then we
             // move it to the loadedSubChunks map
-            loadedSubChunks[id] = cachedSubChunks[id];
-            cachedSubChunks[id].reset();
-            cachedSubChunks[id] = nullptr;
+            loadedSubChunks[id] = takeCachedSubChunk(id);
+            markResident(id);
         }
     } else {
         // If the subchunk is not in the loadedSubChunks or cachedSubChunks map then we need to
         // generate the subchunk and add it to the loadedSubChunks map
-        // We will generate the subchunk using the parent chunk's vertices
-        // The subchunk will be generated based on the subchunk id
-
-        // We convert the subchunk id back into the starting chunk local coordinate for the subchunk
-        // For example the id is 343 then it is the 10th row and 23rd column of the 32x32 grid
-        int bottomLeftX = (id % (subChunkSize + 1)) * (subChunkSize -1);  // The coloumn of the subchunk in the 32x32 grid
-        int bottomLeftZ = (id / (subChunkSize + 1)) * (subChunkSize -1);  // The row of the subchunk in the 32x32 grid
-        vector<vector<float>> subChunkHeights = vector<vector<float>>(subChunkSize + 2, vector<float>(subChunkSize + 2));
-        vector<vector<uint8_t>> subChunkBiomes = vector<vector<uint8_t>>(subChunkSize + 2, vector<uint8_t>(subChunkSize + 2));
-        // We also have to account for the border vertices. Suppose we have subchunk 0,0 then
-        // the bottom left corner will actually be at 1,1 within the chunk vertices and we need to
-        // extract the 34x34 subchunk to account for the border vertices. This would be the same as
-        // extracting 0,0 to 33,33 from the chunk vertices. Hence we do not need to modify the
-        // bottomLeftX and bottomLeftZ values as we can just complete two additional iterations
-
-        for (int z = bottomLeftZ; z < bottomLeftZ + subChunkSize + 2; z++){
-            for (int x = bottomLeftX; x < bottomLeftX + subChunkSize + 2; x++){
-                subChunkHeights[z - bottomLeftZ][x - bottomLeftX] = heightmapData[z][x];
-            }
-        }
-        for (int z = bottomLeftZ; z < bottomLeftZ + subChunkSize + 2; z++){
-            for (int x = bottomLeftX; x < bottomLeftX + subChunkSize + 2; x++){
-                subChunkBiomes[z - bottomLeftZ][x - bottomLeftX] = biomeData[z][x];
-            }
+        if (subChunkCache != nullptr){
+            subChunkCache->recordMiss();
         }
-        // Generate the subchunk
-        shared_ptr<SubChunk> subChunk = make_shared<SubChunk>(
-            id,
-            shared_from_this(),
-            settings,
-            resolution,
-            vector<int>{bottomLeftX, bottomLeftZ},
-            subChunkHeights,
-            subChunkBiomes,
-            terrainShader,
-            oceanShader,
-            terrainTextures,
-            reflectionBuffer,
-            refractionBuffer,
-            oceanTextures
-        );
+        shared_ptr<SubChunk> subChunk = buildSubChunk(id, resolution);
+        updateMorphRange(id, subChunk);
+        subChunk->setupData();
         // Add the subchunk to the loadedSubChunks map
         loadedSubChunks[id] = subChunk;
+        markResident(id);
     }
 }
 
+/**
+ * @brief This method will build the CPU side of a subchunk
+ *
+ * @details The subchunk will be generated using the parent chunk's vertices, based on the subchunk
+ * id, which identifies a node of the quadtree. A node at level L covers 2^L x 2^L subchunks and
+ * samples the heightmap every 2^L vertices so that it has the same number of vertices as a single
+ * subchunk. Nothing here touches OpenGL so it is safe to call from a worker thread, and the caller
+ * is responsible for calling updateMorphRange and setupData on the subchunk from the main thread.
+ *
+ * @param id [in] int The id of the subchunk to build
+ * @param resolution [in] float The resolution of the subchunk
+ *
+ * @returns std::shared_ptr<SubChunk> The subchunk, which has not been uploaded to the GPU yet
+ *
+ */
+shared_ptr<SubChunk> Chunk::buildSubChunk(int id, float resolution){
+    // We convert the subchunk id back into the starting chunk local coordinate for the subchunk
+    // For example the id is 343 then it is the 10th row and 13th column of the 33x33 grid
+    QuadtreeNode node = quadtree->getNodeFromKey(id);
+    int stride = 1 << node.level;
+    int bottomLeftX = node.x * (subChunkSize - 1);  // The coloumn of the subchunk in the 33x33 grid
+    int bottomLeftZ = node.z * (subChunkSize - 1);  // The row of the subchunk in the 33x33 grid
+    int heightsPerAxis = subChunkSize + 2;
+    vector<float> subChunkHeights = vector<float>(heightsPerAxis * heightsPerAxis);
+    // We also have to account for the border vertices. Suppose we have subchunk 0,0 then
+    // the bottom left corner will actually be at 1,1 within the chunk vertices and we need to
+    // extract the 34x34 subchunk to account for the border vertices. This would be the same as
+    // extracting 0,0 to 33,33 from the chunk vertices. The border of a coarser patch is one
+    // stride away from its edge and is clamped to the border of the chunk. The heights are kept
+    // row by row in one buffer so the subchunk is built from a single allocation
+    for (int z = 0; z < heightsPerAxis; z++){
+        int heightmapZ = clamp(bottomLeftZ + (z - 1) * stride + 1, 0, size + 1);
+        for (int x = 0; x < heightsPerAxis; x++){
+            int heightmapX = clamp(bottomLeftX + (x - 1) * stride + 1, 0, size + 1);
+            subChunkHeights[z * heightsPerAxis + x] = heightmapData[heightmapZ][heightmapX];
+        }
+    }
+    // Generate the subchunk, which only keeps pointers to the shaders, textures and framebuffers of
+    // the chunk and reads the textures when it is rendered on the main thread
+    shared_ptr<SubChunk> subChunk = allocate_shared<SubChunk>(
+        SlabAllocator<SubChunk>(subChunkPool),
+        id,
+        this,
+        settings.get(),
+        resolution,
+        vector<int>{bottomLeftX, bottomLeftZ},
+        std::move(subChunkHeights),
+        terrainShader.get(),
+        oceanShader.get(),
+        &terrainTextures,
+        &terrainTextureArrays,
+        reflectionBuffer.get(),
+        refractionBuffer.get(),
+        &oceanTextures,
+        static_cast<float>(stride)
+    );
+    return subChunk;
+}
+
+/**
+ * @brief This method will build the CPU side of a batch of subchunks
+ *
+ * @details The subchunks are shared out between the OpenMP threads so every core builds whole
+ * subchunks, as a single subchunk is too small to be worth splitting between threads and the
+ * kernels that build it run serially. Subchunks at a higher resolution take longer to build, so
+ * they are handed out dynamically. Like buildSubChunk nothing here touches OpenGL.
+ *
+ * @param requests [in] const std::vector<std::pair<int, float>>& The id and resolution of each subchunk to build
+ *
+ * @returns std::vector<std::shared_ptr<SubChunk>> The subchunks in the order they were requested
+ *
+ */
+vector<shared_ptr<SubChunk>> Chunk::buildSubChunks(const vector<pair<int, float>> &requests){
+    vector<shared_ptr<SubChunk>> subChunks = vector<shared_ptr<SubChunk>>(requests.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(requests.size()); i++){
+        subChunks[i] = buildSubChunk(requests[i].first, requests[i].second);
+    }
+    return subChunks;
+}
+
 /**
  * @brief This method will return the distance from the player to the chunk. This is used to determine
  * if the chunk is within the render distance of the player.
@@ -274,6 +438,69 @@ float Chunk::getDistanceToChunk(glm::vec3 playerPos){
     return sqrt(pow(playerPos.x - closestX, 2) + pow(playerPos.z - closestZ, 2));
 }
 
+/**
+ * @brief This method will replace the heightmap of the chunk and rebuild its height pyramid
+ *
+ * @param inHeightmapData [in] std::vector<std::vector<float>> The new heightmap including its border
+ *
+ * @returns void
+ *
+ */
+void Chunk::setHeightmapData(vector<vector<float>> inHeightmapData){
+    heightmapData = inHeightmapData;
+    heightPyramid = make_shared<HeightPyramid>(heightmapData);
+    bakeNormalMap();
+}
+
+/**
+ * @brief This method will return the lowest and highest world heights within a rectangle of the chunk
+ *
+ * @details The rectangle is given in chunk local vertex coordinates, so 0 is the first vertex inside
+ * the border and -1 and size are the border vertices. The bounds are exact as the partly covered
+ * tiles of the height pyramid are scanned from the heightmap. The pyramid is never changed while
+ * the subchunks are built so this is safe to call from the mesh workers.
+ *
+ * @param minX [in] int The first column of the rectangle
+ * @param minZ [in] int The first row of the rectangle
+ * @param maxX [in] int The last column of the rectangle
+ * @param maxZ [in] int The last row of the rectangle
+ *
+ * @returns glm::vec2 The lowest and highest world heights within the rectangle
+ *
+ */
+glm::vec2 Chunk::getHeightBounds(int minX, int minZ, int maxX, int maxZ){
+    glm::vec2 bounds = heightPyramid->getBounds(heightmapData, minX + 1, minZ + 1, maxX + 1, maxZ + 1);
+    if (bounds.x > bounds.y){
+        return glm::vec2(0.0f, 0.0f);
+    }
+    return bounds * settings->getMaximumHeight();
+}
+
+/**
+ * @brief This method will return the lowest and highest world heights of a subchunk
+ *
+ * @details The bounds cover the quadtree node of the subchunk together with the border one stride
+ * beyond it on each side, which is every height the mesh of the subchunk is built from.
+ *
+ * @param id [in] int The id of the subchunk
+ *
+ * @returns glm::vec2 The lowest and highest world heights of the subchunk
+ *
+ */
+glm::vec2 Chunk::getSubChunkHeightBounds(int id){
+    QuadtreeNode node = quadtree->getNodeFromKey(id);
+    int stride = 1 << node.level;
+    int span = (subChunkSize - 1) << node.level;
+    int bottomLeftX = node.x * (subChunkSize - 1);
+    int bottomLeftZ = node.z * (subChunkSize - 1);
+    return getHeightBounds(
+        bottomLeftX - stride,
+        bottomLeftZ - stride,
+        bottomLeftX + span + stride,
+        bottomLeftZ + span + stride
+    );
+}
+
 /*
     This method will take in a subchunk id (0-(size/subChunkSize)^2) and return the world
     coordinates of the subchunk for its origin (bottom left corner). The subchunk id is a unique
@@ -315,19 +542,26 @@ vector<float> Chunk::getSubChunkWorldCoords(int id){
  * @brief This method will use the player's position and their render distance to determine the action for each subchunk
  * and whether they need to be loaded, cached, or unloaded.
  *
- * @details These subchunks will be returned as a vector of subchunk ids to then be loaded by the renderer. The vector
- * that is returned will be (size / subChunkSize) * (size / subChunkSize) with entries -1,0,<resolution> to determine
- * if the subchunk needs to be deleted, unloaded or loaded. The resolution is the resolution of the mesh that will
- * be produce.
+ * @details The statuses are written to pendingStatus as pairs of a quadtree node id and a status of -1, 0 or
+ * <resolution> to determine if the subchunk needs to be deleted, unloaded or loaded, where the resolution is the
+ * resolution of the mesh that will be produced. Only the selected nodes and the nodes that have a subchunk are listed,
+ * as unloading or deleting any other node does nothing, so an evaluation does not visit every node of the quadtree.
+ * The list is left empty if the player is not within the render distance of the chunk. The buffers are reused
+ * between evaluations so that nothing is allocated once they have grown.
  *
  * @param playerPos [in] glm::vec3 The position of the player in world coordinates
- * @param settings [in] Settings The settings object
+ * @param fieldOfView [in] float The vertical field of view of the camera in degrees
+ * @param settings [in] Settings& The settings object
  *
- * @returns std::vector<int> A vector of integers containing the subchunk ids and their render status
- * @returns std::vector<int>() An empty vector if the player is not within the render distance of the chunk
+ * @returns void
  *
  */
-vector<int> Chunk::checkRenderDistance(glm::vec3 playerPos, Settings settings){
+void Chunk::checkRenderDistance(glm::vec3 playerPos, float fieldOfView, Settings &settings){
+    // Clear the statuses of the previous evaluation
+    for (const pair<int, int> &status : pendingStatus){
+        nodeStatus[status.first] = 0;
+    }
+    pendingStatus.clear();
     // The render distance is the number of subchunks that the player can see in each direction
     // from their current position.
     int renderDistance = settings.getRenderDistance();
@@ -335,80 +569,284 @@ vector<int> Chunk::checkRenderDistance(glm::vec3 playerPos, Settings settings){
     float distance = getDistanceToChunk(playerPos);
     // We have to multiply by subChunkSize to get the actual distance in world space
     if (distance > 2 * renderDistance * subChunkSize){
-        // If the player is not within the render distance of the chunk then we return an empty
-        // vector as no subchunks need to be loaded
-        return vector<int>();
+        // If the player is not within the render distance of the chunk then we leave the
+        // statuses empty as no subchunks need to be loaded
+        return;
     }
     // If the player is within the render distance of the chunk then we need to determine which
     // subchunks need to be loaded and which subchunks need to be unloaded
-    vector<int> subChunksToLoad = vector<int>( ((size -1) / (subChunkSize - 1)) * ((size -1) / (subChunkSize - 1)));
-    // Iterate through all of the subchunks within the chunk and determine their render status
-    for (int i = 0; i < static_cast<int>(subChunksToLoad.size()); i++){
-        // Get the subchunk id
-        int subChunkId = i;
-        // Get the world coordinates of the subchunk
-        vector<float> subChunkWorldCoords = getSubChunkWorldCoords(subChunkId);
-        float subChunkX = subChunkWorldCoords[0];
-        float subChunkZ = subChunkWorldCoords[1];
-        float subChunkMidX = subChunkX + (subChunkSize / 2.0);
-        float subChunkMidZ = subChunkZ + (subChunkSize / 2.0);
-        // Get the distance to the subchunk
-        float distanceToSubChunk = sqrt(pow(playerPos.x - subChunkMidX, 2) + pow(playerPos.z - subChunkMidZ, 2));
-        if (distanceToSubChunk > 2 * renderDistance * subChunkSize){
-            // The subchunk is far enough away that it should be deleted to save memory
-            subChunksToLoad[i] = -1;
-        } else if (distanceToSubChunk > renderDistance * subChunkSize){
-            // The subchunk is far enough away that it should be unloaded so it is not rendered
-            subChunksToLoad[i] = 0;
+    vector<float> chunkWorldCoords = getChunkWorldCoords();
+    glm::vec2 localPosition = glm::vec2(playerPos.x - chunkWorldCoords[0], playerPos.z - chunkWorldCoords[1]);
+    // Walk the quadtree to find the patches that keep the projected error below the threshold
+    float projectionScale = ChunkQuadtree::getProjectionScale(
+        static_cast<float>(settings.getWindowHeight()),
+        fieldOfView
+    );
+    vector<QuadtreeNode> selectedNodes = quadtree->selectNodes(
+        localPosition,
+        static_cast<float>(renderDistance * subChunkSize),
+        projectionScale,
+        settings.getLodPixelError()
+    );
+    for (QuadtreeNode node : selectedNodes){
+        int key = quadtree->getNodeKey(node);
+        if (node.level > 0 || placeholder || settings.getHardwareTessellation()){
+            // Coarse patches and placeholder terrain are meshed at the resolution of their samples,
+            // as is tessellated terrain because it is refined on the GPU as the camera moves
+            nodeStatus[key] = 1;
         } else {
             // We now need to determine the subchunk's resolution based on the distance from the
-            // player to the center of the subchunk where the resolution is settings.getSubChunkResolution()
-            // at the player and decays to 1 at the edge of the render distance
-
-            // If the render distance is 16 then we will be able to see 15 subchunks in each direction
-            // from the player plus the subchunk that the player is in (roughly).
-
-            // Uncomment this to implement our method of LOD
-            // if (distanceToSubChunk < sqrt(2 * pow(subChunkSize * (renderDistance  / 8.0), 2))){
-            //     // The subchunk is within the player's render distance and should be loaded and rendered
-            //     subChunksToLoad[i] = settings.getSubChunkResolution();
-            // } else if (distanceToSubChunk < sqrt(2 * pow(subChunkSize * (renderDistance  / 8.0) * 3.0, 2))){
-            //     // The subchunk is within the player's render distance and should be loaded and rendered
-            //     subChunksToLoad[i] = settings.getSubChunkResolution() * 0.5;
-            // } else if (distanceToSubChunk < sqrt(2 * pow(subChunkSize * (renderDistance  / 8.0) * 5.0, 2))){
-            //     // The subchunk is within the player's render distance and should be loaded and rendered
-            //     subChunksToLoad[i] = settings.getSubChunkResolution() * 0.25;
-            // } else {
-            //     // The subchunk is within the player's render distance and should be loaded and rendered
-            //     subChunksToLoad[i] = 1;
-            // }
-            subChunksToLoad[i] = 2;
+            // player to the closest point of the subchunk, where the resolution is the largest
+            // power of two below settings.getSubChunkResolution() at the player and halves in
+            // each band out to 1 at the edge of the render distance. Using the closest point means
+            // the whole subchunk has already morphed into the coarser level when it switches
+            float closestDistance = quadtree->getDistanceToNode(node, localPosition);
+            nodeStatus[key] = TerrainLod::selectResolution(closestDistance, settings);
         }
-
+        pendingStatus.push_back(make_pair(key, nodeStatus[key]));
     }
-    // We are going to use the centre of the chunk as the reference point for the render distance
-    return subChunksToLoad;
+    // Every resident node that is not selected is unloaded so it is not rendered, and the nodes
+    // that are far enough away are deleted to save memory. The nodes whose subchunks have since
+    // been dropped are taken out of the resident nodes as they go
+    size_t kept = 0;
+    for (int key : residentNodes){
+        if (loadedSubChunks[key] == nullptr && cachedSubChunks[key] == nullptr){
+            residentListed[key] = 0;
+            continue;
+        }
+        residentNodes[kept++] = key;
+        if (nodeStatus[key] != 0){
+            continue;
+        }
+        float distanceToNode = quadtree->getDistanceToNode(quadtree->getNodeFromKey(key), localPosition);
+        pendingStatus.push_back(make_pair(key, distanceToNode > 2 * renderDistance * subChunkSize ? -1 : 0));
+    }
+    residentNodes.resize(kept);
 }
 
 /**
- * @brief This method will be used to determine and update the subchunks that are loaded within the
- * chunk based on the player's position in the world and the render distance.
+ * @brief This method will determine if the subchunks of the chunk need to be re-evaluated
+ *
+ * @details The level of detail and residency of the subchunks only change noticeably once the
+ * player has moved into a different subchunk, as the morphing in the vertex shader smooths over
+ * the movement within a subchunk. The subchunks also need to be re-evaluated whenever one of the
+ * settings that the evaluation depends on changes, in which case the morph ranges of the existing
+ * subchunks are refreshed as well.
  *
  * @param playerPos [in] glm::vec3 The position of the player in world coordinates
- * @param settings [in] Settings The settings object
+ * @param fieldOfView [in] float The vertical field of view of the camera in degrees
+ * @param settings [in] Settings& The settings object
+ *
+ * @returns bool Whether or not the subchunks need to be re-evaluated
+ */
+bool Chunk::needsSubChunkUpdate(glm::vec3 playerPos, float fieldOfView, Settings &settings){
+    glm::ivec2 playerCell = glm::ivec2(
+        static_cast<int>(floor(playerPos.x / static_cast<float>(subChunkSize - 1))),
+        static_cast<int>(floor(playerPos.z / static_cast<float>(subChunkSize - 1)))
+    );
+    SubChunkLodSettings lodSettings;
+    lodSettings.renderDistance = settings.getRenderDistance();
+    lodSettings.subChunkResolution = settings.getSubChunkResolution();
+    lodSettings.windowHeight = settings.getWindowHeight();
+    lodSettings.lodPixelError = settings.getLodPixelError();
+    lodSettings.fieldOfView = fieldOfView;
+    lodSettings.lodMorphRatio = settings.getLodMorphRatio();
+    bool settingsChanged = !subChunksEvaluated || lodSettings != lastLodSettings;
+    if (!settingsChanged && playerCell == lastPlayerCell){
+        return false;
+    }
+    subChunksEvaluated = true;
+    lastPlayerCell = playerCell;
+    lastLodSettings = lodSettings;
+    if (settingsChanged){
+        for (int key : residentNodes){
+            if (loadedSubChunks[key] != nullptr){
+                updateMorphRange(key, loadedSubChunks[key]);
+            }
+            if (cachedSubChunks[key] != nullptr){
+                updateMorphRange(key, cachedSubChunks[key]);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief This method will set the distances over which a subchunk morphs into the next coarser
+ * level of detail
+ *
+ * @details Patches at the heightmap resolution or coarser morph into their parent patch in the
+ * quadtree, while finer subchunks morph into the next distance band. The errors are projected with
+ * the window height and camera field of view that the subchunks were last evaluated with, so this
+ * is called on the main thread once a subchunk has been built.
+ *
+ * @param id [in] int The id of the subchunk
+ * @param subChunk [in] std::shared_ptr<SubChunk> The subchunk
  *
  * @returns void
  */
-void Chunk::updateLoadedSubChunks(glm::vec3 playerPos, Settings settings){
-    // Get the modifications that are required
-    // We need to shift the playerPos by the inverse of the mid point of the chunk to get the
-    // position relative to the rendered world coordinates
-    vector<int> subChunksToLoad = checkRenderDistance(playerPos, settings);
+void Chunk::updateMorphRange(int id, shared_ptr<SubChunk> subChunk){
+    QuadtreeNode node = quadtree->getNodeFromKey(id);
+    if (node.level > 0 || subChunk->getResolution() <= 1.0f){
+        float projectionScale = ChunkQuadtree::getProjectionScale(
+            static_cast<float>(lastLodSettings.windowHeight),
+            lastLodSettings.fieldOfView
+        );
+        subChunk->setMorphRange(quadtree->getMorphRange(
+            node,
+            projectionScale,
+            settings->getLodPixelError(),
+            settings->getLodMorphRatio()
+        ));
+    } else {
+        subChunk->setMorphRange(TerrainLod::getMorphRange(subChunk->getResolution(), *settings));
+    }
+}
+
+/**
+ * @brief This method will queue a batch of subchunks to be built on the mesh workers
+ *
+ * @details Nothing is queued for a subchunk that is already available at the requested resolution
+ * or is already being built at that resolution. A build for a different resolution supersedes any
+ * earlier build of the same subchunk, whose result is discarded when it arrives. The remaining
+ * subchunks are dealt out in turn into one task per worker so that every worker builds whole
+ * subchunks one after another and hands them back together. The tasks only hold the chunk weakly
+ * and stop before the next subchunk once the chunk is gone or retired or the world generation it
+ * belongs to is cancelled, and the workers skip tasks that are cancelled before they start. The
+ * world keeps a retired chunk until hasBuildsInFlight is false, so the chunk is never destroyed on a
+ * worker thread, where it would free its textures off the OpenGL thread.
+ *
+ * @param requests [in] const std::vector<std::pair<int, float>>& The id and resolution of each subchunk to build
+ *
+ * @returns void
+ *
+ */
+void Chunk::requestSubChunkBuilds(const vector<pair<int, float>> &requests){
+    int taskCount = meshWorkers->getThreadCount();
+    vector<vector<pair<int, float>>> tasks = vector<vector<pair<int, float>>>(taskCount);
+    int queued = 0;
+    for (const pair<int, float> &request : requests){
+        int id = request.first;
+        float resolution = request.second;
+        if (isSubChunkReady(id, resolution)){
+            continue;
+        }
+        auto pending = pendingBuilds.find(id);
+        if (pending != pendingBuilds.end() && pending->second == resolution){
+            continue;
+        }
+        pendingBuilds[id] = resolution;
+        if (subChunkCache != nullptr){
+            subChunkCache->recordMiss();
+        }
+        tasks[queued % taskCount].push_back(request);
+        queued++;
+    }
+    weak_ptr<Chunk> weakSelf = shared_from_this();
+    CancellationToken token = buildToken;
+    for (vector<pair<int, float>> &task : tasks){
+        if (task.empty()){
+            continue;
+        }
+        shared_ptr<BuildTicket> ticket = make_shared<BuildTicket>(buildsInFlight);
+        meshWorkers->submit([weakSelf, token, ticket, task]() {
+            vector<shared_ptr<SubChunk>> subChunks;
+            subChunks.reserve(task.size());
+            for (const pair<int, float> &request : task){
+                if (token.isCancelled()){
+                    return;
+                }
+                shared_ptr<Chunk> self = weakSelf.lock();
+                if (self == nullptr || self->isRetired()){
+                    return;
+                }
+                subChunks.push_back(self->buildSubChunk(request.first, request.second));
+            }
+            shared_ptr<Chunk> self = weakSelf.lock();
+            if (self == nullptr || self->isRetired()){
+                return;
+            }
+            lock_guard<mutex> lock(self->builtMutex);
+            self->builtSubChunks.insert(self->builtSubChunks.end(), subChunks.begin(), subChunks.end());
+        }, token);
+    }
+}
+
+/**
+ * @brief This method will upload the subchunks that the mesh workers have finished building
+ *
+ * @details This must be called on the main thread. The finished subchunks are placed in the cache
+ * so that they are picked up the next time the subchunk statuses are applied. They are not tracked
+ * by the subchunk cache as they are about to be drawn, so they can not be demoted or evicted before
+ * then. Results for builds that have since been superseded, or that match the subchunk already
+ * loaded, are discarded without being uploaded, and each result that the pending statuses are
+ * waiting on is counted off the outstanding builds.
+ *
+ * @returns void
+ *
+ */
+void Chunk::collectBuiltSubChunks(){
+    vector<shared_ptr<SubChunk>> finished;
+    {
+        lock_guard<mutex> lock(builtMutex);
+        finished.swap(builtSubChunks);
+    }
+    for (shared_ptr<SubChunk> subChunk : finished){
+        int id = subChunk->getId();
+        auto pending = pendingBuilds.find(id);
+        if (pending == pendingBuilds.end() || pending->second != subChunk->getResolution()){
+            continue;
+        }
+        pendingBuilds.erase(pending);
+        if (hasPendingStatus && static_cast<float>(nodeStatus[id]) == subChunk->getResolution()){
+            outstandingBuilds--;
+        }
+        if (loadedSubChunks[id] == nullptr || loadedSubChunks[id]->getResolution() != subChunk->getResolution()){
+            updateMorphRange(id, subChunk);
+            subChunk->setupData();
+            dropCachedSubChunk(id);
+            cachedSubChunks[id] = subChunk;
+            markResident(id);
+        }
+    }
+}
+
+/**
+ * @brief This method will determine if a subchunk can be loaded without building it
+ *
+ * @param id [in] int The id of the subchunk
+ * @param resolution [in] float The resolution of the subchunk
+ *
+ * @returns bool Whether the subchunk is loaded or cached at the given resolution
+ *
+ */
+bool Chunk::isSubChunkReady(int id, float resolution){
+    return (loadedSubChunks[id] != nullptr && loadedSubChunks[id]->getResolution() == resolution) ||
+        (cachedSubChunks[id] != nullptr && cachedSubChunks[id]->getResolution() == resolution);
+}
+
+/**
+ * @brief This method will load, unload or delete the subchunks according to their statuses
+ *
+ * @param subChunksToLoad [in] const std::vector<std::pair<int, int>>& The node id and status of each subchunk as
+ * written to pendingStatus by checkRenderDistance
+ *
+ * @returns void
+ *
+ */
+void Chunk::applySubChunkStatus(const vector<pair<int, int>> &subChunksToLoad){
     // Check if the vector is empty as that means nothing needs to be loaded and the loaded
-    // subchunks should be empty
+    // subchunks should be empty, only the resident nodes can have a subchunk to remove
     if (subChunksToLoad.size() == 0){
+        // With a subchunk cache the subchunks are kept in the cache until its budgets evict them
+        if (subChunkCache != nullptr){
+            for (int i : residentNodes){
+                unloadSubChunk(i);
+            }
+            return;
+        }
         // We need to ensure that all of the subchunks are unloaded and uncached
-        for (int i = 0; i < static_cast<int>(loadedSubChunks.size()); i++){
+        for (int i : residentNodes){
             if (loadedSubChunks[i] != nullptr){
                 loadedSubChunks[i].reset();
                 loadedSubChunks[i] = nullptr;
@@ -420,12 +858,30 @@ void Chunk::updateLoadedSubChunks(glm::vec3 playerPos, Settings settings){
         }
         return;
     }
+    // Build every subchunk that is missing in one batch and place it in the cache, from where it is
+    // loaded below in the same way as a subchunk built by the mesh workers
+    vector<pair<int, float>> missing;
+    for (const pair<int, int> &status : subChunksToLoad){
+        if (status.second > 0 && !isSubChunkReady(status.first, status.second)){
+            missing.push_back(make_pair(status.first, static_cast<float>(status.second)));
+        }
+    }
+    for (shared_ptr<SubChunk> subChunk : buildSubChunks(missing)){
+        if (subChunkCache != nullptr){
+            subChunkCache->recordMiss();
+        }
+        updateMorphRange(subChunk->getId(), subChunk);
+        subChunk->setupData();
+        dropCachedSubChunk(subChunk->getId());
+        cachedSubChunks[subChunk->getId()] = subChunk;
+        markResident(subChunk->getId());
+    }
     // Iterate through the subchunks and load, unload or delete them based on the modifications
-    for (int i = 0; i < static_cast<int>(subChunksToLoad.size()); i++){
+    for (const pair<int, int> &status : subChunksToLoad){
         // Get the subchunk id
-        int subChunkId = i;
+        int subChunkId = status.first;
         // Get the modification that is required
-        int modification = subChunksToLoad[i];
+        int modification = status.second;
         if (modification == -1){
             // The subchunk needs to be deleted
             deleteSubChunk(subChunkId);
@@ -439,10 +895,70 @@ void Chunk::updateLoadedSubChunks(glm::vec3 playerPos, Settings settings){
     }
 }
 
+/**
+ * @brief This method will be used to determine and update the subchunks that are loaded within the
+ * chunk based on the player's position in the world and the render distance.
+ *
+ * @details This is called every frame but the subchunks are only re-evaluated when the player
+ * crosses into a different subchunk or the settings change. When the chunk has mesh workers the
+ * missing subchunks are built in the background and the new statuses are only applied once all of
+ * them have been uploaded, otherwise they are built on the spot. The builds that are still missing
+ * are counted when they are requested and counted off as they arrive, so the frames spent waiting
+ * on them do not look at the statuses again.
+ *
+ * @param playerPos [in] glm::vec3 The position of the player in world coordinates
+ * @param fieldOfView [in] float The vertical field of view of the camera in degrees
+ * @param settings [in] Settings& The settings object
+ *
+ * @returns void
+ */
+void Chunk::updateLoadedSubChunks(glm::vec3 playerPos, float fieldOfView, Settings &settings){
+    if (meshWorkers != nullptr){
+        collectBuiltSubChunks();
+    }
+    if (needsSubChunkUpdate(playerPos, fieldOfView, settings)){
+        // Get the modifications that are required
+        // We need to shift the playerPos by the inverse of the mid point of the chunk to get the
+        // position relative to the rendered world coordinates
+        checkRenderDistance(playerPos, fieldOfView, settings);
+        hasPendingStatus = true;
+        // Start building the subchunks that are missing so that they are ready ahead of need
+        if (meshWorkers != nullptr){
+            vector<pair<int, float>> requests;
+            for (const pair<int, int> &status : pendingStatus){
+                if (status.second > 0){
+                    requests.push_back(make_pair(status.first, static_cast<float>(status.second)));
+                }
+            }
+            requestSubChunkBuilds(requests);
+            outstandingBuilds = 0;
+            for (const pair<int, float> &request : requests){
+                if (!isSubChunkReady(request.first, request.second)){
+                    outstandingBuilds++;
+                }
+            }
+        }
+    }
+    if (!hasPendingStatus){
+        return;
+    }
+    // The current subchunks keep being drawn until every subchunk that replaces them is ready, so
+    // that no holes appear while the new subchunks are being built. Any subchunk that is still not
+    // ready when they are applied, such as one the cache evicted meanwhile, is built on the spot
+    if (meshWorkers != nullptr && outstandingBuilds > 0){
+        return;
+    }
+    applySubChunkStatus(pendingStatus);
+    hasPendingStatus = false;
+}
+
 /**
  * @brief This method will unload a subchunk from the loadedSubChunks map and move it to the
  * cachedSubChunks map. This is used to save memory when the subchunk is not in use.
  *
+ * @details A cached subchunk that was built ahead of need but is no longer wanted starts being
+ * tracked by the subchunk cache, so that it is subject to the budgets like any other.
+ *
  * @param id [in] int The id of the subchunk to unload
  *
  * @returns void
@@ -451,9 +967,11 @@ void Chunk::unloadSubChunk(int id){
     // Check if the specific index is not nullptr
     if (loadedSubChunks[id] != nullptr){
         // Move the subchunk to the cachedSubChunks vector and delete the subchunk from the loadedSubChunks vector
-        cachedSubChunks[id] = loadedSubChunks[id];
+        cacheSubChunk(id, loadedSubChunks[id]);
         loadedSubChunks[id].reset();
         loadedSubChunks[id] = nullptr;
+    } else if (cachedSubChunks[id] != nullptr && subChunkCache != nullptr && !subChunkCache->contains(this, id)){
+        cacheSubChunk(id, cachedSubChunks[id]);
     }
 }
 
@@ -461,12 +979,19 @@ void Chunk::unloadSubChunk(int id){
  * @brief This method will delete a subchunk from the loadedSubChunks and cachedSubChunks maps.
  * This is used to save memory when the subchunk is not in use.
  *
+ * @details When the chunk has a subchunk cache the subchunk is unloaded into the cache instead, and
+ * the budgets of the cache decide when its memory is freed.
+ *
  * @param id [in] int The id of the subchunk to delete
  *
  * @returns void
  *
  */
 void Chunk::deleteSubChunk(int id){
+    if (subChunkCache != nullptr){
+        unloadSubChunk(id);
+        return;
+    }
     // Check to see if the subchunk is loaded in the loadedSubChunks vector
     if (loadedSubChunks[id] != nullptr){
         // Delete the subchunk from the loadedSubChunks vector
@@ -481,6 +1006,106 @@ void Chunk::deleteSubChunk(int id){
     }
 }
 
+/**
+ * @brief This method will place a subchunk that is no longer drawn in the cachedSubChunks map
+ *
+ * @details Any subchunk already cached under the same id is replaced. When the chunk has a subchunk
+ * cache the subchunk is tracked by it, which demotes the subchunk by freeing its GPU buffers and
+ * evicts it by dropping it from the map as the budgets require.
+ *
+ * @param id [in] int The id of the subchunk
+ * @param subChunk [in] std::shared_ptr<SubChunk> The subchunk
+ *
+ * @returns void
+ *
+ */
+void Chunk::cacheSubChunk(int id, shared_ptr<SubChunk> subChunk){
+    dropCachedSubChunk(id);
+    cachedSubChunks[id] = subChunk;
+    markResident(id);
+    if (subChunkCache == nullptr || !subChunk->isUploaded()){
+        return;
+    }
+    // The callbacks only hold the chunk weakly so the cache does not keep removed chunks alive
+    weak_ptr<Chunk> weakSelf = shared_from_this();
+    subChunkCache->insert(
+        this,
+        id,
+        subChunk->getGpuBytes(),
+        subChunk->getCpuBytes(),
+        [weakSelf, id]() {
+            shared_ptr<Chunk> self = weakSelf.lock();
+            if (self != nullptr && self->cachedSubChunks[id] != nullptr){
+                self->cachedSubChunks[id]->releaseGpuData();
+            }
+        },
+        [weakSelf, id]() {
+            shared_ptr<Chunk> self = weakSelf.lock();
+            if (self != nullptr){
+                self->cachedSubChunks[id].reset();
+            }
+        }
+    );
+}
+
+/**
+ * @brief This method will remove a subchunk from the cachedSubChunks map so that it can be drawn
+ *
+ * @details A subchunk that was demoted to the CPU tier of the subchunk cache is uploaded again from
+ * its packed mesh, so this must be called on the thread that owns the OpenGL context.
+ *
+ * @param id [in] int The id of the subchunk, which must be cached
+ *
+ * @returns std::shared_ptr<SubChunk> The subchunk, ready to be drawn
+ *
+ */
+shared_ptr<SubChunk> Chunk::takeCachedSubChunk(int id){
+    shared_ptr<SubChunk> subChunk = cachedSubChunks[id];
+    cachedSubChunks[id] = nullptr;
+    if (subChunkCache != nullptr){
+        subChunkCache->take(this, id);
+    }
+    if (!subChunk->isUploaded()){
+        subChunk->setupData();
+    }
+    return subChunk;
+}
+
+/**
+ * @brief This method will destroy a cached subchunk and stop the subchunk cache tracking it
+ *
+ * @param id [in] int The id of the subchunk
+ *
+ * @returns void
+ *
+ */
+void Chunk::dropCachedSubChunk(int id){
+    if (subChunkCache != nullptr){
+        subChunkCache->remove(this, id);
+    }
+    cachedSubChunks[id].reset();
+    cachedSubChunks[id] = nullptr;
+}
+
+/**
+ * @brief This method will add a node to the resident nodes once it has a loaded or cached subchunk
+ *
+ * @details A node stays listed until an evaluation finds that its subchunks have been dropped, so
+ * the methods that drop subchunks do not need to update the list.
+ *
+ * @param id [in] int The id of the node
+ *
+ * @returns void
+ *
+ */
+void Chunk::markResident(int id){
+    if (residentListed[id] != 0){
+        return;
+    }
+    residentListed[id] = 1;
+    residentNodes.push_back(id);
+}
+
 /**
  * @brief This method will load all of the subchunks within the chunk. This is used to load all
  * of the subchunks when the chunk is first created.
@@ -503,7 +1128,167 @@ void Chunk::loadAllSubChunks(){
  */
 Chunk::~Chunk()
 {
-    // Nothing to do here
+    if (subChunkCache != nullptr){
+        subChunkCache->removeOwner(this);
+    }
+    // The subchunks point to the shaders, textures and buffer pool of the chunk so they go first
+    loadedSubChunks.clear();
+    cachedSubChunks.clear();
+    builtSubChunks.clear();
+    if (heightTextureID != 0){
+        glDeleteTextures(1, &heightTextureID);
+    }
+    if (normalTextureID != 0){
+        glDeleteTextures(1, &normalTextureID);
+    }
+    if (biomeTextureID != 0){
+        glDeleteTextures(1, &biomeTextureID);
+    }
+}
+
+/**
+ * @brief This method will return the texture holding the heightmap of the chunk
+ *
+ * @details The texture is only needed when the terrain is displaced on the GPU so it is uploaded
+ * the first time it is requested, which must be on the thread that owns the OpenGL context. The
+ * heights are stored as 16 bit normalised values including the border, so texel (x, z) holds
+ * heightmapData[z][x] and is sampled with linear filtering between the heightmap values.
+ *
+ * @returns GLuint The texture id of the heightmap texture
+ *
+ */
+GLuint Chunk::getHeightTexture()
+{
+    if (heightTextureID != 0){
+        return heightTextureID;
+    }
+    int height = static_cast<int>(heightmapData.size());
+    int width = static_cast<int>(heightmapData[0].size());
+    vector<uint16_t> packedHeights = vector<uint16_t>(width * height);
+    #pragma omp parallel for
+    for (int z = 0; z < height; z++){
+        for (int x = 0; x < width; x++){
+            packedHeights[z * width + x] = static_cast<uint16_t>(clamp(heightmapData[z][x], 0.0f, 1.0f) * 65535.0f + 0.5f);
+        }
+    }
+    glGenTextures(1, &heightTextureID);
+    glBindTexture(GL_TEXTURE_2D, heightTextureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16, width, height, 0, GL_RED, GL_UNSIGNED_SHORT, packedHeights.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return heightTextureID;
+}
+
+/**
+ * @brief This method will bake the normal of every heightmap value of the chunk
+ *
+ * @details The normals are found from the central differences of the world heights either side of
+ * each heightmap value, in the same way as the vertex normals of the meshes, falling back to one
+ * sided differences on the outer edge of the border. This is done once at full resolution when the
+ * chunk is ingested so that coarse meshes are still shaded with the detail of the heightmap. Every
+ * terrain normal points upwards, so only the x and z components are kept as signed bytes and the
+ * y component is rebuilt in the shader.
+ *
+ * @returns void
+ *
+ */
+void Chunk::bakeNormalMap()
+{
+    normalMapData.clear();
+    if (!settings->getBakedNormalMaps() || heightmapData.empty()){
+        return;
+    }
+    int height = static_cast<int>(heightmapData.size());
+    int width = static_cast<int>(heightmapData[0].size());
+    float maximumHeight = settings->getMaximumHeight();
+    normalMapData = vector<int8_t>(2 * width * height);
+    #pragma omp parallel for
+    for (int z = 0; z < height; z++){
+        int down = max(z - 1, 0);
+        int up = min(z + 1, height - 1);
+        for (int x = 0; x < width; x++){
+            int left = max(x - 1, 0);
+            int right = min(x + 1, width - 1);
+            float slopeX = (heightmapData[z][right] - heightmapData[z][left]) * maximumHeight / (right - left);
+            float slopeZ = (heightmapData[up][x] - heightmapData[down][x]) * maximumHeight / (up - down);
+            glm::vec3 normal = glm::normalize(glm::vec3(-slopeX, 1.0f, -slopeZ));
+            normalMapData[2 * (z * width + x)] = static_cast<int8_t>(round(normal.x * 127.0f));
+            normalMapData[2 * (z * width + x) + 1] = static_cast<int8_t>(round(normal.z * 127.0f));
+        }
+    }
+}
+
+/**
+ * @brief This method will return the texture holding the baked normals of the chunk
+ *
+ * @details The texture is uploaded the first time it is requested, which must be on the thread
+ * that owns the OpenGL context, and the baked normals are released once they are on the GPU. Like
+ * the heightmap texture it covers the border, so texel (x, z) holds the normal of heightmapData[z][x].
+ *
+ * @returns GLuint The texture id of the normal map texture, zero when the normals are not baked
+ *
+ */
+GLuint Chunk::getNormalTexture()
+{
+    if (normalTextureID != 0 || normalMapData.empty()){
+        return normalTextureID;
+    }
+    int height = static_cast<int>(heightmapData.size());
+    int width = static_cast<int>(heightmapData[0].size());
+    glGenTextures(1, &normalTextureID);
+    glBindTexture(GL_TEXTURE_2D, normalTextureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8_SNORM, width, height, 0, GL_RG, GL_BYTE, normalMapData.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    vector<int8_t>().swap(normalMapData);
+    return normalTextureID;
+}
+
+/**
+ * @brief This method will return the texture holding the biomes of the chunk
+ *
+ * @details A single texture is shared by every subchunk, which reads its part of it from the
+ * texel under its origin, so the chunk only needs one texture object however many subchunks are
+ * loaded. It is uploaded the first time it is requested, which must be on the thread that owns
+ * the OpenGL context. Like the heightmap texture it covers the border, so texel (x, z) holds
+ * biomeData[z][x], and it uses nearest filtering so that the biome ids are not blended.
+ *
+ * @returns GLuint The texture id of the biome map texture
+ *
+ */
+GLuint Chunk::getBiomeTexture()
+{
+    if (biomeTextureID != 0){
+        return biomeTextureID;
+    }
+    int height = static_cast<int>(biomeData.size());
+    int width = static_cast<int>(biomeData[0].size());
+    vector<uint8_t> packedBiomes = vector<uint8_t>(width * height);
+    for (int z = 0; z < height; z++){
+        copy(biomeData[z].begin(), biomeData[z].end(), packedBiomes.begin() + z * width);
+    }
+    glGenTextures(1, &biomeTextureID);
+    glBindTexture(GL_TEXTURE_2D, biomeTextureID);
+    // The rows are tightly packed bytes so they are not aligned to four bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, packedBiomes.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return biomeTextureID;
 }
 
 /**
@@ -530,10 +1315,51 @@ void Chunk::render(
     glm::vec4 plane
 )
 {
-    // Render all of the loaded subchunks
-    for (int i = 0; i < static_cast<int>(loadedSubChunks.size()); i++){
-        if (loadedSubChunks[i] != nullptr){
-            loadedSubChunks[i]->render(
+    // Render all of the loaded subchunks, skipping those hidden behind the horizon in the final pass.
+    // Every loaded subchunk is in a resident node so the other nodes are not visited
+    bool horizonCulling = !isWaterPass && settings->getHorizonCulling();
+    // The heightmap, biome map and normal map are shared by every subchunk so they are bound once
+    // for the whole chunk. The oceans bind their own textures to the same units, so every terrain is
+    // drawn before any ocean
+    int heightMapUnit = Terrain::getHeightMapUnit(terrainTextures.size(), terrainTextureArrays.size());
+    glActiveTexture(GL_TEXTURE0 + heightMapUnit);
+    glBindTexture(GL_TEXTURE_2D, heightTextureID);
+    glActiveTexture(GL_TEXTURE0 + heightMapUnit + 1);
+    glBindTexture(GL_TEXTURE_2D, normalTextureID);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, getBiomeTexture());
+    for (int key : residentNodes){
+        const shared_ptr<SubChunk> &subChunk = loadedSubChunks[key];
+        if (subChunk != nullptr && (!horizonCulling || !subChunk->isOccluded())){
+            subChunk->setFade(fade, fading && fadingOut);
+            subChunk->renderTerrain(
+                view,
+                projection,
+                lights,
+                viewPos,
+                isWaterPass,
+                isShadowPass,
+                plane
+            );
+        }
+    }
+    glActiveTexture(GL_TEXTURE0 + heightMapUnit);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0 + heightMapUnit + 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    // We only want to render the terrain to produce the reflection or refraction buffers
+    if (isWaterPass){
+        return;
+    }
+    // Enable alpha blending for the oceans
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    for (int key : residentNodes){
+        const shared_ptr<SubChunk> &subChunk = loadedSubChunks[key];
+        if (subChunk != nullptr && (!horizonCulling || !subChunk->isOccluded())){
+            subChunk->renderOcean(
                 view,
                 projection,
                 lights,
@@ -544,6 +1370,7 @@ void Chunk::render(
             );
         }
     }
+    glDisable(GL_BLEND);
 }
 
 /**
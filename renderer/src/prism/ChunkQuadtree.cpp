@@ -0,0 +1,351 @@
+/**
+ * @file ChunkQuadtree.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the ChunkQuadtree class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+#include "ChunkQuadtree.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Chunk Quadtree object from a chunk heightmap
+ *
+ * @details The tree has enough levels for its root to cover every subchunk of the chunk. As the
+ * number of subchunks per axis is not usually a power of two the root extends past the far edges
+ * of the chunk.
+ *
+ * @param heightmap [in] const std::vector<std::vector<float>>& The heightmap of the chunk including its border
+ * @param inChunkSize [in] int The number of vertices per axis of the chunk
+ * @param subChunkSize [in] int The number of vertices per axis of a subchunk
+ * @param heightScale [in] float The factor that converts heightmap values into world units
+ *
+ */
+ChunkQuadtree::ChunkQuadtree(
+    const vector<vector<float>> &heightmap,
+    int inChunkSize,
+    int subChunkSize,
+    float heightScale
+):
+    chunkSize(inChunkSize),
+    leafSize(subChunkSize - 1),
+    leavesPerAxis((inChunkSize - 1) / (subChunkSize - 1))
+{
+    levelCount = 1;
+    while ((1 << (levelCount - 1)) < leavesPerAxis){
+        levelCount++;
+    }
+    computeErrors(heightmap, heightScale);
+}
+
+/**
+ * @brief This function will return the height of the heightmap at a chunk local position
+ *
+ * @details Positions outside of the chunk are clamped to its edge. Local position 0 is the first
+ * vertex inside the one vertex border of the heightmap.
+ *
+ * @param heightmap [in] const std::vector<std::vector<float>>& The heightmap of the chunk
+ * @param localX [in] int The x coordinate within the chunk
+ * @param localZ [in] int The z coordinate within the chunk
+ *
+ * @return float The height at the position
+ *
+ */
+float ChunkQuadtree::sampleHeight(const vector<vector<float>> &heightmap, int localX, int localZ) const {
+    int x = clamp(localX, 0, chunkSize - 1) + 1;
+    int z = clamp(localZ, 0, chunkSize - 1) + 1;
+    return heightmap[z][x];
+}
+
+/**
+ * @brief This function will compute the geometric error of every node in the tree
+ *
+ * @details The error introduced by a node is measured at every vertex of its children's patches
+ * that is not also a vertex of the node's patch. The height that the node's patch has at that
+ * vertex is the average of the two neighbouring coarse vertices along the edge it lies on, using
+ * the same diagonal as the index buffer. The error of the children is then added so that the
+ * error of a node bounds the error of everything beneath it.
+ *
+ * @param heightmap [in] const std::vector<std::vector<float>>& The heightmap of the chunk
+ * @param heightScale [in] float The factor that converts heightmap values into world units
+ *
+ * @return void
+ *
+ */
+void ChunkQuadtree::computeErrors(const vector<vector<float>> &heightmap, float heightScale){
+    nodeErrors = vector<vector<float>>(levelCount);
+    // The subchunks are drawn straight from the heightmap so they introduce no error
+    nodeErrors[0] = vector<float>(leavesPerAxis * leavesPerAxis, 0.0f);
+    for (int level = 1; level < levelCount; level++){
+        int nodesPerAxis = getNodesPerAxis(level);
+        int childNodesPerAxis = getNodesPerAxis(level - 1);
+        int span = getNodeSpan(level);
+        int childStride = 1 << (level - 1);
+        nodeErrors[level] = vector<float>(nodesPerAxis * nodesPerAxis, 0.0f);
+        #pragma omp parallel for
+        for (int node = 0; node < nodesPerAxis * nodesPerAxis; node++){
+            int nodeX = node % nodesPerAxis;
+            int nodeZ = node / nodesPerAxis;
+            int originX = nodeX * span;
+            int originZ = nodeZ * span;
+            float error = 0.0f;
+            for (int j = 0; j <= span / childStride; j++){
+                for (int i = 0; i <= span / childStride; i++){
+                    bool oddX = i % 2 == 1;
+                    bool oddZ = j % 2 == 1;
+                    if (!oddX && !oddZ){
+                        continue;
+                    }
+                    int x = originX + i * childStride;
+                    int z = originZ + j * childStride;
+                    float coarseHeight;
+                    if (oddX && oddZ){
+                        coarseHeight = 0.5f * (
+                            sampleHeight(heightmap, x - childStride, z - childStride) +
+                            sampleHeight(heightmap, x + childStride, z + childStride)
+                        );
+                    } else if (oddX){
+                        coarseHeight = 0.5f * (
+                            sampleHeight(heightmap, x - childStride, z) +
+                            sampleHeight(heightmap, x + childStride, z)
+                        );
+                    } else {
+                        coarseHeight = 0.5f * (
+                            sampleHeight(heightmap, x, z - childStride) +
+                            sampleHeight(heightmap, x, z + childStride)
+                        );
+                    }
+                    error = max(error, abs(sampleHeight(heightmap, x, z) - coarseHeight) * heightScale);
+                }
+            }
+            // Accumulate the largest error of the children beneath the node
+            float childError = 0.0f;
+            for (int child = 0; child < 4; child++){
+                int childX = nodeX * 2 + child % 2;
+                int childZ = nodeZ * 2 + child / 2;
+                if (childX < childNodesPerAxis && childZ < childNodesPerAxis){
+                    childError = max(childError, nodeErrors[level - 1][childZ * childNodesPerAxis + childX]);
+                }
+            }
+            nodeErrors[level][node] = error + childError;
+        }
+    }
+}
+
+/**
+ * @brief This function will return the unique key of a node within the chunk
+ *
+ * @details The keys of the subchunk level are the same as the subchunk ids used by the Chunk
+ * class and every level above that is offset by the number of subchunks.
+ *
+ * @param node [in] QuadtreeNode The node
+ *
+ * @return int The key of the node
+ *
+ */
+int ChunkQuadtree::getNodeKey(QuadtreeNode node) const {
+    return node.level * leavesPerAxis * leavesPerAxis + node.z * leavesPerAxis + node.x;
+}
+
+/**
+ * @brief This function will return the node with the given key
+ *
+ * @param key [in] int The key of the node
+ *
+ * @return QuadtreeNode The node
+ *
+ */
+QuadtreeNode ChunkQuadtree::getNodeFromKey(int key) const {
+    int leafCount = leavesPerAxis * leavesPerAxis;
+    int leaf = key % leafCount;
+    return QuadtreeNode{key / leafCount, leaf % leavesPerAxis, leaf / leavesPerAxis};
+}
+
+/**
+ * @brief This function will determine if a node lies completely inside the chunk
+ *
+ * @param node [in] QuadtreeNode The node
+ *
+ * @return bool Whether every subchunk covered by the node exists
+ *
+ */
+bool ChunkQuadtree::isInsideChunk(QuadtreeNode node) const {
+    int span = 1 << node.level;
+    return node.x + span <= leavesPerAxis && node.z + span <= leavesPerAxis;
+}
+
+/**
+ * @brief This function will return the geometric error of a node in world units
+ *
+ * @param node [in] QuadtreeNode The node
+ *
+ * @return float The geometric error of the node
+ *
+ */
+float ChunkQuadtree::getNodeError(QuadtreeNode node) const {
+    int nodesPerAxis = getNodesPerAxis(node.level);
+    return nodeErrors[node.level][(node.z >> node.level) * nodesPerAxis + (node.x >> node.level)];
+}
+
+/**
+ * @brief This function will return the horizontal distance from a position to the closest point of
+ * the part of a node that lies inside the chunk
+ *
+ * @param node [in] QuadtreeNode The node
+ * @param position [in] glm::vec2 The position in chunk local coordinates
+ *
+ * @return float The distance to the node
+ *
+ */
+float ChunkQuadtree::getDistanceToNode(QuadtreeNode node, glm::vec2 position) const {
+    float minX = static_cast<float>(node.x * leafSize);
+    float minZ = static_cast<float>(node.z * leafSize);
+    float maxX = min(minX + getNodeSpan(node.level), static_cast<float>(leavesPerAxis * leafSize));
+    float maxZ = min(minZ + getNodeSpan(node.level), static_cast<float>(leavesPerAxis * leafSize));
+    float closestX = max(minX, min(position.x, maxX));
+    float closestZ = max(minZ, min(position.y, maxZ));
+    return sqrt(pow(position.x - closestX, 2) + pow(position.y - closestZ, 2));
+}
+
+/**
+ * @brief This function will return the distance below which a node has to be refined
+ *
+ * @details The projected size of the error in pixels is error * projectionScale / distance, so the
+ * node is good enough once the distance exceeds error * projectionScale / pixelError.
+ *
+ * @param node [in] QuadtreeNode The node
+ * @param projectionScale [in] float The number of pixels covered by one world unit at unit distance
+ * @param pixelError [in] float The largest error in pixels that is allowed on screen
+ *
+ * @return float The refinement distance of the node
+ *
+ */
+float ChunkQuadtree::getRefineDistance(QuadtreeNode node, float projectionScale, float pixelError) const {
+    return getNodeError(node) * projectionScale / max(pixelError, 0.01f);
+}
+
+/**
+ * @brief This function will return the distances over which a node morphs into its parent
+ *
+ * @details A parent is only drawn once the player is beyond its refinement distance, so the node
+ * finishes morphing at that distance. The morph starts morphRatio of the way back towards the
+ * node's own refinement distance.
+ *
+ * @param node [in] QuadtreeNode The node
+ * @param projectionScale [in] float The number of pixels covered by one world unit at unit distance
+ * @param pixelError [in] float The largest error in pixels that is allowed on screen
+ * @param morphRatio [in] float The fraction of the range over which the node morphs
+ *
+ * @return glm::vec2 The start and end distance of the morph in world units
+ *
+ */
+glm::vec2 ChunkQuadtree::getMorphRange(QuadtreeNode node, float projectionScale, float pixelError, float morphRatio) const {
+    float inner = getRefineDistance(node, projectionScale, pixelError);
+    if (node.level + 1 >= levelCount){
+        // The root has nothing to morph into
+        return glm::vec2(1e30f, 1e30f + 1.0f);
+    }
+    int parentStride = 1 << (node.level + 1);
+    QuadtreeNode parent = QuadtreeNode{node.level + 1, (node.x / parentStride) * parentStride, (node.z / parentStride) * parentStride};
+    float outer = max(getRefineDistance(parent, projectionScale, pixelError), inner + 1.0f);
+    float ratio = clamp(morphRatio, 0.01f, 1.0f);
+    return glm::vec2(outer - ratio * (outer - inner), outer);
+}
+
+/**
+ * @brief This function will refine a node and add the nodes that should be drawn to the selection
+ *
+ * @param level [in] int The level of the node
+ * @param nodeX [in] int The column of the node within its level
+ * @param nodeZ [in] int The row of the node within its level
+ * @param position [in] glm::vec2 The player position in chunk local coordinates
+ * @param maxDistance [in] float The distance beyond which nothing is drawn
+ * @param projectionScale [in] float The number of pixels covered by one world unit at unit distance
+ * @param pixelError [in] float The largest error in pixels that is allowed on screen
+ * @param selected [out] std::vector<QuadtreeNode>& The nodes that should be drawn
+ *
+ * @return void
+ *
+ */
+void ChunkQuadtree::selectNode(
+    int level,
+    int nodeX,
+    int nodeZ,
+    glm::vec2 position,
+    float maxDistance,
+    float projectionScale,
+    float pixelError,
+    vector<QuadtreeNode> &selected
+) const {
+    QuadtreeNode node = QuadtreeNode{level, nodeX << level, nodeZ << level};
+    if (node.x >= leavesPerAxis || node.z >= leavesPerAxis){
+        return;
+    }
+    float distance = getDistanceToNode(node, position);
+    if (distance > maxDistance){
+        return;
+    }
+    if (level == 0 || (isInsideChunk(node) && distance >= getRefineDistance(node, projectionScale, pixelError))){
+        selected.push_back(node);
+        return;
+    }
+    for (int child = 0; child < 4; child++){
+        selectNode(
+            level - 1,
+            nodeX * 2 + child % 2,
+            nodeZ * 2 + child / 2,
+            position,
+            maxDistance,
+            projectionScale,
+            pixelError,
+            selected
+        );
+    }
+}
+
+/**
+ * @brief This function will select the nodes that should be drawn for a player position
+ *
+ * @param position [in] glm::vec2 The player position in chunk local coordinates
+ * @param maxDistance [in] float The distance beyond which nothing is drawn
+ * @param projectionScale [in] float The number of pixels covered by one world unit at unit distance
+ * @param pixelError [in] float The largest error in pixels that is allowed on screen
+ *
+ * @return std::vector<QuadtreeNode> The nodes that should be drawn, which never overlap
+ *
+ */
+vector<QuadtreeNode> ChunkQuadtree::selectNodes(
+    glm::vec2 position,
+    float maxDistance,
+    float projectionScale,
+    float pixelError
+) const {
+    vector<QuadtreeNode> selected;
+    selectNode(levelCount - 1, 0, 0, position, maxDistance, projectionScale, pixelError, selected);
+    return selected;
+}
+
+/**
+ * @brief This function will return the number of pixels covered by one world unit at unit distance
+ *
+ * @param viewportHeight [in] float The height of the viewport in pixels
+ * @param fieldOfView [in] float The vertical field of view in degrees
+ *
+ * @return float The projection scale
+ *
+ */
+float ChunkQuadtree::getProjectionScale(float viewportHeight, float fieldOfView){
+    return viewportHeight / (2.0f * tan(glm::radians(fieldOfView) * 0.5f));
+}
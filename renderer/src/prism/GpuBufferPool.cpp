@@ -0,0 +1,346 @@
+/**
+ * @file GpuBufferPool.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the GpuBufferPool class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <algorithm>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+    #include "/dcs/large/efogahlewem/.local/include/glad/glad.h"
+#else
+    #include <glm/glm.hpp>
+    #include <glad/glad.h>
+#endif
+
+#include "GpuBufferPool.hpp"
+#include "Vertex.hpp"
+#include "TerrainVertex.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Gpu Buffer Pool object
+ *
+ * @param inMaxFreePerSize [in] int The number of unused objects of each size that are kept for
+ * reuse, zero deletes everything as soon as it is released
+ *
+ */
+GpuBufferPool::GpuBufferPool(int inMaxFreePerSize):
+    maxFreePerSize(inMaxFreePerSize),
+    createdCount(0),
+    reusedCount(0)
+{}
+
+/**
+ * @brief Destroy the Gpu Buffer Pool object
+ *
+ * @details The unused meshes are deleted. Anything that is still checked out is
+ * owned by its terrain or ocean and is not touched.
+ *
+ */
+GpuBufferPool::~GpuBufferPool(){
+    for (auto &entry : freeMeshes){
+        for (MeshBuffers &mesh : entry.second){
+            glDeleteVertexArrays(1, &mesh.VAO);
+            glDeleteBuffers(1, &mesh.VBO);
+            if (mesh.EBO != 0){
+                glDeleteBuffers(1, &mesh.EBO);
+            }
+        }
+    }
+    for (auto &entry : sharedMeshes){
+        glDeleteVertexArrays(1, &entry.second.second.VAO);
+        glDeleteBuffers(1, &entry.second.second.VBO);
+    }
+    for (auto &entry : sharedIndexBuffers){
+        glDeleteBuffers(1, &entry.second.buffer);
+    }
+}
+
+/**
+ * @brief This function will return the number of unused meshes held by the pool
+ *
+ * @return int The number of unused meshes
+ *
+ */
+int GpuBufferPool::getFreeMeshCount(){
+    int count = 0;
+    for (auto &entry : freeMeshes){
+        count += static_cast<int>(entry.second.size());
+    }
+    return count;
+}
+
+/**
+ * @brief This function will check out a mesh with storage of the given sizes
+ *
+ * @details A released mesh of the same size is reused when there is one. Otherwise the vertex
+ * array and buffers are created, the storage is allocated without any data and the attribute
+ * pointers are set for the requested layout. No element buffer is created when the index size is
+ * zero, the mesh is then expected to use a shared index buffer.
+ *
+ * @param vertexBytes [in] size_t The size of the vertex buffer in bytes
+ * @param indexBytes [in] size_t The size of the element buffer in bytes, zero for none
+ * @param layout [in] VertexLayout The layout of the vertices
+ *
+ * @return MeshBuffers The vertex array and buffers of the mesh
+ *
+ */
+MeshBuffers GpuBufferPool::acquireMesh(size_t vertexBytes, size_t indexBytes, VertexLayout layout){
+    vector<MeshBuffers> &available = freeMeshes[make_tuple(layout, vertexBytes, indexBytes)];
+    if (!available.empty()){
+        MeshBuffers mesh = available.back();
+        available.pop_back();
+        reusedCount++;
+        return mesh;
+    }
+    MeshBuffers mesh;
+    mesh.vertexBytes = vertexBytes;
+    mesh.indexBytes = indexBytes;
+    mesh.layout = layout;
+    glGenVertexArrays(1, &mesh.VAO);
+    glGenBuffers(1, &mesh.VBO);
+
+    glBindVertexArray(mesh.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, nullptr, GL_STATIC_DRAW);
+    if (indexBytes > 0){
+        glGenBuffers(1, &mesh.EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, nullptr, GL_STATIC_DRAW);
+    }
+
+    if (layout == VertexLayout::COMPACT_TERRAIN){
+        // Grid indices, which are converted to floats without normalising
+        glVertexAttribPointer(0, 2, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(TerrainVertex), (void*)0);
+        glEnableVertexAttribArray(0);
+        // Height and morph target height as fractions of the height range of the mesh
+        glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(TerrainVertex), (void*)(2 * sizeof(uint16_t)));
+        glEnableVertexAttribArray(1);
+        // Octahedral normal
+        glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, sizeof(TerrainVertex), (void*)(4 * sizeof(uint16_t)));
+        glEnableVertexAttribArray(2);
+    } else {
+        // Position
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        glEnableVertexAttribArray(0);
+        // Normal
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3)));
+        glEnableVertexAttribArray(1);
+        // Texture coordinates
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(2 * sizeof(glm::vec3)));
+        glEnableVertexAttribArray(2);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    createdCount++;
+    return mesh;
+}
+
+/**
+ * @brief This function will overwrite the contents of a checked out mesh
+ *
+ * @param mesh [in] const MeshBuffers& The mesh to write to
+ * @param vertices [in] const std::vector<Vertex>& The vertices, which must fill the vertex storage
+ * @param indices [in] const std::vector<unsigned int>& The indices, which must fill the index
+ * storage and are ignored when the mesh has no element buffer of its own
+ *
+ * @return void
+ *
+ */
+void GpuBufferPool::uploadMesh(const MeshBuffers &mesh, const vector<Vertex> &vertices, const vector<unsigned int> &indices){
+    uploadBuffers(mesh, vertices.data(), indices.data());
+}
+
+/**
+ * @brief This function will overwrite the vertices of a checked out compact terrain mesh
+ *
+ * @param mesh [in] const MeshBuffers& The mesh to write to, which must use a shared index buffer
+ * @param vertices [in] const std::vector<TerrainVertex>& The vertices, which must fill the vertex storage
+ *
+ * @return void
+ *
+ */
+void GpuBufferPool::uploadMesh(const MeshBuffers &mesh, const vector<TerrainVertex> &vertices){
+    uploadBuffers(mesh, vertices.data(), nullptr);
+}
+
+/**
+ * @brief This function will overwrite a checked out compact terrain mesh with its own 16 bit indices
+ *
+ * @param mesh [in] const MeshBuffers& The mesh to write to
+ * @param vertices [in] const std::vector<TerrainVertex>& The vertices, which must fill the vertex storage
+ * @param indices [in] const std::vector<uint16_t>& The indices, which must fill the index storage
+ *
+ * @return void
+ *
+ */
+void GpuBufferPool::uploadMesh(const MeshBuffers &mesh, const vector<TerrainVertex> &vertices, const vector<uint16_t> &indices){
+    uploadBuffers(mesh, vertices.data(), indices.data());
+}
+
+/**
+ * @brief This function will overwrite a checked out compact terrain mesh with its own 32 bit indices
+ *
+ * @param mesh [in] const MeshBuffers& The mesh to write to
+ * @param vertices [in] const std::vector<TerrainVertex>& The vertices, which must fill the vertex storage
+ * @param indices [in] const std::vector<unsigned int>& The indices, which must fill the index storage
+ *
+ * @return void
+ *
+ */
+void GpuBufferPool::uploadMesh(const MeshBuffers &mesh, const vector<TerrainVertex> &vertices, const vector<unsigned int> &indices){
+    uploadBuffers(mesh, vertices.data(), indices.data());
+}
+
+/**
+ * @brief This function will overwrite the storage of a checked out mesh with raw data
+ *
+ * @param mesh [in] const MeshBuffers& The mesh to write to
+ * @param vertexData [in] const void* The vertex data, which must fill the vertex storage
+ * @param indexData [in] const void* The index data, which is ignored when the mesh has no element
+ * buffer of its own
+ *
+ * @return void
+ *
+ */
+void GpuBufferPool::uploadBuffers(const MeshBuffers &mesh, const void *vertexData, const void *indexData){
+    // The element buffer binding is part of the vertex array state so the vertex array has to be
+    // bound to write to it
+    glBindVertexArray(mesh.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, mesh.vertexBytes, vertexData);
+    if (mesh.EBO != 0 && indexData != nullptr){
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, mesh.indexBytes, indexData);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ * @brief This function will return a mesh to the pool
+ *
+ * @details The mesh is deleted if the pool already holds the maximum number of unused meshes of
+ * its size.
+ *
+ * @param mesh [in] const MeshBuffers& The mesh to return
+ *
+ * @return void
+ *
+ */
+void GpuBufferPool::releaseMesh(const MeshBuffers &mesh){
+    if (mesh.VAO == 0){
+        return;
+    }
+    vector<MeshBuffers> &available = freeMeshes[make_tuple(mesh.layout, mesh.vertexBytes, mesh.indexBytes)];
+    if (static_cast<int>(available.size()) < maxFreePerSize){
+        available.push_back(mesh);
+        return;
+    }
+    glDeleteVertexArrays(1, &mesh.VAO);
+    glDeleteBuffers(1, &mesh.VBO);
+    if (mesh.EBO != 0){
+        glDeleteBuffers(1, &mesh.EBO);
+    }
+}
+
+/**
+ * @brief This function will return the element buffer holding a shared index buffer
+ *
+ * @details The index buffer is uploaded the first time it is requested and the same element
+ * buffer is returned for every later request with the same CPU copy. The indices are narrowed to
+ * 16 bits when they all fit.
+ *
+ * @param indices [in] std::shared_ptr<const std::vector<unsigned int>> The shared index buffer
+ *
+ * @return GLuint The element buffer
+ *
+ */
+GLuint GpuBufferPool::getSharedIndexBuffer(shared_ptr<const vector<unsigned int>> indices){
+    auto shared = sharedIndexBuffers.find(indices.get());
+    if (shared != sharedIndexBuffers.end()){
+        return shared->second.buffer;
+    }
+    SharedIndexBuffer entry;
+    entry.indices = indices;
+    glGenBuffers(1, &entry.buffer);
+    // Bind to the copy target so that the element buffer binding of the current vertex array is
+    // not disturbed
+    glBindBuffer(GL_COPY_WRITE_BUFFER, entry.buffer);
+    unsigned int largestIndex = indices->empty() ? 0 : *max_element(indices->begin(), indices->end());
+    if (largestIndex <= 0xFFFF){
+        vector<uint16_t> narrowIndices = vector<uint16_t>(indices->begin(), indices->end());
+        glBufferData(GL_COPY_WRITE_BUFFER, narrowIndices.size() * sizeof(uint16_t), narrowIndices.data(), GL_STATIC_DRAW);
+        entry.type = GL_UNSIGNED_SHORT;
+    } else {
+        glBufferData(GL_COPY_WRITE_BUFFER, indices->size() * sizeof(unsigned int), indices->data(), GL_STATIC_DRAW);
+        entry.type = GL_UNSIGNED_INT;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    sharedIndexBuffers[indices.get()] = entry;
+    return entry.buffer;
+}
+
+/**
+ * @brief This function will return the type of the indices in a shared index buffer
+ *
+ * @param indices [in] std::shared_ptr<const std::vector<unsigned int>> The shared index buffer
+ *
+ * @return GLenum GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, to be passed to glDrawElements
+ *
+ */
+GLenum GpuBufferPool::getSharedIndexType(shared_ptr<const vector<unsigned int>> indices){
+    getSharedIndexBuffer(indices);
+    return sharedIndexBuffers[indices.get()].type;
+}
+
+/**
+ * @brief This function will make a mesh draw with the given element buffer
+ *
+ * @param mesh [in] const MeshBuffers& The mesh, which must not have an element buffer of its own
+ * @param indexBuffer [in] GLuint The element buffer to draw with
+ *
+ * @return void
+ *
+ */
+void GpuBufferPool::attachIndexBuffer(const MeshBuffers &mesh, GLuint indexBuffer){
+    glBindVertexArray(mesh.VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBindVertexArray(0);
+}
+
+/**
+ * @brief This function will return a mesh that is shared by many objects
+ *
+ * @details The mesh is uploaded the first time it is requested and draws with the shared copy of
+ * its index buffer. The returned mesh belongs to the pool and must not be released.
+ *
+ * @param vertices [in] std::shared_ptr<const std::vector<Vertex>> The shared vertices
+ * @param indices [in] std::shared_ptr<const std::vector<unsigned int>> The shared index buffer
+ *
+ * @return MeshBuffers The vertex array and vertex buffer of the mesh
+ *
+ */
+MeshBuffers GpuBufferPool::getSharedMesh(shared_ptr<const vector<Vertex>> vertices, shared_ptr<const vector<unsigned int>> indices){
+    auto shared = sharedMeshes.find(vertices.get());
+    if (shared != sharedMeshes.end()){
+        return shared->second.second;
+    }
+    MeshBuffers mesh = acquireMesh(vertices->size() * sizeof(Vertex), 0);
+    uploadMesh(mesh, *vertices, vector<unsigned int>());
+    attachIndexBuffer(mesh, getSharedIndexBuffer(indices));
+    sharedMeshes[vertices.get()] = make_pair(vertices, mesh);
+    return mesh;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file HeightPyramid.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the HeightPyramid class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <omp.h>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+#include "HeightPyramid.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new HeightPyramid object from a heightmap
+ *
+ * @details The tiles along the far edges of the heightmap may be smaller than the others when its
+ * size is not a multiple of the tile size, and each level halves the number of tiles rounding up.
+ *
+ * @param heightmap [in] const std::vector<std::vector<float>>& The heightmap indexed by [z][x]
+ *
+ */
+HeightPyramid::HeightPyramid(const vector<vector<float>> &heightmap):
+    width(heightmap.empty() ? 0 : static_cast<int>(heightmap[0].size())),
+    height(static_cast<int>(heightmap.size()))
+{
+    int tilesX = max(1, (width + TILE_SIZE - 1) / TILE_SIZE);
+    int tilesZ = max(1, (height + TILE_SIZE - 1) / TILE_SIZE);
+    tilesPerAxisX.push_back(tilesX);
+    tilesPerAxisZ.push_back(tilesZ);
+    levels.push_back(vector<glm::vec2>(tilesX * tilesZ, glm::vec2(0.0f, 0.0f)));
+    #pragma omp parallel for
+    for (int tileZ = 0; tileZ < tilesZ; tileZ++){
+        for (int tileX = 0; tileX < tilesX; tileX++){
+            glm::vec2 bounds = glm::vec2(numeric_limits<float>::infinity(), -numeric_limits<float>::infinity());
+            for (int z = tileZ * TILE_SIZE; z < min((tileZ + 1) * TILE_SIZE, height); z++){
+                for (int x = tileX * TILE_SIZE; x < min((tileX + 1) * TILE_SIZE, width); x++){
+                    bounds.x = min(bounds.x, heightmap[z][x]);
+                    bounds.y = max(bounds.y, heightmap[z][x]);
+                }
+            }
+            if (bounds.x <= bounds.y){
+                levels[0][tileZ * tilesX + tileX] = bounds;
+            }
+        }
+    }
+    // Merge 2x2 tiles of each level into the level above until one tile covers the heightmap
+    while (tilesX > 1 || tilesZ > 1){
+        int childTilesX = tilesX;
+        int childTilesZ = tilesZ;
+        tilesX = (tilesX + 1) / 2;
+        tilesZ = (tilesZ + 1) / 2;
+        const vector<glm::vec2> &children = levels.back();
+        vector<glm::vec2> parents = vector<glm::vec2>(tilesX * tilesZ);
+        for (int tileZ = 0; tileZ < tilesZ; tileZ++){
+            for (int tileX = 0; tileX < tilesX; tileX++){
+                glm::vec2 bounds = children[(tileZ * 2) * childTilesX + tileX * 2];
+                for (int child = 1; child < 4; child++){
+                    int childX = tileX * 2 + child % 2;
+                    int childZ = tileZ * 2 + child / 2;
+                    if (childX < childTilesX && childZ < childTilesZ){
+                        glm::vec2 childBounds = children[childZ * childTilesX + childX];
+                        bounds.x = min(bounds.x, childBounds.x);
+                        bounds.y = max(bounds.y, childBounds.y);
+                    }
+                }
+                parents[tileZ * tilesX + tileX] = bounds;
+            }
+        }
+        tilesPerAxisX.push_back(tilesX);
+        tilesPerAxisZ.push_back(tilesZ);
+        levels.push_back(parents);
+    }
+}
+
+/**
+ * @brief This function will return the bounds of a single tile
+ *
+ * @param level [in] int The level of the tile where 0 is the 8x8 tiles
+ * @param tileX [in] int The column of the tile
+ * @param tileZ [in] int The row of the tile
+ *
+ * @return glm::vec2 The lowest and highest height within the tile
+ *
+ */
+glm::vec2 HeightPyramid::getTileBounds(int level, int tileX, int tileZ) const{
+    return levels[level][tileZ * tilesPerAxisX[level] + tileX];
+}
+
+/**
+ * @brief This function will return the bounds of the whole heightmap
+ *
+ * @return glm::vec2 The lowest and highest height of the heightmap
+ *
+ */
+glm::vec2 HeightPyramid::getBounds() const{
+    return levels.back()[0];
+}
+
+/**
+ * @brief This function will return conservative bounds of a rectangle of the heightmap
+ *
+ * @param minX [in] int The first column of the rectangle
+ * @param minZ [in] int The first row of the rectangle
+ * @param maxX [in] int The last column of the rectangle
+ * @param maxZ [in] int The last row of the rectangle
+ *
+ * @return glm::vec2 Bounds that contain every height within the rectangle, or an inverted range
+ * when the rectangle does not overlap the heightmap
+ *
+ */
+glm::vec2 HeightPyramid::getBounds(int minX, int minZ, int maxX, int maxZ) const{
+    glm::vec2 bounds = glm::vec2(numeric_limits<float>::infinity(), -numeric_limits<float>::infinity());
+    int top = getLevelCount() - 1;
+    queryTile(nullptr, top, 0, 0, max(minX, 0), max(minZ, 0), min(maxX, width - 1), min(maxZ, height - 1), bounds);
+    return bounds;
+}
+
+/**
+ * @brief This function will return the exact bounds of a rectangle of the heightmap
+ *
+ * @param heightmap [in] const std::vector<std::vector<float>>& The heightmap the pyramid was built from
+ * @param minX [in] int The first column of the rectangle
+ * @param minZ [in] int The first row of the rectangle
+ * @param maxX [in] int The last column of the rectangle
+ * @param maxZ [in] int The last row of the rectangle
+ *
+ * @return glm::vec2 The lowest and highest height within the rectangle, or an inverted range when
+ * the rectangle does not overlap the heightmap
+ *
+ */
+glm::vec2 HeightPyramid::getBounds(const vector<vector<float>> &heightmap, int minX, int minZ, int maxX, int maxZ) const{
+    glm::vec2 bounds = glm::vec2(numeric_limits<float>::infinity(), -numeric_limits<float>::infinity());
+    int top = getLevelCount() - 1;
+    queryTile(&heightmap, top, 0, 0, max(minX, 0), max(minZ, 0), min(maxX, width - 1), min(maxZ, height - 1), bounds);
+    return bounds;
+}
+
+/**
+ * @brief This function will merge the heights of a tile that lie within a rectangle into the bounds
+ *
+ * @details Tiles outside the rectangle and tiles whose bounds can not widen the current bounds are
+ * skipped, and tiles inside the rectangle are merged whole. Tiles on the edge of the rectangle are
+ * split into their children, or scanned when they are on the first level and the heightmap is
+ * given.
+ *
+ * @param heightmap [in] const std::vector<std::vector<float>>* The heightmap, or null to use the tile bounds
+ * @param level [in] int The level of the tile
+ * @param tileX [in] int The column of the tile
+ * @param tileZ [in] int The row of the tile
+ * @param minX [in] int The first column of the rectangle
+ * @param minZ [in] int The first row of the rectangle
+ * @param maxX [in] int The last column of the rectangle
+ * @param maxZ [in] int The last row of the rectangle
+ * @param bounds [in/out] glm::vec2& The bounds found so far
+ *
+ * @return void
+ *
+ */
+void HeightPyramid::queryTile(
+    const vector<vector<float>> *heightmap,
+    int level,
+    int tileX,
+    int tileZ,
+    int minX,
+    int minZ,
+    int maxX,
+    int maxZ,
+    glm::vec2 &bounds
+) const{
+    if (tileX >= tilesPerAxisX[level] || tileZ >= tilesPerAxisZ[level]){
+        return;
+    }
+    int span = TILE_SIZE << level;
+    int tileMinX = tileX * span;
+    int tileMinZ = tileZ * span;
+    int tileMaxX = min(tileMinX + span, width) - 1;
+    int tileMaxZ = min(tileMinZ + span, height) - 1;
+    if (tileMinX > maxX || tileMaxX < minX || tileMinZ > maxZ || tileMaxZ < minZ){
+        return;
+    }
+    glm::vec2 tileBounds = getTileBounds(level, tileX, tileZ);
+    if (tileBounds.x >= bounds.x && tileBounds.y <= bounds.y){
+        return;
+    }
+    bool inside = tileMinX >= minX && tileMaxX <= maxX && tileMinZ >= minZ && tileMaxZ <= maxZ;
+    if (inside || (level == 0 && heightmap == nullptr)){
+        bounds.x = min(bounds.x, tileBounds.x);
+        bounds.y = max(bounds.y, tileBounds.y);
+        return;
+    }
+    if (level == 0){
+        for (int z = max(tileMinZ, minZ); z <= min(tileMaxZ, maxZ); z++){
+            for (int x = max(tileMinX, minX); x <= min(tileMaxX, maxX); x++){
+                bounds.x = min(bounds.x, (*heightmap)[z][x]);
+                bounds.y = max(bounds.y, (*heightmap)[z][x]);
+            }
+        }
+        return;
+    }
+    for (int child = 0; child < 4; child++){
+        queryTile(heightmap, level - 1, tileX * 2 + child % 2, tileZ * 2 + child / 2, minX, minZ, maxX, maxZ, bounds);
+    }
+}
@@ -0,0 +1,237 @@
+/**
+ * @file HeightUpsampler.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the HeightUpsampler class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "HeightUpsampler.hpp"
+
+using namespace std;
+
+/**
+ * @brief This function will compute the Catmull-Rom weights for every fraction used by a factor
+ *
+ * @details The weights of phase p are for the fraction t = p / factor between the second and third
+ * of four heights, and are the expanded form of Utility::cubic_interpolation.
+ *
+ * @param factor [in] int The upsampling factor
+ *
+ * @return std::vector<float> Four weights for each phase, indexed by phase * 4 + k
+ *
+ */
+vector<float> HeightUpsampler::computeWeights(int factor){
+    vector<float> weights = vector<float>(factor * 4);
+    computeWeights(factor, weights.data());
+    return weights;
+}
+
+/**
+ * @brief This function will compute the Catmull-Rom weights for every fraction used by a factor
+ * into existing storage
+ *
+ * @param factor [in] int The upsampling factor
+ * @param weights [out] float* Storage for four weights for each phase, indexed by phase * 4 + k
+ *
+ * @return void
+ *
+ */
+void HeightUpsampler::computeWeights(int factor, float *weights){
+    for (int phase = 0; phase < factor; phase++){
+        computeFractionWeights(static_cast<float>(phase) / static_cast<float>(factor), weights + phase * 4);
+    }
+}
+
+/**
+ * @brief This function will compute the four Catmull-Rom weights of a single fraction
+ *
+ * @param t [in] float The fraction between the second and third of four heights
+ * @param weights [out] float* Storage for the four weights
+ *
+ * @return void
+ *
+ */
+void HeightUpsampler::computeFractionWeights(float t, float *weights){
+    float t2 = t * t;
+    float t3 = t2 * t;
+    weights[0] = 0.5f * (-t3 + 2.0f * t2 - t);
+    weights[1] = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+    weights[2] = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+    weights[3] = 0.5f * (t3 - t2);
+}
+
+/**
+ * @brief This function will return the number of floats of scratch storage an upsample needs
+ *
+ * @param width [in] int The number of heights along x
+ * @param height [in] int The number of heights along z
+ * @param factor [in] int The upsampling factor
+ *
+ * @return size_t The number of floats to pass as the scratch storage
+ *
+ */
+size_t HeightUpsampler::getScratchSize(int width, int height, int factor){
+    return static_cast<size_t>(width) * factor * height + (width + 3) + factor * 4;
+}
+
+/**
+ * @brief This function will upsample a block of heights into a new vector
+ *
+ * @param heights [in] const HeightView& The heights to upsample
+ * @param factor [in] int The upsampling factor, at least 1
+ *
+ * @return std::vector<float> The upsampled heights stored row by row
+ *
+ */
+vector<float> HeightUpsampler::upsample(const HeightView &heights, int factor){
+    vector<float> output = vector<float>(heights.width * factor * heights.height * factor);
+    vector<float> scratch = vector<float>(getScratchSize(heights.width, heights.height, factor));
+    upsample(heights, factor, output.data(), scratch.data());
+    return output;
+}
+
+/**
+ * @brief This function will upsample a block of heights into existing storage
+ *
+ * @details Blocks of the size a subchunk is built from, at the factors of the shipped subchunk
+ * resolutions, are handed to a copy of the kernel compiled for that size and factor. Every other
+ * block uses the copy that reads them at run time.
+ *
+ * @param heights [in] const HeightView& The heights to upsample
+ * @param factor [in] int The upsampling factor, at least 1
+ * @param output [out] float* Storage for width * factor x height * factor heights stored row by row
+ * @param scratch [out] float* Storage for getScratchSize floats used while upsampling
+ *
+ * @return void
+ *
+ */
+void HeightUpsampler::upsample(const HeightView &heights, int factor, float *output, float *scratch){
+    if (heights.width == SPECIALISED_SIZE && heights.height == SPECIALISED_SIZE){
+        switch (factor){
+            case 1:
+                upsampleBlock<SPECIALISED_SIZE, 1>(heights, factor, output, scratch);
+                return;
+            case 2:
+                upsampleBlock<SPECIALISED_SIZE, 2>(heights, factor, output, scratch);
+                return;
+            case 4:
+                upsampleBlock<SPECIALISED_SIZE, 4>(heights, factor, output, scratch);
+                return;
+            default:
+                break;
+        }
+    }
+    upsampleBlock<0, 0>(heights, factor, output, scratch);
+}
+
+/**
+ * @brief This function is the kernel that upsamples a block of heights
+ *
+ * @details The first pass upsamples every row of the block along x into the scratch, reading each
+ * row through a copy padded with its edge heights so the inner loop needs no clamping. The second
+ * pass blends four of those rows for every output row, so both inner loops run over contiguous
+ * floats with the same four weights and are vectorised. When the size and factor are fixed at
+ * compile time every trip count is a constant, so the compiler can unroll the loops over the
+ * phases and vectorise the loops along a row without a remainder.
+ *
+ * @tparam FIXED_SIZE The width and height of the block, or 0 to read them from the view
+ * @tparam FIXED_FACTOR The upsampling factor, or 0 to use the factor argument
+ *
+ * @param heights [in] const HeightView& The heights to upsample
+ * @param factor [in] int The upsampling factor, at least 1
+ * @param output [out] float* Storage for width * factor x height * factor heights stored row by row
+ * @param scratch [out] float* Storage for getScratchSize floats used while upsampling
+ *
+ * @return void
+ *
+ */
+template <int FIXED_SIZE, int FIXED_FACTOR>
+void HeightUpsampler::upsampleBlock(const HeightView &heights, int factor, float *output, float *scratch){
+    const int width = FIXED_SIZE > 0 ? FIXED_SIZE : heights.width;
+    const int height = FIXED_SIZE > 0 ? FIXED_SIZE : heights.height;
+    const int blockFactor = FIXED_FACTOR > 0 ? FIXED_FACTOR : factor;
+    const int outputWidth = width * blockFactor;
+    float *rowPass = scratch;
+    float *paddedRow = rowPass + static_cast<size_t>(outputWidth) * height;
+    float *weights = paddedRow + width + 3;
+    computeWeights(blockFactor, weights);
+
+    // Upsample each row along x
+    for (int z = 0; z < height; z++){
+        paddedRow[0] = heights.at(0, z);
+        for (int x = 0; x < width; x++){
+            paddedRow[x + 1] = heights.at(x, z);
+        }
+        paddedRow[width + 1] = heights.at(width - 1, z);
+        paddedRow[width + 2] = heights.at(width - 1, z);
+        float *row = &rowPass[static_cast<size_t>(z) * outputWidth];
+        const float *padded = paddedRow;
+        for (int phase = 0; phase < blockFactor; phase++){
+            float w0 = weights[phase * 4 + 0];
+            float w1 = weights[phase * 4 + 1];
+            float w2 = weights[phase * 4 + 2];
+            float w3 = weights[phase * 4 + 3];
+            #pragma omp simd
+            for (int x = 0; x < width; x++){
+                row[x * blockFactor + phase] = w0 * padded[x] + w1 * padded[x + 1] + w2 * padded[x + 2] + w3 * padded[x + 3];
+            }
+        }
+    }
+
+    // Blend the upsampled rows along z
+    for (int z = 0; z < height; z++){
+        const float *row0 = &rowPass[static_cast<size_t>(max(z - 1, 0)) * outputWidth];
+        const float *row1 = &rowPass[static_cast<size_t>(z) * outputWidth];
+        const float *row2 = &rowPass[static_cast<size_t>(min(z + 1, height - 1)) * outputWidth];
+        const float *row3 = &rowPass[static_cast<size_t>(min(z + 2, height - 1)) * outputWidth];
+        for (int phase = 0; phase < blockFactor; phase++){
+            float w0 = weights[phase * 4 + 0];
+            float w1 = weights[phase * 4 + 1];
+            float w2 = weights[phase * 4 + 2];
+            float w3 = weights[phase * 4 + 3];
+            float *out = &output[static_cast<size_t>(z * blockFactor + phase) * outputWidth];
+            #pragma omp simd
+            for (int x = 0; x < outputWidth; x++){
+                out[x] = w0 * row0[x] + w1 * row1[x] + w2 * row2[x] + w3 * row3[x];
+            }
+        }
+    }
+}
+
+/**
+ * @brief This function will interpolate a single height of a block
+ *
+ * @details This is used for the resolutions that are not whole numbers, where every vertex falls at a
+ * different fraction of the way between the heights. The heights are clamped to the edges of the block
+ * in the same way as upsample.
+ *
+ * @param heights [in] const HeightView& The block of heights
+ * @param x [in] float The position along x in heights
+ * @param z [in] float The position along z in heights
+ *
+ * @return float The interpolated height
+ *
+ */
+float HeightUpsampler::sample(const HeightView &heights, float x, float z){
+    int baseX = static_cast<int>(x);
+    int baseZ = static_cast<int>(z);
+    float weightsX[4];
+    float weightsZ[4];
+    computeFractionWeights(x - baseX, weightsX);
+    computeFractionWeights(z - baseZ, weightsZ);
+    float result = 0.0f;
+    for (int j = 0; j < 4; j++){
+        int rowZ = max(0, min(heights.height - 1, baseZ + j - 1));
+        float row = 0.0f;
+        for (int i = 0; i < 4; i++){
+            row += weightsX[i] * heights.at(max(0, min(heights.width - 1, baseX + i - 1)), rowZ);
+        }
+        result += weightsZ[j] * row;
+    }
+    return result;
+}
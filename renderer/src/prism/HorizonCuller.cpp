@@ -0,0 +1,170 @@
+/**
+ * @file HorizonCuller.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the HorizonCuller class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <vector>
+#include <functional>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+#include "HorizonCuller.hpp"
+
+using namespace std;
+
+namespace {
+    const float PI = 3.14159265358979f;
+
+    /**
+     * @brief This function will return the slope from the camera to a height over a range of distances
+     *
+     * @details A point above the camera is steepest at the closest distance and flattest at the
+     * farthest, and the other way around for a point below the camera.
+     *
+     */
+    float getSlope(float height, float minDistance, float maxDistance, bool steepest){
+        bool useClosest = (height >= 0.0f) == steepest;
+        return height / (useClosest ? minDistance : maxDistance);
+    }
+}
+
+/**
+ * @brief Construct a new HorizonCuller object
+ *
+ * @param inBinCount [in] int The number of azimuth bins around the camera
+ *
+ */
+HorizonCuller::HorizonCuller(int inBinCount):
+    binCount(max(1, inBinCount)),
+    horizon(max(1, inBinCount), -numeric_limits<float>::infinity()),
+    culledCount(0)
+{
+}
+
+/**
+ * @brief This function will find the range of azimuth bins that a subchunk covers
+ *
+ * @details The angles of the corners are measured relative to the direction of the centre of the
+ * subchunk, which never spans more than half a turn when the camera is outside of it, and are then
+ * converted into continuous bin coordinates that may extend past either end of the ring.
+ *
+ * @param bounds [in] const HorizonBounds& The bounds of the subchunk
+ * @param viewPos [in] glm::vec2 The position of the camera on the ground plane
+ * @param start [out] float& The bin coordinate of the first edge of the subchunk
+ * @param end [out] float& The bin coordinate of the last edge of the subchunk
+ *
+ * @return void
+ *
+ */
+void HorizonCuller::getAngularSpan(const HorizonBounds &bounds, glm::vec2 viewPos, float &start, float &end) const{
+    float centreAngle = atan2(
+        (bounds.minZ + bounds.maxZ) * 0.5f - viewPos.y,
+        (bounds.minX + bounds.maxX) * 0.5f - viewPos.x
+    );
+    float lowest = 0.0f;
+    float highest = 0.0f;
+    float xs[2] = {bounds.minX, bounds.maxX};
+    float zs[2] = {bounds.minZ, bounds.maxZ};
+    for (float x : xs){
+        for (float z : zs){
+            float angle = atan2(z - viewPos.y, x - viewPos.x) - centreAngle;
+            if (angle > PI){
+                angle -= 2.0f * PI;
+            } else if (angle < -PI){
+                angle += 2.0f * PI;
+            }
+            lowest = min(lowest, angle);
+            highest = max(highest, angle);
+        }
+    }
+    float binsPerRadian = static_cast<float>(binCount) / (2.0f * PI);
+    start = (centreAngle + lowest + PI) * binsPerRadian;
+    end = (centreAngle + highest + PI) * binsPerRadian;
+}
+
+/**
+ * @brief This function will decide which subchunks can be seen from the camera
+ *
+ * @details The subchunks are tested in order of their closest distance to the camera. A subchunk
+ * that is drawn is held back as a pending occluder until the next subchunk to test is at least as
+ * far away as its farthest corner, so that it is only ever used to hide terrain that is entirely
+ * behind it. Subchunks that contain the camera are always drawn and never occlude.
+ *
+ * @param bounds [in] const std::vector<HorizonBounds>& The bounds of the subchunks
+ * @param viewPos [in] glm::vec3 The position of the camera
+ *
+ * @return const std::vector<bool>& Whether each subchunk is visible, in the same order as the bounds,
+ * which is only valid until the next pass
+ *
+ */
+const vector<bool> &HorizonCuller::cull(const vector<HorizonBounds> &bounds, glm::vec3 viewPos){
+    fill(horizon.begin(), horizon.end(), -numeric_limits<float>::infinity());
+    culledCount = 0;
+    visible.assign(bounds.size(), true);
+    glm::vec2 groundPos = glm::vec2(viewPos.x, viewPos.z);
+
+    minDistances.resize(bounds.size());
+    maxDistances.resize(bounds.size());
+    for (size_t i = 0; i < bounds.size(); i++){
+        float dx = max({bounds[i].minX - groundPos.x, 0.0f, groundPos.x - bounds[i].maxX});
+        float dz = max({bounds[i].minZ - groundPos.y, 0.0f, groundPos.y - bounds[i].maxZ});
+        float fx = max(abs(bounds[i].minX - groundPos.x), abs(bounds[i].maxX - groundPos.x));
+        float fz = max(abs(bounds[i].minZ - groundPos.y), abs(bounds[i].maxZ - groundPos.y));
+        minDistances[i] = sqrt(dx * dx + dz * dz);
+        maxDistances[i] = sqrt(fx * fx + fz * fz);
+    }
+    order.resize(bounds.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [this](size_t a, size_t b){
+        return minDistances[a] < minDistances[b];
+    });
+
+    pending.clear();
+    for (size_t i : order){
+        const HorizonBounds &current = bounds[i];
+        float minDistance = minDistances[i];
+        // Raise the horizon with every drawn subchunk that is now entirely in front
+        while (!pending.empty() && pending.front().maxDistance <= minDistance){
+            const PendingOccluder &occluder = pending.front();
+            for (int bin = static_cast<int>(ceil(occluder.start)); bin < static_cast<int>(floor(occluder.end)); bin++){
+                float &binHorizon = horizon[((bin % binCount) + binCount) % binCount];
+                binHorizon = max(binHorizon, occluder.slope);
+            }
+            pop_heap(pending.begin(), pending.end(), greater<PendingOccluder>());
+            pending.pop_back();
+        }
+        if (minDistance <= 0.0f){
+            continue;
+        }
+
+        float start, end;
+        getAngularSpan(current, groundPos, start, end);
+        int firstBin = static_cast<int>(floor(start));
+        int lastBin = min(static_cast<int>(floor(end)), firstBin + binCount - 1);
+        float highestSlope = getSlope(current.maxHeight - viewPos.y, minDistance, maxDistances[i], true);
+        bool hidden = true;
+        for (int bin = firstBin; bin <= lastBin && hidden; bin++){
+            hidden = highestSlope < horizon[((bin % binCount) + binCount) % binCount];
+        }
+        if (hidden){
+            visible[i] = false;
+            culledCount++;
+        } else if (current.occluder){
+            float lowestSlope = getSlope(current.minHeight - viewPos.y, minDistance, maxDistances[i], false);
+            pending.push_back(PendingOccluder{maxDistances[i], lowestSlope, start, end});
+            push_heap(pending.begin(), pending.end(), greater<PendingOccluder>());
+        }
+    }
+    return visible;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file MeshIndexing.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the MeshIndexing class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <algorithm>
+
+#include "MeshIndexing.hpp"
+
+using namespace std;
+
+/**
+ * @brief This function will return the width in quads of the stripes for a given cache size
+ *
+ * @details Each row of a stripe of width w uses w + 1 vertices from the row before it and adds
+ * w + 1 new ones, so both rows fit in a first-in first-out cache when 2 * (w + 1) <= cacheSize.
+ * The two rows are interleaved in the cache as each quad touches both of them, which makes a
+ * stripe that exactly fills the cache evict a vertex just before it is reused, so one column of
+ * slack is left.
+ *
+ * @param cacheSize [in] int The number of vertices held by the vertex cache
+ *
+ * @return int The stripe width in quads, at least 1
+ *
+ */
+int MeshIndexing::getStripeWidth(int cacheSize){
+    return max(1, cacheSize / 2 - 2);
+}
+
+/**
+ * @brief This function will generate the index buffer of a grid one row of quads at a time
+ *
+ * @details This is the order the terrain used to be drawn in and is kept to measure against.
+ *
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the grid
+ *
+ * @return std::vector<unsigned int> The index buffer
+ *
+ */
+vector<unsigned int> MeshIndexing::generateRowOrderIndices(int numberOfVerticesPerAxis){
+    return generateStripeOrderIndices(numberOfVerticesPerAxis, numberOfVerticesPerAxis - 1);
+}
+
+/**
+ * @brief This function will generate the index buffer of a grid in vertical stripes
+ *
+ * @details The quads are emitted one stripe at a time, and within a stripe one row at a time, so
+ * the vertices shared between neighbouring rows are still in the cache when they are reused. The
+ * quad at (a, b) is split into the triangles [a,b], [a+1,b], [a+1,b+1] and [a,b], [a+1,b+1],
+ * [a,b+1].
+ *
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the grid
+ * @param stripeWidth [in] int The number of quads across each stripe
+ *
+ * @return std::vector<unsigned int> The index buffer
+ *
+ */
+vector<unsigned int> MeshIndexing::generateStripeOrderIndices(int numberOfVerticesPerAxis, int stripeWidth){
+    int quadsPerAxis = numberOfVerticesPerAxis - 1;
+    vector<unsigned int> indices;
+    if (quadsPerAxis <= 0){
+        return indices;
+    }
+    stripeWidth = max(1, stripeWidth);
+    indices.reserve(quadsPerAxis * quadsPerAxis * 6);
+    for (int stripeStart = 0; stripeStart < quadsPerAxis; stripeStart += stripeWidth){
+        int stripeEnd = min(stripeStart + stripeWidth, quadsPerAxis);
+        for (int a = 0; a < quadsPerAxis; a++){
+            for (int b = stripeStart; b < stripeEnd; b++){
+                unsigned int corner = a * numberOfVerticesPerAxis + b;
+                unsigned int across = (a + 1) * numberOfVerticesPerAxis + b;
+                indices.insert(indices.end(), {corner, across, across + 1, corner, across + 1, corner + 1});
+            }
+        }
+    }
+    return indices;
+}
+
+/**
+ * @brief This function will compute the average cache miss ratio of an index buffer
+ *
+ * @details The vertex cache is modelled as a first-in first-out queue, which is how the post
+ * transform cache of most GPUs behaves. The ratio is the number of vertices transformed per
+ * triangle, which approaches 0.5 for an ideally ordered grid and 3 with no reuse at all.
+ *
+ * @param indices [in] const std::vector<unsigned int>& The index buffer
+ * @param cacheSize [in] int The number of vertices held by the vertex cache
+ *
+ * @return float The average cache miss ratio
+ *
+ */
+float MeshIndexing::computeAcmr(const vector<unsigned int> &indices, int cacheSize){
+    if (indices.size() < 3){
+        return 0.0f;
+    }
+    deque<unsigned int> cache;
+    unordered_set<unsigned int> cached;
+    int misses = 0;
+    for (unsigned int index : indices){
+        if (cached.count(index) > 0){
+            continue;
+        }
+        misses++;
+        cache.push_back(index);
+        cached.insert(index);
+        if (static_cast<int>(cache.size()) > cacheSize){
+            cached.erase(cache.front());
+            cache.pop_front();
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
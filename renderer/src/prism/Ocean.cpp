@@ -26,6 +26,7 @@
 #include "Settings.hpp"
 #include "Shader.hpp"
 #include "Vertex.hpp"
+#include "GpuBufferPool.hpp"
 
 using namespace std;
 
@@ -34,24 +35,29 @@ using namespace std;
  * 
  * @details This constructor will create an ocean object with the given parameters. The ocean will
  * be created at the given ocean quad origin and will be rendered at the given world coordinates.
+ * The GPU buffers are created by setupData, which must be called on the thread that owns the
+ * OpenGL context before the ocean is rendered.
  * 
  * @param inOceanQuadOrigin [in] std::vector<float> The origin of the ocean quad
  * @param inWorldCoords [in] std::vector<float> The world coordinates of the ocean
- * @param inSettings [in] std::shared_ptr<Settings> The settings object
- * @param inShader [in] std::shared_ptr<Shader> The shader object
- * @param inReflectionBuffer [in] std::shared_ptr<WaterFrameBuffer> The reflection buffer
- * @param inRefractionBuffer [in] std::shared_ptr<WaterFrameBuffer> The refraction buffer
- * @param inOceanTextures [in] std::vector<std::shared_ptr<Texture>> The ocean textures
+ * @param inSettings [in] Settings* The settings object, owned by the parent chunk
+ * @param inShader [in] Shader* The shader object, owned by the parent chunk
+ * @param inReflectionBuffer [in] WaterFrameBuffer* The reflection buffer, owned by the parent chunk
+ * @param inRefractionBuffer [in] WaterFrameBuffer* The refraction buffer, owned by the parent chunk
+ * @param inOceanTextures [in] const std::vector<std::shared_ptr<Texture>>* The ocean textures, owned by the parent chunk
+ * @param inScale [in] float The number of world units between the vertices of the terrain the ocean covers
  */
 Ocean::Ocean(
     vector<float> inOceanQuadOrigin,
     vector<float> inWorldCoords,
-    shared_ptr<Settings> inSettings,
-    shared_ptr<Shader> inShader,
-    shared_ptr<WaterFrameBuffer> inReflectionBuffer,
-    shared_ptr<WaterFrameBuffer> inRefractionBuffer,
-    vector<shared_ptr<Texture>> inOceanTextures
+    Settings *inSettings,
+    Shader *inShader,
+    WaterFrameBuffer *inReflectionBuffer,
+    WaterFrameBuffer *inRefractionBuffer,
+    const vector<shared_ptr<Texture>> *inOceanTextures,
+    float inScale
 ):
+    shader(inShader),
     settings(inSettings),
     oceanQuadOrigin(inOceanQuadOrigin),
     worldCoords(inWorldCoords),
@@ -61,80 +67,85 @@ Ocean::Ocean(
     waveSpeed(0.03f),
     currentTime(0.0f),
     previousTime(0.0f),
-    moveFactor(0.0f)
+    moveFactor(0.0f),
+    bufferPool(nullptr)
 {
     seaLevel = settings->getSeaLevel();
     size = settings->getSubChunkSize();
     float worldSeaLevel = seaLevel * settings->getMaximumHeight();
+    // The quad covers the same area as the terrain beneath it, which is larger than a subchunk
+    // when the terrain is a coarse quadtree patch
+    float extent = (size - 1) * inScale;
     Vertex bottomLeft = Vertex(
         glm::vec3(oceanQuadOrigin[0], worldSeaLevel, oceanQuadOrigin[1]),
         glm::vec3(0.0f, 1.0f, 0.0f),
         glm::vec2(0.0f, 0.0f)
     );
     Vertex topRight = Vertex(
-        glm::vec3(oceanQuadOrigin[0] + (size - 1), worldSeaLevel, oceanQuadOrigin[1] + (size - 1)),
+        glm::vec3(oceanQuadOrigin[0] + extent, worldSeaLevel, oceanQuadOrigin[1] + extent),
         glm::vec3(0.0f, 1.0f, 0.0f),
         glm::vec2(1.0f, 1.0f)
     );
     Vertex bottomRight = Vertex(
-        glm::vec3(oceanQuadOrigin[0] + (size - 1), worldSeaLevel, oceanQuadOrigin[1]),
+        glm::vec3(oceanQuadOrigin[0] + extent, worldSeaLevel, oceanQuadOrigin[1]),
         glm::vec3(0.0f, 1.0f, 0.0f),
         glm::vec2(1.0f, 0.0f)
     );
     Vertex topLeft = Vertex(
-        glm::vec3(oceanQuadOrigin[0], worldSeaLevel, oceanQuadOrigin[1] + (size - 1)),
+        glm::vec3(oceanQuadOrigin[0], worldSeaLevel, oceanQuadOrigin[1] + extent),
         glm::vec3(0.0f, 1.0f, 0.0f),
         glm::vec2(0.0f, 1.0f)
     );
     setVertices({bottomLeft, bottomRight, topLeft, topRight});
     setIndices({0, 2, 1, 1, 2, 3});
 
-    shader = inShader;
-
     model = glm::translate(glm::mat4(1.0f), glm::vec3(worldCoords[0], 0.0f, worldCoords[1]));
     normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+}
+
+/**
+ * @brief Destroy the Ocean object and return its GPU buffers to the pool
+ * 
+ */
+Ocean::~Ocean(){
+    releaseData();
+}
 
-    setupData();
+/**
+ * @brief Return the GPU buffers of the ocean to the pool
+ * 
+ * @details The quad is kept so the ocean can be uploaded again later by calling setupData.
+ * 
+ * @return void
+ */
+void Ocean::releaseData(){
+    if (bufferPool != nullptr){
+        bufferPool->releaseMesh(meshBuffers);
+    }
+    meshBuffers = MeshBuffers();
+    VAO = 0;
+    VBO = 0;
+    EBO = 0;
 }
 
 /**
  * @brief Set up the render buffers for the ocean object
  * 
- * @details This function will set up the render buffers for the ocean object. This includes
- * creating the VAO, VBO and EBO buffers and binding them correctly. It will also set up the
- * vertex attribute pointers.
+ * @details This function will check out the VAO, VBO and EBO buffers for the ocean quad from the
+ * buffer pool and fill them with the quad. Every ocean quad has the same size so the buffers of
+ * released quads are always reused. The pool must be given to the ocean by setBufferPool first.
  * 
  * @return void
  */
 void Ocean::setupData() {
-    // We need to create four vertices for the ocean quad which start at the ocean quad origin
-    // and spans the size of the subchunk. The sea level will be multipled with the maximum height
-
-    // Generate the VAO, VBO and EBO buffers by binding them correctly
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // We pass in the vertex data as a single buffer
-    // This should be ordered as position, normal, texCoords per vertex
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-    // We set the mesh EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-    // We now need to set the vertex attribute pointers
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3)));
-    glEnableVertexAttribArray(1);
-    // Texture attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3) * 2));
-    glEnableVertexAttribArray(2);
+    // Return anything from an earlier upload before checking out the new storage
+    bufferPool->releaseMesh(meshBuffers);
+    // The vertex data is a single buffer ordered as position, normal, texCoords per vertex
+    meshBuffers = bufferPool->acquireMesh(vertices.size() * sizeof(Vertex), indices.size() * sizeof(unsigned int));
+    bufferPool->uploadMesh(meshBuffers, vertices, indices);
+    VAO = meshBuffers.VAO;
+    VBO = meshBuffers.VBO;
+    EBO = meshBuffers.EBO;
 }
 
 #pragma GCC diagnostic push
@@ -215,10 +226,10 @@ void Ocean::render(
     glActiveTexture(GL_TEXTURE2);
     glBindTexture(GL_TEXTURE_2D, refractionBuffer->getDepthTexture());
 
-    for (size_t i = 0; i < oceanTextures.size(); i++) {
-        shader->setInt(oceanTextures[i]->getName(), 3 + i);
+    for (size_t i = 0; i < oceanTextures->size(); i++) {
+        shader->setInt((*oceanTextures)[i]->getName(), 3 + i);
         glActiveTexture(GL_TEXTURE3 + i);
-        glBindTexture(GL_TEXTURE_2D, oceanTextures[i]->getId());
+        glBindTexture(GL_TEXTURE_2D, (*oceanTextures)[i]->getId());
     }
 
     glBindVertexArray(VAO);
@@ -0,0 +1,252 @@
+/**
+ * @file PlaceholderTerrain.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the PlaceholderTerrain class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include "PlaceholderTerrain.hpp"
+#include "Settings.hpp"
+#include "Parameters.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Placeholder Terrain object from the world seed and parameters
+ *
+ * @details The generator parameters (0-100 sliders) are mapped onto the shape of the noise. The
+ * continent size controls the wavelength of the lowest octave, the ocean coverage controls how
+ * much of the noise range lies below sea level, the global maximum height controls how tall the
+ * land can get and the global ruggedness controls how quickly the octaves fall off.
+ *
+ * @param inSeed [in] long The seed of the world
+ * @param settings [in] std::shared_ptr<Settings> The settings object
+ *
+ */
+PlaceholderTerrain::PlaceholderTerrain(long inSeed, shared_ptr<Settings> settings):
+    seed(static_cast<uint32_t>(inSeed)),
+    chunkSize(settings->getChunkSize()),
+    sampleSpacing(16),
+    seaLevel(settings->getSeaLevel()),
+    octaves(5)
+{
+    // Use the generator defaults if no parameters have been loaded yet
+    float continentSize = 50.0f;
+    float ocean = 50.0f;
+    float maxHeight = 50.0f;
+    float ruggedness = 50.0f;
+    shared_ptr<Parameters> parameters = settings->getParameters();
+    if (parameters != nullptr){
+        continentSize = static_cast<float>(parameters->getContinentSize());
+        ocean = static_cast<float>(parameters->getOceanCoverage());
+        maxHeight = static_cast<float>(parameters->getGlobalMaxHeight());
+        ruggedness = static_cast<float>(parameters->getGlobalRuggedness());
+    }
+    continentScale = 1024.0f + 7168.0f * clamp(continentSize / 100.0f, 0.0f, 1.0f);
+    oceanCoverage = clamp(ocean / 100.0f, 0.05f, 0.95f);
+    landHeight = 0.2f + 0.8f * clamp(maxHeight / 100.0f, 0.0f, 1.0f);
+    persistence = 0.35f + 0.3f * clamp(ruggedness / 100.0f, 0.0f, 1.0f);
+}
+
+/**
+ * @brief This function will return the pseudo-random value stored at a lattice point
+ *
+ * @details The value is produced by hashing the lattice coordinates with the seed and the octave
+ * so that every octave uses an independent lattice.
+ *
+ * @param x [in] int The x coordinate of the lattice point
+ * @param z [in] int The z coordinate of the lattice point
+ * @param octave [in] uint32_t The octave that is being sampled
+ *
+ * @return float The value at the lattice point in the range [0, 1]
+ *
+ */
+float PlaceholderTerrain::latticeValue(int x, int z, uint32_t octave) const {
+    uint32_t h = seed ^ (octave * 0x9E3779B9u);
+    h ^= static_cast<uint32_t>(x) * 0x85EBCA6Bu;
+    h = (h << 13) | (h >> 19);
+    h ^= static_cast<uint32_t>(z) * 0xC2B2AE35u;
+    // Murmur3 finaliser to spread the bits
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return static_cast<float>(h & 0xFFFFFFu) / static_cast<float>(0xFFFFFFu);
+}
+
+/**
+ * @brief This function will sample smoothed value noise at the given lattice space position
+ *
+ * @param x [in] float The x coordinate in lattice space
+ * @param z [in] float The z coordinate in lattice space
+ * @param octave [in] uint32_t The octave that is being sampled
+ *
+ * @return float The noise value in the range [0, 1]
+ *
+ */
+float PlaceholderTerrain::valueNoise(float x, float z, uint32_t octave) const {
+    float fx = floor(x);
+    float fz = floor(z);
+    int x0 = static_cast<int>(fx);
+    int z0 = static_cast<int>(fz);
+    float tx = x - fx;
+    float tz = z - fz;
+    // Smoothstep the interpolation weights to hide the lattice
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    tz = tz * tz * (3.0f - 2.0f * tz);
+    float v00 = latticeValue(x0, z0, octave);
+    float v10 = latticeValue(x0 + 1, z0, octave);
+    float v01 = latticeValue(x0, z0 + 1, octave);
+    float v11 = latticeValue(x0 + 1, z0 + 1, octave);
+    float bottom = v00 + (v10 - v00) * tx;
+    float top = v01 + (v11 - v01) * tx;
+    return bottom + (top - bottom) * tz;
+}
+
+/**
+ * @brief This function will sample fractal value noise at the given world position
+ *
+ * @param x [in] float The x coordinate in world space
+ * @param z [in] float The z coordinate in world space
+ *
+ * @return float The normalised noise value in the range [0, 1]
+ *
+ */
+float PlaceholderTerrain::fractalNoise(float x, float z) const {
+    float frequency = 1.0f / continentScale;
+    float amplitude = 1.0f;
+    float total = 0.0f;
+    float totalAmplitude = 0.0f;
+    for (int octave = 0; octave < octaves; octave++){
+        total += valueNoise(x * frequency, z * frequency, static_cast<uint32_t>(octave)) * amplitude;
+        totalAmplitude += amplitude;
+        frequency *= 2.0f;
+        amplitude *= persistence;
+    }
+    return total / totalAmplitude;
+}
+
+/**
+ * @brief This function will compute the placeholder height at a world position
+ *
+ * @details The noise below the ocean coverage threshold is mapped onto the sea bed and the rest is
+ * mapped from sea level up to the maximum land height.
+ *
+ * @param worldX [in] float The x coordinate in world space
+ * @param worldZ [in] float The z coordinate in world space
+ *
+ * @return float The height as a fraction of the maximum height in the range [0, 1]
+ *
+ */
+float PlaceholderTerrain::sampleHeight(float worldX, float worldZ) const {
+    float n = fractalNoise(worldX, worldZ);
+    if (n < oceanCoverage){
+        return seaLevel * (n / oceanCoverage);
+    }
+    float land = (n - oceanCoverage) / (1.0f - oceanCoverage);
+    return seaLevel + (1.0f - seaLevel) * landHeight * land;
+}
+
+/**
+ * @brief This function will generate the placeholder heightmap for a chunk
+ *
+ * @details The heightmap has the same layout as the heightmaps received from the server, which is
+ * (chunkSize + 2) x (chunkSize + 2) with a one vertex border, so it can be passed straight to the
+ * Chunk class. The noise is only evaluated on a coarse lattice which is then bilinearly
+ * interpolated to the full resolution.
+ *
+ * @param cx [in] int The chunk x coordinate
+ * @param cz [in] int The chunk z coordinate
+ *
+ * @return std::vector<std::vector<float>> The heightmap indexed as [z][x]
+ *
+ */
+vector<vector<float>> PlaceholderTerrain::generateHeightmap(int cx, int cz) const {
+    int vertices = chunkSize + 2;
+    // Heightmap index i corresponds to world coordinate chunkOrigin + i - 1
+    int originX = cx * (chunkSize - 1) - 1;
+    int originZ = cz * (chunkSize - 1) - 1;
+    // Work out the coarse lattice that covers the heightmap. The lattice is aligned to world space
+    // so that neighbouring chunks sample exactly the same points
+    int firstSampleX = static_cast<int>(floor(static_cast<float>(originX) / sampleSpacing));
+    int firstSampleZ = static_cast<int>(floor(static_cast<float>(originZ) / sampleSpacing));
+    int lastSampleX = static_cast<int>(ceil(static_cast<float>(originX + vertices - 1) / sampleSpacing));
+    int lastSampleZ = static_cast<int>(ceil(static_cast<float>(originZ + vertices - 1) / sampleSpacing));
+    int samplesX = lastSampleX - firstSampleX + 1;
+    int samplesZ = lastSampleZ - firstSampleZ + 1;
+    vector<float> coarse(samplesX * samplesZ);
+    #pragma omp parallel for
+    for (int z = 0; z < samplesZ; z++){
+        for (int x = 0; x < samplesX; x++){
+            coarse[z * samplesX + x] = sampleHeight(
+                static_cast<float>((firstSampleX + x) * sampleSpacing),
+                static_cast<float>((firstSampleZ + z) * sampleSpacing)
+            );
+        }
+    }
+
+    vector<vector<float>> heightmap = vector<vector<float>>(vertices, vector<float>(vertices));
+    #pragma omp parallel for
+    for (int z = 0; z < vertices; z++){
+        int worldZ = originZ + z;
+        int sampleZ = static_cast<int>(floor(static_cast<float>(worldZ) / sampleSpacing));
+        int rowZ = min(sampleZ - firstSampleZ, samplesZ - 2);
+        float tz = static_cast<float>(worldZ - (firstSampleZ + rowZ) * sampleSpacing) / sampleSpacing;
+        for (int x = 0; x < vertices; x++){
+            int worldX = originX + x;
+            int sampleX = static_cast<int>(floor(static_cast<float>(worldX) / sampleSpacing));
+            int colX = min(sampleX - firstSampleX, samplesX - 2);
+            float tx = static_cast<float>(worldX - (firstSampleX + colX) * sampleSpacing) / sampleSpacing;
+            float h00 = coarse[rowZ * samplesX + colX];
+            float h10 = coarse[rowZ * samplesX + colX + 1];
+            float h01 = coarse[(rowZ + 1) * samplesX + colX];
+            float h11 = coarse[(rowZ + 1) * samplesX + colX + 1];
+            float bottom = h00 + (h10 - h00) * tx;
+            float top = h01 + (h11 - h01) * tx;
+            heightmap[z][x] = bottom + (top - bottom) * tz;
+        }
+    }
+    return heightmap;
+}
+
+/**
+ * @brief This function will generate a biome map that matches a placeholder heightmap
+ *
+ * @details Only a handful of subbiomes are used: sea bed below sea level, tundra on the highest
+ * ground and grassland everywhere else. This is enough for the terrain shader to pick sensible
+ * textures until the real biome data arrives.
+ *
+ * @param heightmap [in] const std::vector<std::vector<float>>& The placeholder heightmap
+ *
+ * @return std::vector<std::vector<uint8_t>> The biome map indexed as [z][x]
+ *
+ */
+vector<vector<uint8_t>> PlaceholderTerrain::generateBiomes(const vector<vector<float>> &heightmap) const {
+    const uint8_t grasslandPlains = 4;
+    const uint8_t tundraBluntMountains = 9;
+    const uint8_t oceanSeabed = 30;
+    float mountainHeight = seaLevel + (1.0f - seaLevel) * landHeight * 0.6f;
+    vector<vector<uint8_t>> biomes = vector<vector<uint8_t>>(heightmap.size(), vector<uint8_t>(heightmap[0].size()));
+    #pragma omp parallel for
+    for (int z = 0; z < static_cast<int>(heightmap.size()); z++){
+        for (int x = 0; x < static_cast<int>(heightmap[z].size()); x++){
+            float height = heightmap[z][x];
+            if (height < seaLevel){
+                biomes[z][x] = oceanSeabed;
+            } else if (height > mountainHeight){
+                biomes[z][x] = tundraBluntMountains;
+            } else {
+                biomes[z][x] = grasslandPlains;
+            }
+        }
+    }
+    return biomes;
+}
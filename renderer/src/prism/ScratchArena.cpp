@@ -0,0 +1,127 @@
+/**
+ * @file ScratchArena.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the ScratchArena class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "ScratchArena.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new empty ScratchArena object, the first block is allocated when it is needed
+ *
+ */
+ScratchArena::ScratchArena():
+    currentBlock(0),
+    used(0),
+    peakBytes(0)
+{
+}
+
+/**
+ * @brief This function will return the arena of the calling thread
+ *
+ * @details The arena is created the first time a thread asks for it and lives until the thread
+ * exits, so the mesh workers keep their blocks from one build to the next.
+ *
+ * @return ScratchArena& The arena of the calling thread
+ *
+ */
+ScratchArena &ScratchArena::forThread(){
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+/**
+ * @brief This function will take a number of bytes from the arena
+ *
+ * @details The bytes are taken from the current block when they fit. Otherwise the arena moves on
+ * to the next block that is large enough, and a new block is allocated when none of the remaining
+ * ones are. Blocks that are skipped are reused once the arena is rewound past them.
+ *
+ * @param bytes [in] size_t The number of bytes to take
+ *
+ * @return void* The first byte, aligned to ALIGNMENT
+ *
+ */
+void *ScratchArena::allocateBytes(size_t bytes){
+    size_t aligned = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    while (currentBlock < blocks.size() && used + aligned > blocks[currentBlock].capacity){
+        currentBlock++;
+        used = 0;
+    }
+    if (currentBlock == blocks.size()){
+        Block block;
+        block.capacity = max(aligned, BLOCK_SIZE);
+        block.memory = unique_ptr<unsigned char[]>(new unsigned char[block.capacity + ALIGNMENT]);
+        uintptr_t address = reinterpret_cast<uintptr_t>(block.memory.get());
+        block.start = block.memory.get() + (ALIGNMENT - address % ALIGNMENT) % ALIGNMENT;
+        blocks.push_back(std::move(block));
+        used = 0;
+    }
+    void *allocation = blocks[currentBlock].start + used;
+    used += aligned;
+    peakBytes = max(peakBytes, getUsedBytes());
+    return allocation;
+}
+
+/**
+ * @brief This function will return the number of bytes in use, counting skipped blocks as full
+ *
+ * @return size_t The number of bytes before the current position of the arena
+ *
+ */
+size_t ScratchArena::getUsedBytes() const{
+    size_t bytes = used;
+    for (size_t i = 0; i < currentBlock && i < blocks.size(); i++){
+        bytes += blocks[i].capacity;
+    }
+    return bytes;
+}
+
+/**
+ * @brief This function will give back everything taken from the arena since a marker was taken
+ *
+ * @param marker [in] Marker The position to rewind to
+ *
+ * @return void
+ *
+ */
+void ScratchArena::rewind(Marker marker){
+    currentBlock = marker.block;
+    used = marker.used;
+}
+
+/**
+ * @brief This function will give back everything taken from the arena while keeping its blocks
+ *
+ * @return void
+ *
+ */
+void ScratchArena::reset(){
+    currentBlock = 0;
+    used = 0;
+}
+
+/**
+ * @brief This function will return the number of bytes held by the blocks of the arena
+ *
+ * @return size_t The total capacity of the blocks in bytes
+ *
+ */
+size_t ScratchArena::getCapacity() const{
+    size_t capacity = 0;
+    for (const Block &block : blocks){
+        capacity += block.capacity;
+    }
+    return capacity;
+}
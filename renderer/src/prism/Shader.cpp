@@ -104,8 +104,8 @@ void Shader::checkCompileErrors(GLuint shader, string type, string shaderName){
 /**
  * @brief This function will construct a shader program from the individual shaders.
  * 
- * @details This function will compile the vertex shader, fragment shader, and geometry shader
- * (if present) and link them together to create a shader program. It will also check for errors
+ * @details This function will compile the vertex shader, fragment shader, and geometry and
+ * tessellation shaders (if present) and link them together to create a shader program. It will also check for errors
  * in the compilation and linking process.
  * 
  * @param vertexCode [in] const char* The vertex shader code
@@ -114,6 +114,10 @@ void Shader::checkCompileErrors(GLuint shader, string type, string shaderName){
  * @param fragmentName [in] std::string The name of the fragment shader
  * @param geometryCode [in] optional<const char*> The geometry shader code
  * @param geometryName [in] optional<std::string> The name of the geometry shader
+ * @param tessControlCode [in] optional<const char*> The tessellation control shader code
+ * @param tessControlName [in] optional<std::string> The name of the tessellation control shader
+ * @param tessEvaluationCode [in] optional<const char*> The tessellation evaluation shader code
+ * @param tessEvaluationName [in] optional<std::string> The name of the tessellation evaluation shader
  * 
  * @return void
  * 
@@ -124,7 +128,11 @@ void Shader::constructShaders(
     const char* fragmentCode,
     string fragmentName,
     optional<const char*> geometryCode,
-    optional<string> geometryName
+    optional<string> geometryName,
+    optional<const char*> tessControlCode,
+    optional<string> tessControlName,
+    optional<const char*> tessEvaluationCode,
+    optional<string> tessEvaluationName
 ){
     vertex = glCreateShader(GL_VERTEX_SHADER);
     fragment = glCreateShader(GL_FRAGMENT_SHADER);
@@ -146,12 +154,30 @@ void Shader::constructShaders(
         glCompileShader(geometry.value());
         checkCompileErrors(geometry.value(), "GEOMETRY", geometryName.value());
     }
+    // The tessellation stages are only present together, so both are compiled when the control
+    // shader is given
+    optional<unsigned int> tessControl = nullopt;
+    optional<unsigned int> tessEvaluation = nullopt;
+    if (tessControlCode.has_value()){
+        tessControl = glCreateShader(GL_TESS_CONTROL_SHADER);
+        glShaderSource(tessControl.value(), 1, &(tessControlCode.value()), NULL);
+        glCompileShader(tessControl.value());
+        checkCompileErrors(tessControl.value(), "TESS_CONTROL", tessControlName.value());
+        tessEvaluation = glCreateShader(GL_TESS_EVALUATION_SHADER);
+        glShaderSource(tessEvaluation.value(), 1, &(tessEvaluationCode.value()), NULL);
+        glCompileShader(tessEvaluation.value());
+        checkCompileErrors(tessEvaluation.value(), "TESS_EVALUATION", tessEvaluationName.value());
+    }
     id = glCreateProgram();
     glAttachShader(id, vertex);
     glAttachShader(id, fragment);
     if (geometry.has_value()){
         glAttachShader(id, geometry.value());
     }
+    if (tessControl.has_value()){
+        glAttachShader(id, tessControl.value());
+        glAttachShader(id, tessEvaluation.value());
+    }
     glLinkProgram(id);
     checkCompileErrors(id, "PROGRAM", vertexName + " " + fragmentName);
     glDeleteShader(vertex);
@@ -159,6 +185,10 @@ void Shader::constructShaders(
     if (geometry.has_value()){
         glDeleteShader(geometry.value());
     }
+    if (tessControl.has_value()){
+        glDeleteShader(tessControl.value());
+        glDeleteShader(tessEvaluation.value());
+    }
     cout << "Program ID: " << id << endl;
 }
 
@@ -275,6 +305,56 @@ Shader::Shader(string vertexPath, string fragmentPath){
     constructShaders(vertexCode, vertexName, fragmentCode, fragmentName, nullopt, nullopt);
 }
 
+/**
+ * @brief This function will create a shader object from the paths provided to each of the 
+ * shaders files (vertex, tessellation control, tessellation evaluation, fragment).
+ * 
+ * @details This function will read the shader files from the paths provided and compile them into
+ * a shader program. It will also check for errors in the compilation and linking process. The
+ * tessellation stages need an OpenGL 4.0 context and the program must be drawn with patches.
+ * 
+ * @param vertexPath [in] std::string The path to the vertex shader file
+ * @param tessControlPath [in] std::string The path to the tessellation control shader file
+ * @param tessEvaluationPath [in] std::string The path to the tessellation evaluation shader file
+ * @param fragmentPath [in] std::string The path to the fragment shader file
+ *  
+ */
+Shader::Shader(string vertexPath, string tessControlPath, string tessEvaluationPath, string fragmentPath){
+    this->vertexPath = vertexPath;
+    this->fragmentPath = fragmentPath;
+    this->geometryPath = nullopt;
+    this->tessControlPath = tessControlPath;
+    this->tessEvaluationPath = tessEvaluationPath;
+
+    // Get the source code from the file paths
+    string vertexCodeStr = readFile(vertexPath);
+    string tessControlCodeStr = readFile(tessControlPath);
+    string tessEvaluationCodeStr = readFile(tessEvaluationPath);
+    string fragmentCodeStr = readFile(fragmentPath);
+    const char *vertexCode = vertexCodeStr.c_str();
+    const char *tessControlCode = tessControlCodeStr.c_str();
+    const char *tessEvaluationCode = tessEvaluationCodeStr.c_str();
+    const char *fragmentCode = fragmentCodeStr.c_str();
+
+    string vertexName = this->vertexPath.substr(this->vertexPath.find_last_of("/\\") + 1);
+    string tessControlName = tessControlPath.substr(tessControlPath.find_last_of("/\\") + 1);
+    string tessEvaluationName = tessEvaluationPath.substr(tessEvaluationPath.find_last_of("/\\") + 1);
+    string fragmentName = this->fragmentPath.substr(this->fragmentPath.find_last_of("/\\") + 1);
+    // Compile the shaders
+    constructShaders(
+        vertexCode,
+        vertexName,
+        fragmentCode,
+        fragmentName,
+        nullopt,
+        nullopt,
+        tessControlCode,
+        tessControlName,
+        tessEvaluationCode,
+        tessEvaluationName
+    );
+}
+
 /**
  * @brief Default constructor for the Shader class
  * 
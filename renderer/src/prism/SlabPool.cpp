@@ -0,0 +1,117 @@
+/**
+ * @file SlabPool.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the SlabPool class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "SlabPool.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new empty SlabPool object, the first slab is allocated when it is needed
+ *
+ * @param inSlotSize [in] size_t The smallest number of bytes in each slot
+ * @param inSlotsPerSlab [in] int The number of slots allocated together in each slab
+ *
+ */
+SlabPool::SlabPool(size_t inSlotSize, int inSlotsPerSlab):
+    slotSize((inSlotSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT),
+    slotsPerSlab(inSlotsPerSlab > 0 ? inSlotsPerSlab : 1),
+    usedCount(0)
+{
+}
+
+/**
+ * @brief This function will allocate a new slab and add its slots to the free slots
+ *
+ * @details The slots are added from the end of the slab backwards so that they are handed out in
+ * address order. The caller must hold the mutex.
+ *
+ * @return void
+ *
+ */
+void SlabPool::addSlab(){
+    unique_ptr<unsigned char[]> slab = unique_ptr<unsigned char[]>(new unsigned char[slotSize * slotsPerSlab + ALIGNMENT]);
+    uintptr_t address = reinterpret_cast<uintptr_t>(slab.get());
+    unsigned char *start = slab.get() + (ALIGNMENT - address % ALIGNMENT) % ALIGNMENT;
+    for (int i = slotsPerSlab - 1; i >= 0; i--){
+        freeSlots.push_back(start + i * slotSize);
+    }
+    slabs.push_back(std::move(slab));
+}
+
+/**
+ * @brief This function will take a slot from the pool
+ *
+ * @return void* The first byte of the slot, aligned to ALIGNMENT
+ *
+ */
+void *SlabPool::allocate(){
+    lock_guard<mutex> lock(poolMutex);
+    if (freeSlots.empty()){
+        addSlab();
+    }
+    void *slot = freeSlots.back();
+    freeSlots.pop_back();
+    usedCount++;
+    return slot;
+}
+
+/**
+ * @brief This function will give a slot back to the pool so that it can be handed out again
+ *
+ * @param slot [in] void* A slot returned by allocate
+ *
+ * @return void
+ *
+ */
+void SlabPool::deallocate(void *slot){
+    if (slot == nullptr){
+        return;
+    }
+    lock_guard<mutex> lock(poolMutex);
+    freeSlots.push_back(slot);
+    usedCount--;
+}
+
+/**
+ * @brief This function will return the number of slabs that have been allocated
+ *
+ * @return int The number of slabs
+ *
+ */
+int SlabPool::getSlabCount() const {
+    lock_guard<mutex> lock(poolMutex);
+    return static_cast<int>(slabs.size());
+}
+
+/**
+ * @brief This function will return the number of slots that are not in use
+ *
+ * @return int The number of free slots
+ *
+ */
+int SlabPool::getFreeCount() const {
+    lock_guard<mutex> lock(poolMutex);
+    return static_cast<int>(freeSlots.size());
+}
+
+/**
+ * @brief This function will return the number of slots that are in use
+ *
+ * @return int The number of used slots
+ *
+ */
+int SlabPool::getUsedCount() const {
+    lock_guard<mutex> lock(poolMutex);
+    return usedCount;
+}
@@ -14,10 +14,12 @@
  * 
  */
 #include <vector>
+#include <utility>
 #include <memory>
 #include <cmath>
 #include <omp.h>
 #include <iostream>
+#include <algorithm>
 
 #ifdef DEPARTMENT_BUILD
     #include "/dcs/large/efogahlewem/.local/include/glad/glad.h"
@@ -35,6 +37,7 @@
 #include "Shader.hpp"
 #include "Texture.hpp"
 #include "WaterFrameBuffer.hpp"
+#include "HorizonCuller.hpp"
 
 /**
  * @brief This method will get the world coordinates of the subchunk
@@ -43,12 +46,12 @@
  * using its parent chunk's world coordinates and its Id. It's own Id is unique to the superchunk
  * and based its local coordinates in the superchunk.
  * 
- * @param settings [in] std::shared_ptr<Settings> The settings object
+ * @param settings [in] Settings* The settings object
  * 
  * @return std::vector<float> The world coordinates of the subchunk
  * 
  */
-vector<float> SubChunk::getSubChunkWorldCoords(shared_ptr<Settings> settings)
+vector<float> SubChunk::getSubChunkWorldCoords(Settings *settings)
 {
     // Get the world coordinates of the parent chunk
     vector<float> parentWorldCoords = parentChunk->getChunkWorldCoords();
@@ -62,6 +65,136 @@ vector<float> SubChunk::getSubChunkWorldCoords(shared_ptr<Settings> settings)
     return vector<float>{x, z};
 }
 
+/**
+ * @brief This method will set the cross-fade state of the subchunk
+ * 
+ * @details The fade is forwarded to the terrain. A subchunk that is fading out belongs to a
+ * placeholder chunk whose replacement already renders its own ocean, so the placeholder ocean is
+ * skipped to avoid blending the water twice.
+ * 
+ * @param fade [in] float The visible fraction of the terrain
+ * @param fadeOut [in] bool Whether the terrain is fading out rather than in
+ * 
+ * @return void
+ * 
+ */
+void SubChunk::setFade(float fade, bool fadeOut)
+{
+    terrain.setFade(fade, fadeOut);
+    fadingOut = fadeOut;
+}
+
+/**
+ * @brief This method will set the camera distances over which the subchunk morphs to the next
+ * coarser level of detail
+ * 
+ * @param morphRange [in] glm::vec2 The start and end distance of the morph in world units
+ * 
+ * @return void
+ * 
+ */
+void SubChunk::setMorphRange(glm::vec2 morphRange)
+{
+    terrain.setMorphRange(morphRange);
+}
+
+/**
+ * @brief This method will compute the range of world heights covered by the subchunk
+ * 
+ * @details The range is looked up in the height pyramid of the parent chunk and covers every
+ * height of the chunk under the subchunk, including the border, so it also bounds the coarser
+ * meshes and the morph targets as they only ever blend between these heights. Meshes finer than
+ * the heightmap and tessellated terrain place vertices with bicubic interpolation, which can
+ * overshoot the samples. The weights of each cubic sum to at most 1.25 in magnitude, so the 2D
+ * interpolation stays within 1.5625 times the half range about the middle of the range.
+ * 
+ * @return void
+ * 
+ */
+void SubChunk::computeHeightRange()
+{
+    glm::vec2 bounds = parentChunk->getSubChunkHeightBounds(id);
+    float lowest = bounds.x;
+    float highest = bounds.y;
+    if (resolution > 1.0f || parentChunk->getSettings()->getHardwareTessellation()){
+        float overshoot = 0.28125f * (highest - lowest);
+        lowest -= overshoot;
+        highest += overshoot;
+    }
+    minHeight = lowest;
+    maxHeight = highest;
+}
+
+/**
+ * @brief This method will return a view of the heights of the subchunk including the border
+ * 
+ * @details The terrain is built from this view in the constructor, which only relies on the size
+ * and the heights as they are declared before the terrain.
+ * 
+ * @return HeightView The view of the heights stored row by row
+ * 
+ */
+HeightView SubChunk::getHeightView()
+{
+    return HeightView{heights.data(), size + 2, size + 2, size + 2};
+}
+
+/**
+ * @brief This method will find the parity offset of the next coarser grid of a subchunk
+ * 
+ * @details The next coarser grid is aligned to the patch one level up the quadtree, which starts
+ * an odd number of vertices before this patch when the patch is the second child along an axis.
+ * Finer resolutions always have an even number of vertices per subchunk so they are never offset.
+ * 
+ * @param size [in] int The number of heightmap values per axis of a subchunk
+ * @param resolution [in] float The resolution of the subchunk
+ * @param subChunkCoords [in] const std::vector<int>& The local coordinates of the subchunk
+ * @param spacing [in] float The number of world units between the heightmap values
+ * 
+ * @return std::vector<int> The parity offset along the x and z axes
+ * 
+ */
+vector<int> SubChunk::getMorphOffset(int size, float resolution, const vector<int> &subChunkCoords, float spacing)
+{
+    vector<int> morphOffset = vector<int>{0, 0};
+    if (resolution <= 1.0f){
+        int patchWidth = static_cast<int>((size - 1) * spacing);
+        morphOffset[0] = ((subChunkCoords[0] / patchWidth) * (size - 1)) % 2;
+        morphOffset[1] = ((subChunkCoords[1] / patchWidth) * (size - 1)) % 2;
+    }
+    return morphOffset;
+}
+
+/**
+ * @brief This method will compute the bounds of the subchunk used by the horizon culling pass
+ * 
+ * @details The bounds never change once the subchunk is built, so they are computed here once
+ * rather than on every pass. The ocean of the subchunk is drawn at sea level, so the highest
+ * point drawn by the subchunk is never below it. The ocean is not opaque and so it does not lower
+ * the top of the terrain as an occluder. Whether the subchunk may occlude depends on the fade of
+ * its chunk, so the culling pass sets that itself.
+ * 
+ * @param settings [in] Settings* The settings object
+ * 
+ * @return void
+ * 
+ */
+void SubChunk::computeHorizonBounds(Settings *settings)
+{
+    vector<float> worldCoords = getSubChunkWorldCoords(settings);
+    float extent = (size - 1) * spacing;
+    float seaHeight = settings->getSeaLevel() * settings->getMaximumHeight();
+    horizonBounds = HorizonBounds{
+        worldCoords[0],
+        worldCoords[1],
+        worldCoords[0] + extent,
+        worldCoords[1] + extent,
+        minHeight,
+        max(maxHeight, seaHeight),
+        true
+    };
+}
+
 /**
  * @brief Construct a new SubChunk object with the given arguments
  * 
@@ -70,60 +203,50 @@ vector<float> SubChunk::getSubChunkWorldCoords(shared_ptr<Settings> settings)
  * for the subchunk.
  * 
  * @param inId [in] int The id of the subchunk
- * @param inParentChunk [in] std::shared_ptr<Chunk> The parent chunk of the subchunk
- * @param settings [in] std::shared_ptr<Settings> The settings object
+ * @param inParentChunk [in] Chunk* The parent chunk of the subchunk, which must outlive it
+ * @param settings [in] Settings* The settings object
  * @param inSubChunkCoords [in] std::vector<int> The local coordinates of the subchunk
- * @param inHeights [in] std::vector<std::vector<float>> The heights of the subchunk
- * @param inBiomes [in] std::vector<std::vector<uint8_t>> The biomes of the subchunk
- * @param inTerrainShader [in] std::shared_ptr<Shader> The shader for the terrain
- * @param inOceanShader [in] std::shared_ptr<Shader> The shader for the ocean
- * @param inTerrainTextures [in] std::vector<std::shared_ptr<Texture>> The textures for the terrain
- * @param inReflectionBuffer [in] std::shared_ptr<WaterFrameBuffer> The reflection buffer for the ocean
- * @param inRefractionBuffer [in] std::shared_ptr<WaterFrameBuffer> The refraction buffer for the ocean
- * @param inOceanTextures [in] std::vector<std::shared_ptr<Texture>> The textures for the ocean
+ * @param inHeights [in] std::vector<float> The heights of the subchunk including the border stored row by row
+ * @param inTerrainShader [in] Shader* The shader for the terrain
+ * @param inOceanShader [in] Shader* The shader for the ocean
+ * @param inTerrainTextures [in] const std::vector<std::shared_ptr<Texture>>* The textures for the terrain
+ * @param inTerrainTextureArrays [in] const std::vector<std::shared_ptr<TextureArray>>* The texture arrays for the terrain
+ * @param inReflectionBuffer [in] WaterFrameBuffer* The reflection buffer for the ocean
+ * @param inRefractionBuffer [in] WaterFrameBuffer* The refraction buffer for the ocean
+ * @param inOceanTextures [in] const std::vector<std::shared_ptr<Texture>>* The textures for the ocean
  * 
  */ 
 SubChunk::SubChunk(
     int inId,
-    shared_ptr<Chunk> inParentChunk,
-    shared_ptr<Settings> settings,
+    Chunk *inParentChunk,
+    Settings *settings,
     vector<int> inSubChunkCoords,
-    vector<vector<float>> inHeights,
-    vector<vector<uint8_t>> inBiomes,
-    shared_ptr<Shader> inTerrainShader,
-    shared_ptr<Shader> inOceanShader,
-    vector<shared_ptr<Texture>> inTerrainTextures,
-    shared_ptr<WaterFrameBuffer> inReflectionBuffer,
-    shared_ptr<WaterFrameBuffer> inRefractionBuffer,
-    vector<shared_ptr<Texture>> inOceanTextures
+    vector<float> inHeights,
+    Shader *inTerrainShader,
+    Shader *inOceanShader,
+    const vector<shared_ptr<Texture>> *inTerrainTextures,
+    const vector<shared_ptr<TextureArray>> *inTerrainTextureArrays,
+    WaterFrameBuffer *inReflectionBuffer,
+    WaterFrameBuffer *inRefractionBuffer,
+    const vector<shared_ptr<Texture>> *inOceanTextures
 ):
     id(inId),
     size(settings->getSubChunkSize()),
     resolution(settings->getSubChunkResolution()),
     parentChunk(inParentChunk),
     subChunkCoords(inSubChunkCoords),
-    heights(inHeights),
-    biomes(inBiomes),
-    terrainShader(inTerrainShader),
-    oceanShader(inOceanShader),
-    terrainTextures(inTerrainTextures),
-    reflectionBuffer(inReflectionBuffer),
-    refractionBuffer(inRefractionBuffer),
-    oceanTextures(inOceanTextures)
-{
-    // Generate the terrain object for the subchunk
-    terrain = make_shared<Terrain>(
-        inHeights,
-        make_shared<vector<vector<uint8_t>>>(inBiomes),
+    heights(std::move(inHeights)),
+    // Generate the terrain and ocean objects for the subchunk
+    terrain(
+        getHeightView(),
         settings,
         getSubChunkWorldCoords(settings),
         inTerrainShader,
         inTerrainTextures,
-        parentChunk->getTerrainTextureArrays(),
-        parentChunk->getSubbiomeTextureArrayMap()
-    );
-
-    ocean = make_shared<Ocean>(
+        inTerrainTextureArrays,
+        inParentChunk->getSubbiomeTextureArrayMap()
+    ),
+    ocean(
         vector<float>{0.0f, 0.0f},
         getSubChunkWorldCoords(settings),
         settings,
@@ -131,7 +254,10 @@ SubChunk::SubChunk(
         inReflectionBuffer,
         inRefractionBuffer,
         inOceanTextures
-    );
+    )
+{
+    computeHeightRange();
+    computeHorizonBounds(settings);
 }
 
 /**
@@ -142,71 +268,71 @@ SubChunk::SubChunk(
  * for the subchunk.
  * 
  * @param inId [in] int The id of the subchunk
- * @param inParentChunk [in] std::shared_ptr<Chunk> The parent chunk of the subchunk
- * @param settings [in] std::shared_ptr<Settings> The settings object
+ * @param inParentChunk [in] Chunk* The parent chunk of the subchunk, which must outlive it
+ * @param settings [in] Settings* The settings object
  * @param inResolution [in] float The resolution of the subchunk
  * @param inSubChunkCoords [in] std::vector<int> The local coordinates of the subchunk
- * @param inHeights [in] std::vector<std::vector<float>> The heights of the subchunk
- * @param inBiomes [in] std::vector<std::vector<uint8_t>> The biomes of the subchunk
- * @param inTerrainShader [in] std::shared_ptr<Shader> The shader for the terrain
- * @param inOceanShader [in] std::shared_ptr<Shader> The shader for the ocean
- * @param inTerrainTextures [in] std::vector<std::shared_ptr<Texture>> The textures for the terrain
- * @param inReflectionBuffer [in] std::shared_ptr<WaterFrameBuffer> The reflection buffer for the ocean
- * @param inRefractionBuffer [in] std::shared_ptr<WaterFrameBuffer> The refraction buffer for the ocean
- * @param inOceanTextures [in] std::vector<std::shared_ptr<Texture>> The textures for the ocean
+ * @param inHeights [in] std::vector<float> The heights of the subchunk including the border stored row by row
+ * @param inTerrainShader [in] Shader* The shader for the terrain
+ * @param inOceanShader [in] Shader* The shader for the ocean
+ * @param inTerrainTextures [in] const std::vector<std::shared_ptr<Texture>>* The textures for the terrain
+ * @param inTerrainTextureArrays [in] const std::vector<std::shared_ptr<TextureArray>>* The texture arrays for the terrain
+ * @param inReflectionBuffer [in] WaterFrameBuffer* The reflection buffer for the ocean
+ * @param inRefractionBuffer [in] WaterFrameBuffer* The refraction buffer for the ocean
+ * @param inOceanTextures [in] const std::vector<std::shared_ptr<Texture>>* The textures for the ocean
+ * @param inSpacing [in] float The number of world units between the heightmap values, which is
+ * larger than 1 when the subchunk is a coarse quadtree patch covering several subchunks
  * 
  */
 SubChunk::SubChunk(
     int inId,
-    shared_ptr<Chunk> inParentChunk,
-    shared_ptr<Settings> settings,
+    Chunk *inParentChunk,
+    Settings *settings,
     float inResolution,
     vector<int> inSubChunkCoords,
-    vector<vector<float>> inHeights,
-    vector<vector<uint8_t>> inBiomes,
-    shared_ptr<Shader> inTerrainShader,
-    shared_ptr<Shader> inOceanShader,
-    vector<shared_ptr<Texture>> inTerrainTextures,
-    shared_ptr<WaterFrameBuffer> inReflectionBuffer,
-    shared_ptr<WaterFrameBuffer> inRefractionBuffer,
-    vector<shared_ptr<Texture>> inOceanTextures
+    vector<float> inHeights,
+    Shader *inTerrainShader,
+    Shader *inOceanShader,
+    const vector<shared_ptr<Texture>> *inTerrainTextures,
+    const vector<shared_ptr<TextureArray>> *inTerrainTextureArrays,
+    WaterFrameBuffer *inReflectionBuffer,
+    WaterFrameBuffer *inRefractionBuffer,
+    const vector<shared_ptr<Texture>> *inOceanTextures,
+    float inSpacing
 ):
     id(inId),
     size(settings->getSubChunkSize()),
     resolution(inResolution),
     parentChunk(inParentChunk),
     subChunkCoords(inSubChunkCoords),
-    heights(inHeights),
-    biomes(inBiomes),
-    terrainShader(inTerrainShader),
-    oceanShader(inOceanShader),
-    terrainTextures(inTerrainTextures),
-    reflectionBuffer(inReflectionBuffer),
-    refractionBuffer(inRefractionBuffer),
-    oceanTextures(inOceanTextures)
-{
-    // Generate the terrain object for the subchunk
-    terrain = make_shared<Terrain>(
-        inHeights,
-        make_shared<vector<vector<uint8_t>>>(inBiomes),
+    heights(std::move(inHeights)),
+    spacing(inSpacing),
+    // Generate the terrain and ocean objects for the subchunk
+    terrain(
+        getHeightView(),
         inResolution,
         settings,
         getSubChunkWorldCoords(settings),
         inTerrainShader,
         inTerrainTextures,
-        parentChunk->getTerrainTextureArrays(),
-        parentChunk->getSubbiomeTextureArrayMap()
-    );
-
-    ocean = make_shared<Ocean>(
+        inTerrainTextureArrays,
+        inParentChunk->getSubbiomeTextureArrayMap(),
+        inSpacing,
+        getMorphOffset(settings->getSubChunkSize(), inResolution, inSubChunkCoords, inSpacing)
+    ),
+    ocean(
         vector<float>{0.0f, 0.0f},
         getSubChunkWorldCoords(settings),
         settings,
         inOceanShader,
         inReflectionBuffer,
         inRefractionBuffer,
-        inOceanTextures
-    );
+        inOceanTextures,
+        inSpacing
+    )
+{
+    computeHeightRange();
+    computeHorizonBounds(settings);
 }
 
 /**
@@ -245,26 +371,144 @@ void SubChunk::render(
 )
 {
     // We only want to render the terrain to produce the reflection or refraction buffers
-    terrain->render(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
+    renderTerrain(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
     // Enable alpha belending for the ocean
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     if (!isWaterPass){
-        ocean->render(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
+        renderOcean(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
     }
     // Disable alpha blending for the terrain
     glDisable(GL_BLEND);
 }
 
+/**
+ * @brief Renders the terrain of the subchunk
+ * 
+ * @details The heightmap, biome map and normal map shared by the whole chunk must already be bound
+ * by the chunk.
+ * 
+ * @param view [in] glm::mat4 The view matrix
+ * @param projection [in] glm::mat4 The projection matrix
+ * @param lights [in] std::vector<std::shared_ptr<Light>> The lights in the scene
+ * @param viewPos [in] glm::vec3 The position of the camera
+ * @param isWaterPass [in] bool Whether the water pass is being rendered
+ * @param isShadowPass [in] bool Whether the shadow pass is being rendered
+ * @param plane [in] glm::vec4 The plane used for the water pass
+ * 
+ * @return void
+ * 
+ */
+void SubChunk::renderTerrain(
+    glm::mat4 view,
+    glm::mat4 projection,
+    vector<shared_ptr<Light>> lights,
+    glm::vec3 viewPos,
+    bool isWaterPass,
+    bool isShadowPass,
+    glm::vec4 plane
+)
+{
+    terrain.render(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
+}
+
+/**
+ * @brief Renders the ocean of the subchunk
+ * 
+ * @details The ocean is not drawn while the subchunk is fading out, and alpha blending must
+ * already be enabled by the caller.
+ * 
+ * @param view [in] glm::mat4 The view matrix
+ * @param projection [in] glm::mat4 The projection matrix
+ * @param lights [in] std::vector<std::shared_ptr<Light>> The lights in the scene
+ * @param viewPos [in] glm::vec3 The position of the camera
+ * @param isWaterPass [in] bool Whether the water pass is being rendered
+ * @param isShadowPass [in] bool Whether the shadow pass is being rendered
+ * @param plane [in] glm::vec4 The plane used for the water pass
+ * 
+ * @return void
+ * 
+ */
+void SubChunk::renderOcean(
+    glm::mat4 view,
+    glm::mat4 projection,
+    vector<shared_ptr<Light>> lights,
+    glm::vec3 viewPos,
+    bool isWaterPass,
+    bool isShadowPass,
+    glm::vec4 plane
+)
+{
+    if (!fadingOut){
+        ocean.render(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
+    }
+}
+
 /**
  * @brief This method will set up the data for the subchunk
  * 
- * @details Currently this method does nothing as the data is already set up in the constructor.
+ * @details The constructor only builds the CPU side of the terrain and ocean so that subchunks can
+ * be built on worker threads. This uploads their buffers to the GPU and so it must be called on
+ * the thread that owns the OpenGL context before the subchunk is rendered. The buffers are checked
+ * out from the buffer pool of the parent chunk. The parent chunk binds its heightmap, biome map and
+ * normal map while drawing, so the terrain is only given its origin within each of them, and the
+ * heightmap and normal map are uploaded here the first time they are needed.
  * 
  */
 void SubChunk::setupData()
 {
-    // Do nothing
+    terrain.setBufferPool(parentChunk->getBufferPool().get());
+    ocean.setBufferPool(parentChunk->getBufferPool().get());
+    if (terrain.isDisplacedOnGpu()){
+        // The heightmap is uploaded the first time it is requested and the grid starts at the
+        // first heightmap value inside the border of the subchunk
+        parentChunk->getHeightTexture();
+        terrain.setHeightMapOrigin(glm::vec2(subChunkCoords[0] + 1, subChunkCoords[1] + 1));
+    }
+    // The biome and normal maps of the parent chunk also have a border so the terrain starts one texel in
+    terrain.setBiomeMapOrigin(glm::vec2(subChunkCoords[0] + 1, subChunkCoords[1] + 1));
+    if (parentChunk->getNormalTexture() != 0){
+        terrain.setNormalMapOrigin(glm::vec2(subChunkCoords[0] + 1, subChunkCoords[1] + 1));
+    }
+    terrain.setupData();
+    ocean.setupData();
+}
+
+/**
+ * @brief This method will return the GPU memory used by the subchunk
+ * 
+ * @return size_t The size in bytes of the GPU buffers and textures of the terrain and ocean
+ * 
+ */
+size_t SubChunk::getGpuBytes()
+{
+    return terrain.getGpuBytes() + ocean.getGpuBytes();
+}
+
+/**
+ * @brief This method will return the CPU memory kept by the subchunk to upload it again
+ * 
+ * @return size_t The size in bytes of the packed terrain mesh and the heights
+ * 
+ */
+size_t SubChunk::getCpuBytes()
+{
+    return terrain.getCpuBytes() + heights.capacity() * sizeof(float);
+}
+
+/**
+ * @brief This method will free the GPU buffers of the subchunk while keeping its packed mesh
+ * 
+ * @details The subchunk can be drawn again after calling setupData, which uploads the packed mesh
+ * without building it again. This must be called on the thread that owns the OpenGL context.
+ * 
+ * @return void
+ * 
+ */
+void SubChunk::releaseGpuData()
+{
+    terrain.releaseData();
+    ocean.releaseData();
 }
 
 /**
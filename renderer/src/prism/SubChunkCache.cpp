@@ -0,0 +1,277 @@
+/**
+ * @file SubChunkCache.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the SubChunkCache class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+#include "SubChunkCache.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new SubChunkCache object
+ *
+ * @param inGpuBudget [in] size_t The most GPU memory the GPU tier may use in bytes
+ * @param inCpuBudget [in] size_t The most CPU memory the CPU tier may use in bytes
+ *
+ */
+SubChunkCache::SubChunkCache(size_t inGpuBudget, size_t inCpuBudget):
+    gpuBudget(inGpuBudget),
+    cpuBudget(inCpuBudget),
+    gpuTierBytes(0),
+    cpuTierBytes(0),
+    gpuHits(0),
+    cpuHits(0),
+    misses(0),
+    demotions(0),
+    evictions(0)
+{
+}
+
+/**
+ * @brief This function will add a subchunk that is no longer drawn to the GPU tier
+ *
+ * @details An existing entry for the same subchunk is replaced without being evicted, as the chunk
+ * has already replaced the subchunk itself. The budgets are enforced afterwards, which may demote
+ * or evict the new entry straight away when it is larger than a budget.
+ *
+ * @param owner [in] const void* The chunk that owns the subchunk
+ * @param id [in] int The id of the subchunk within the chunk
+ * @param gpuBytes [in] size_t The GPU memory used by the subchunk
+ * @param cpuBytes [in] size_t The CPU memory used by the packed mesh of the subchunk
+ * @param demote [in] std::function<void()> Frees the GPU buffers of the subchunk
+ * @param evict [in] std::function<void()> Destroys the subchunk
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::insert(
+    const void *owner,
+    int id,
+    size_t gpuBytes,
+    size_t cpuBytes,
+    function<void()> demote,
+    function<void()> evict
+){
+    lock_guard<mutex> lock(cacheMutex);
+    auto found = lookup.find(make_pair(owner, id));
+    if (found != lookup.end()){
+        erase(found->second);
+    }
+    entries.push_front(Entry{owner, id, CacheTier::GPU, gpuBytes, cpuBytes, demote, evict});
+    lookup[make_pair(owner, id)] = entries.begin();
+    gpuTierBytes += gpuBytes;
+    enforceBudgets();
+}
+
+/**
+ * @brief This function will determine whether a subchunk is held by the cache
+ *
+ * @param owner [in] const void* The chunk that owns the subchunk
+ * @param id [in] int The id of the subchunk within the chunk
+ *
+ * @return bool Whether the subchunk is held in either tier
+ *
+ */
+bool SubChunkCache::contains(const void *owner, int id) const{
+    lock_guard<mutex> lock(cacheMutex);
+    return lookup.find(make_pair(owner, id)) != lookup.end();
+}
+
+/**
+ * @brief This function will return the tier a subchunk is held in
+ *
+ * @param owner [in] const void* The chunk that owns the subchunk
+ * @param id [in] int The id of the subchunk within the chunk, which must be held by the cache
+ *
+ * @return CacheTier The tier of the subchunk
+ *
+ */
+CacheTier SubChunkCache::getTier(const void *owner, int id) const{
+    lock_guard<mutex> lock(cacheMutex);
+    return lookup.at(make_pair(owner, id))->tier;
+}
+
+/**
+ * @brief This function will record that a subchunk is being drawn again and stop tracking it
+ *
+ * @param owner [in] const void* The chunk that owns the subchunk
+ * @param id [in] int The id of the subchunk within the chunk
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::take(const void *owner, int id){
+    lock_guard<mutex> lock(cacheMutex);
+    auto found = lookup.find(make_pair(owner, id));
+    if (found == lookup.end()){
+        return;
+    }
+    if (found->second->tier == CacheTier::GPU){
+        gpuHits++;
+    } else {
+        cpuHits++;
+    }
+    erase(found->second);
+}
+
+/**
+ * @brief This function will stop tracking a subchunk that its chunk has destroyed or replaced
+ *
+ * @param owner [in] const void* The chunk that owns the subchunk
+ * @param id [in] int The id of the subchunk within the chunk
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::remove(const void *owner, int id){
+    lock_guard<mutex> lock(cacheMutex);
+    auto found = lookup.find(make_pair(owner, id));
+    if (found != lookup.end()){
+        erase(found->second);
+    }
+}
+
+/**
+ * @brief This function will stop tracking every subchunk of a chunk that is being removed
+ *
+ * @param owner [in] const void* The chunk that owns the subchunks
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::removeOwner(const void *owner){
+    lock_guard<mutex> lock(cacheMutex);
+    for (auto entry = entries.begin(); entry != entries.end();){
+        auto next = std::next(entry);
+        if (entry->owner == owner){
+            erase(entry);
+        }
+        entry = next;
+    }
+}
+
+/**
+ * @brief This function will evict every subchunk whose chunk is not in the given list
+ *
+ * @details This is used when chunks are removed from the world, so the memory held by their cached
+ * subchunks is freed straight away rather than waiting for the budgets to reach it.
+ *
+ * @param owners [in] const std::vector<const void*>& The chunks that are still in the world
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::retainOwners(const vector<const void *> &owners){
+    lock_guard<mutex> lock(cacheMutex);
+    for (auto entry = entries.begin(); entry != entries.end();){
+        auto next = std::next(entry);
+        if (find(owners.begin(), owners.end(), entry->owner) == owners.end()){
+            entry->evict();
+            erase(entry);
+            evictions++;
+        }
+        entry = next;
+    }
+}
+
+/**
+ * @brief This function will stop tracking every subchunk
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::clear(){
+    lock_guard<mutex> lock(cacheMutex);
+    entries.clear();
+    lookup.clear();
+    gpuTierBytes = 0;
+    cpuTierBytes = 0;
+}
+
+/**
+ * @brief This function will record that a subchunk was not cached and had to be built
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::recordMiss(){
+    lock_guard<mutex> lock(cacheMutex);
+    misses++;
+}
+
+/**
+ * @brief This function will return the fraction of subchunk requests served by the cache
+ *
+ * @return float The hit rate over both tiers, zero before any request
+ *
+ */
+float SubChunkCache::getHitRate() const{
+    lock_guard<mutex> lock(cacheMutex);
+    long requests = gpuHits + cpuHits + misses;
+    if (requests == 0){
+        return 0.0f;
+    }
+    return static_cast<float>(gpuHits + cpuHits) / static_cast<float>(requests);
+}
+
+/**
+ * @brief This function will demote and evict the least recently used subchunks until both tiers are
+ * within their budgets
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::enforceBudgets(){
+    vector<list<Entry>::iterator> leastRecent;
+    for (auto entry = entries.end(); entry != entries.begin() && gpuTierBytes > gpuBudget;){
+        --entry;
+        if (entry->tier == CacheTier::GPU){
+            entry->demote();
+            entry->tier = CacheTier::CPU;
+            gpuTierBytes -= entry->gpuBytes;
+            cpuTierBytes += entry->cpuBytes;
+            demotions++;
+        }
+    }
+    for (auto entry = entries.end(); entry != entries.begin();){
+        --entry;
+        if (entry->tier == CacheTier::CPU){
+            leastRecent.push_back(entry);
+        }
+    }
+    for (size_t i = 0; i < leastRecent.size() && cpuTierBytes > cpuBudget; i++){
+        leastRecent[i]->evict();
+        erase(leastRecent[i]);
+        evictions++;
+    }
+}
+
+/**
+ * @brief This function will remove an entry and its bytes from its tier
+ *
+ * @param entry [in] std::list<Entry>::iterator The entry to remove
+ *
+ * @return void
+ *
+ */
+void SubChunkCache::erase(list<Entry>::iterator entry){
+    if (entry->tier == CacheTier::GPU){
+        gpuTierBytes -= entry->gpuBytes;
+    } else {
+        cpuTierBytes -= entry->cpuBytes;
+    }
+    lookup.erase(make_pair(entry->owner, entry->id));
+    entries.erase(entry);
+}
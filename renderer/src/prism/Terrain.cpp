@@ -13,6 +13,10 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
 #include <omp.h>
 
 #ifdef DEPARTMENT_BUILD
@@ -32,246 +36,395 @@
 #include "Vertex.hpp"
 #include "Utility.hpp"
 #include "Settings.hpp"
+#include "TerrainLod.hpp"
+#include "GpuBufferPool.hpp"
+#include "MeshIndexing.hpp"
+#include "AdaptiveTriangulation.hpp"
+#include "HeightUpsampler.hpp"
+#include "ScratchArena.hpp"
+#include "TerrainVertex.hpp"
 #include "Terrain.hpp"
 
 using namespace std;
 
 /**
- * @brief This function will generate the render vertices for the terrain heightmap values
+ * @brief This function will generate the heights of the render vertices for the terrain heightmap values
  * 
- * @details This function will generate the render vertices for the terrain heightmap values. It
- * will scaling the heightmap values by the height scaling factor. If there is no pixel in the
- * heightmap then it will use bicubic interpolation to get the height of the created vertex.
+ * @details This function will generate the heights of the render vertices for the terrain
+ * heightmap values, including the border. It will scale the heightmap values by the height
+ * scaling factor. If there is no pixel in the heightmap then it will use bicubic interpolation to
+ * get the height of the created vertex. The render vertex (i, j) lies i / resolution and
+ * j / resolution heightmap values from the first value of the border.
  * 
- * @param inHeights [in] std::vector<std::vector<float>> The heightmap values
+ * When the resolution is a whole number the heights are upsampled in one separable pass by the
+ * HeightUpsampler, otherwise each vertex is interpolated on its own. The heights and the memory
+ * used while generating them are taken from the scratch arena, so they are only valid until the
+ * caller closes its scope.
+ * 
+ * @param inHeights [in] const HeightView& The heightmap values including the border
  * @param heightScalingFactor [in] float The height scaling factor
+ * @param arena [in] ScratchArena& The arena of the calling thread
  * 
- * @return std::vector<std::vector<glm::vec3>> The render vertices for the terrain
+ * @return float* The heights of the render vertices stored row by row
  * 
  */
-vector<vector<glm::vec3>> Terrain::generateRenderVertices(
-    vector<vector<float>> inHeights,
-    float heightScalingFactor
+float *Terrain::generateRenderHeights(
+    const HeightView &inHeights,
+    float heightScalingFactor,
+    ScratchArena &arena
 ){
     // The resolution determines the number of rendered vertices that will be generated between
     // the heightmap vertices of the subchunk. If the resolution is 1 then the subchunk will be
     // rendered with the same number of vertices as the heightmap vertices.
     int numberOfVerticesPerAxis = (size+2) * resolution;
-    vector<vector<glm::vec3>> renderVertices = vector<vector<glm::vec3>>(numberOfVerticesPerAxis, vector<glm::vec3>(numberOfVerticesPerAxis));
-    // How much each step needs to change in the x and z direction to get the next vertex
-    float stepSize = static_cast<float>(size + 2) / static_cast<float>(numberOfVerticesPerAxis);
+    int heightsPerAxis = size + 2;
+    int renderHeightCount = numberOfVerticesPerAxis * numberOfVerticesPerAxis;
+    float *renderHeights = arena.allocate<float>(renderHeightCount);
+
+    int factor = static_cast<int>(resolution);
+    if (factor >= 1 && static_cast<float>(factor) == resolution){
+        // The heights are already stored row by row so the upsampler streams through them directly
+        float *scratch = arena.allocate<float>(HeightUpsampler::getScratchSize(heightsPerAxis, heightsPerAxis, factor));
+        HeightUpsampler::upsample(inHeights, factor, renderHeights, scratch);
+        #pragma omp simd
+        for (int i = 0; i < renderHeightCount; i++){
+            renderHeights[i] = Utility::height_scaling(renderHeights[i], heightScalingFactor);
+        }
+        return renderHeights;
+    }
 
-    // We are going to assume that our chunk has a 1 vertex border around the edge of the chunk
-    // resulting in (size+2) x (size+2) values from the heightmap. We only want to generate the
-    #pragma omp parallel for
-    for (int i = 0; i < numberOfVerticesPerAxis; i++){
-        for (int j = 0; j < numberOfVerticesPerAxis; j++){
+    // How much each step needs to change in the x and z direction to get the next vertex
+    float stepSize = static_cast<float>(heightsPerAxis) / static_cast<float>(numberOfVerticesPerAxis);
+    for (int j = 0; j < numberOfVerticesPerAxis; j++){
+        for (int i = 0; i < numberOfVerticesPerAxis; i++){
             // We need to calculate the position of the vertex in the heightmap that we are going to
             // interpolate from
             float x = i * stepSize;
             float z = j * stepSize;
-            // We need to calculate the position of the vertex in the heightmap that we are going to
-            // interpolate from
-            int x1 = static_cast<int>(x);
-            int x2 = static_cast<int>(x + 1);
-            int z1 = static_cast<int>(z);
-            int z2 = static_cast<int>(z + 1);
-            // We can check if the vertex will be on a whole vertex and then not need to complete
-            // the interpolation
-            if ((x2 >= size+2 || z2 >= size+2) || (x1 == x && z1 == z && x2 == x+1 && z2 == z+1)){
-                renderVertices[j][i] = glm::vec3(
-                    x,
-                    Utility::height_scaling(inHeights[z1][x1], heightScalingFactor),
-                    z
-                );
-            } else {
-                // We need to interpolate the height of the vertex from the heightmap
-                float height = Utility::bicubic_interpolation(
-                    glm::vec2(x, z),
-                    inHeights
-                );
-                renderVertices[j][i] = glm::vec3(
-                    x,
-                    Utility::height_scaling(height, heightScalingFactor),
-                    z
-                );
-            }
+            float height = HeightUpsampler::sample(inHeights, x, z);
+            renderHeights[j * numberOfVerticesPerAxis + i] = Utility::height_scaling(height, heightScalingFactor);
         }
     }
-    return renderVertices;
+    return renderHeights;
 }
 
 /**
- * @brief This function will compute the normal contribution for a triangle
+ * @brief This function will generate the index buffer for the terrain
  * 
- * @details This function will compute the normal contribution for a triangle. It will take the
- * three vertices of the triangle and calculate the normal contribution using the cross product
- * of the two edges of the triangle.
+ * @details This function will generate the index buffer for the terrain. The quads are emitted
+ * in vertical stripes that are narrow enough for the vertices shared by neighbouring rows to stay
+ * in the post-transform vertex cache, so each vertex is shaded close to once rather than twice.
+ * The triangles are the same as a plain row by row order, only the order they are drawn in
+ * changes.
  * 
- * @param A [in] glm::vec3 The first vertex of the triangle
- * @param B [in] glm::vec3 The second vertex of the triangle
- * @param C [in] glm::vec3 The third vertex of the triangle
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis
  * 
- * @return glm::vec3 The normal contribution for the triangle
+ * @return std::vector<unsigned int> The index buffer for the terrain
  * 
  */
-glm::vec3 Terrain::computeNormalContribution(glm::vec3 A, glm::vec3 B, glm::vec3 C){
-    return glm::normalize(glm::cross(B - A, C - A));
+vector<unsigned int> Terrain::generateIndexBuffer(int numberOfVerticesPerAxis){
+    return MeshIndexing::generateStripeOrderIndices(
+        numberOfVerticesPerAxis,
+        MeshIndexing::getStripeWidth(MeshIndexing::DEFAULT_CACHE_SIZE)
+    );
 }
 
 /**
- * @brief This function will generate the index buffer for the terrain
+ * @brief This function will build the compact vertices of the terrain from the heights of its
+ * render vertices
+ * 
+ * @details The vertices are written straight into the layout that is uploaded, so the positions,
+ * normals and morph targets are never held anywhere else. The border of the heights is only read
+ * as the neighbours of the vertices along the edges, both for their normals and for their morph
+ * targets. A first pass finds the height range the vertices are quantised over and the lowest
+ * height along each edge for the skirts, then a second pass writes each grid vertex followed by
+ * the bottom row of each skirt. Both passes run serially on the calling thread as the subchunks
+ * are built in parallel with each other.
+ * 
+ * The normal of a vertex is found from the central differences of the heights of its four
+ * neighbours. When the normals are baked into a normal map of the chunk the shader lights the
+ * terrain from that instead, so the vertices are given the up vector and the per vertex normals
+ * are not worked out at all. The morph target of a vertex is its height in the mesh of the next coarser level of
+ * detail, which has half the resolution. Vertices on even rows and columns of the coarser grid
+ * exist in both meshes so they keep their height. The other vertices lie on an edge of a coarser
+ * triangle and take the average of the two coarser vertices at the ends of that edge, following
+ * the same diagonal as the index buffer, and the morph offset shifts the parity when the coarser
+ * grid does not start at the first vertex of this mesh.
+ * 
+ * Neighbouring subchunks can have different resolutions, so the vertices along their shared edge
+ * do not always line up and small cracks can appear between them. The skirt is a vertical strip
+ * hanging from every edge of the mesh down to lodSkirtDepth below the lowest vertex on that edge,
+ * which hides the cracks. Only the bottom row of each skirt is added here, the triangles joining
+ * it to the edge vertices are part of the shared index buffer from generateSkirtIndices.
+ * 
+ * @param renderHeights [in] const float* The heights of the render vertices including the border
  * 
- * @details This function will generate the index buffer for the terrain. It will create a
- * triangle strip for each row of vertices in the heightmap. The index buffer will be used to
- * render the terrain.
- * 
- * @param numberOfVerticesPerAxis [in] int The number of vertices per axis
- * 
- * @return std::vector<unsigned int> The index buffer for the terrain
+ * @return void
  * 
  */
-vector<unsigned int> Terrain::generateIndexBuffer(int numberOfVerticesPerAxis){
-    // The resolution determines the number of rendered vertices that will be generated between
-    // the heightmap vertices of the subchunk. If the resolution is 1 then the subchunk will be
-    // rendered with the same number of vertices as the heightmap vertices.
-    // float stepSize = static_cast<float>(size+2) / static_cast<float>(resolution);
-    vector<unsigned int> indices = vector<unsigned int>((numberOfVerticesPerAxis - 1) * (numberOfVerticesPerAxis - 1) * 6);
-
-    #pragma omp parallel for
-    for (int x = 0; x < numberOfVerticesPerAxis - 1; x++){
-        for (int z = 0; z < numberOfVerticesPerAxis - 1; z++){
-            // First triangle of the form [x,z], [x+1, z], [x+1, z+1]
-            indices[(x * (numberOfVerticesPerAxis - 1) * 6 + z * 6)] = x * numberOfVerticesPerAxis + z;
-            indices[(x * (numberOfVerticesPerAxis - 1) * 6 + z * 6) + 1] = (x + 1) * numberOfVerticesPerAxis + z;
-            indices[(x * (numberOfVerticesPerAxis - 1) * 6 + z * 6) + 2] = (x + 1) * numberOfVerticesPerAxis + z + 1;
-            // Second triangle of the form [x,z], [x+1, z+1], [x, z+1]
-            indices[(x * (numberOfVerticesPerAxis - 1) * 6 + z * 6) + 3] = x * numberOfVerticesPerAxis + z;
-            indices[(x * (numberOfVerticesPerAxis - 1) * 6 + z * 6) + 4] = (x + 1) * numberOfVerticesPerAxis + z + 1;
-            indices[(x * (numberOfVerticesPerAxis - 1) * 6 + z * 6) + 5] = x * numberOfVerticesPerAxis + z + 1;
+void Terrain::buildCompactVertices(const float *renderHeights){
+    int border = static_cast<int>(resolution);
+    int borderedVerticesPerAxis = static_cast<int>((size + 2) * resolution);
+    int numberOfVerticesPerAxis = static_cast<int>((size - 1) * resolution + 1);
+    float vertexSpacing = spacing / resolution;
+    const float *heights = renderHeights;
+    const int *offset = morphOffset.data();
+
+    auto heightAt = [heights, borderedVerticesPerAxis](int u, int v){
+        return heights[v * borderedVerticesPerAxis + u];
+    };
+    auto morphTargetAt = [heightAt, border, offset](int x, int z){
+        int u = x + border;
+        int v = z + border;
+        bool oddX = (x + offset[0]) % 2 == 1;
+        bool oddZ = (z + offset[1]) % 2 == 1;
+        if (!oddX && !oddZ){
+            return heightAt(u, v);
+        } else if (oddX && oddZ){
+            return 0.5f * (heightAt(u - 1, v - 1) + heightAt(u + 1, v + 1));
+        } else if (oddX){
+            return 0.5f * (heightAt(u - 1, v) + heightAt(u + 1, v));
+        }
+        return 0.5f * (heightAt(u, v - 1) + heightAt(u, v + 1));
+    };
+    auto normalAt = [heightAt, border, vertexSpacing](int x, int z){
+        int u = x + border;
+        int v = z + border;
+        // The slope along each axis is the change in height over the distance between the
+        // neighbours, which is the normal (-dy/dx, 1, -dy/dz) before it is normalised
+        float slopeX = (heightAt(u + 1, v) - heightAt(u - 1, v)) / (2.0f * vertexSpacing);
+        float slopeZ = (heightAt(u, v + 1) - heightAt(u, v - 1)) / (2.0f * vertexSpacing);
+        return glm::normalize(glm::vec3(-slopeX, 1.0f, -slopeZ));
+    };
+    bool bakedNormals = settings->getBakedNormalMaps();
+    glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+    // The grid indices of the vertex i along each edge, in the order of generateSkirtIndices
+    auto edgeVertex = [numberOfVerticesPerAxis](int edge, int i){
+        switch (edge){
+            case 0: return glm::ivec2(i, 0);
+            case 1: return glm::ivec2(i, numberOfVerticesPerAxis - 1);
+            case 2: return glm::ivec2(0, i);
+            default: return glm::ivec2(numberOfVerticesPerAxis - 1, i);
+        }
+    };
+
+    // Every morph target is the average of heights within one vertex of the grid, so the heights
+    // of the grid and the innermost ring of the border bound both
+    float lowestHeight = heightAt(border, border);
+    float highestHeight = lowestHeight;
+    for (int v = border - 1; v <= border + numberOfVerticesPerAxis; v++){
+        #pragma omp simd reduction(min:lowestHeight) reduction(max:highestHeight)
+        for (int u = border - 1; u <= border + numberOfVerticesPerAxis; u++){
+            lowestHeight = min(lowestHeight, heightAt(u, v));
+            highestHeight = max(highestHeight, heightAt(u, v));
+        }
+    }
+    float skirtHeights[4];
+    for (int edge = 0; edge < 4; edge++){
+        float lowestEdgeHeight = highestHeight;
+        for (int i = 0; i < numberOfVerticesPerAxis; i++){
+            glm::ivec2 vertex = edgeVertex(edge, i);
+            lowestEdgeHeight = min(lowestEdgeHeight, heightAt(vertex.x + border, vertex.y + border));
+            lowestEdgeHeight = min(lowestEdgeHeight, morphTargetAt(vertex.x, vertex.y));
+        }
+        skirtHeights[edge] = lowestEdgeHeight - settings->getLodSkirtDepth();
+        lowestHeight = min(lowestHeight, skirtHeights[edge]);
+    }
+    heightRange = glm::vec2(lowestHeight, highestHeight - lowestHeight);
+
+    int gridVertexCount = numberOfVerticesPerAxis * numberOfVerticesPerAxis;
+    compactVertices = vector<TerrainVertex>(gridVertexCount + 4 * numberOfVerticesPerAxis);
+    for (int z = 0; z < numberOfVerticesPerAxis; z++){
+        for (int x = 0; x < numberOfVerticesPerAxis; x++){
+            compactVertices[z * numberOfVerticesPerAxis + x] = TerrainVertex(
+                x,
+                z,
+                TerrainVertex::quantiseHeight(heightAt(x + border, z + border), heightRange.x, heightRange.y),
+                TerrainVertex::quantiseHeight(morphTargetAt(x, z), heightRange.x, heightRange.y),
+                bakedNormals ? up : normalAt(x, z)
+            );
+        }
+    }
+    // The bottom row of each skirt shares the normal of the edge above it and does not morph
+    for (int edge = 0; edge < 4; edge++){
+        uint16_t skirtHeight = TerrainVertex::quantiseHeight(skirtHeights[edge], heightRange.x, heightRange.y);
+        for (int i = 0; i < numberOfVerticesPerAxis; i++){
+            glm::ivec2 vertex = edgeVertex(edge, i);
+            compactVertices[gridVertexCount + edge * numberOfVerticesPerAxis + i] = TerrainVertex(
+                vertex.x,
+                vertex.y,
+                skirtHeight,
+                skirtHeight,
+                bakedNormals ? up : normalAt(vertex.x, vertex.y)
+            );
         }
     }
-    return indices;
 }
 
 /**
- * @brief This function will generate the normals for the terrain
+ * @brief This function will generate the indices of the skirt triangles of a terrain mesh
  * 
- * @details This function will generate the normals for the terrain. It will loop through all of
- * the faces and calculate the normal contributions for each face on their vertices. We will then
- * normalise the final contribution.
+ * @details The skirt vertices follow the grid vertices with one row of numberOfVerticesPerAxis
+ * vertices for each edge, in the order they are added by buildCompactVertices. The top of the skirt
+ * reuses the edge vertices so it follows them as they morph. The skirt is emitted with both
+ * windings as it can be seen from either side.
  * 
- * @param inVertices [in] std::vector<std::vector<glm::vec3>> The vertices of the terrain
- * @param inIndices [in] std::vector<unsigned int> The index buffer for the terrain
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the cropped mesh
  * 
- * @return std::vector<std::vector<glm::vec3>> The normals for the terrain
+ * @return std::vector<unsigned int> The indices of the skirt triangles
  * 
  */
-vector<vector<glm::vec3>> Terrain::generateNormals(vector<vector<glm::vec3>> inVertices, vector<unsigned int> inIndices){
-    // Loop through all of the faces and calculate the normal contributions for each face on their
-    // vertices. We will then normalise the final contribution
-    vector<vector<glm::vec3>> normals = vector<vector<glm::vec3>>(inVertices.size(), vector<glm::vec3>(inVertices[0].size()));
-
-    // Loop all of the faces using the index buffer
-    #pragma omp parallel for
-    for (int i = 0; i < static_cast<int> (inIndices.size()); i += 3){
-        // Get the three vertices of the triangle
-        unsigned int indexA = inIndices[i];
-        unsigned int indexB = inIndices[i+1];
-        unsigned int indexC = inIndices[i+2];
-        // Convert the indices to the 2d array indices
-        unsigned int xA = indexA % inVertices[0].size();
-        unsigned int zA = indexA / inVertices[0].size();
-        unsigned int xB = indexB % inVertices[0].size();
-        unsigned int zB = indexB / inVertices[0].size();
-        unsigned int xC = indexC % inVertices[0].size();
-        unsigned int zC = indexC / inVertices[0].size();
-        glm::vec3 A = inVertices[zA][xA];
-        glm::vec3 B = inVertices[zB][xB];
-        glm::vec3 C = inVertices[zC][xC];
-        // Calculate the normal contribution for the face
-        glm::vec3 normal = computeNormalContribution(A, B, C);
-        // Add the normal contribution to the vertices
-        normals[zA][xA] += normal;
-        normals[zB][xB] += normal;
-        normals[zC][xC] += normal;
-    }
-
-    // Normalise the contributions
-    #pragma omp parallel for
-    for (int z = 0; z < static_cast<int> (normals.size()); z++){
-        for (int x = 0; x < static_cast<int> (normals[0].size()); x++){
-            normals[z][x] = glm::normalize(normals[z][x]);
+vector<unsigned int> Terrain::generateSkirtIndices(int numberOfVerticesPerAxis){
+    vector<unsigned int> skirtIndices;
+    skirtIndices.reserve(4 * (numberOfVerticesPerAxis - 1) * 12);
+    unsigned int firstSkirtIndex = numberOfVerticesPerAxis * numberOfVerticesPerAxis;
+    for (int edge = 0; edge < 4; edge++){
+        for (int i = 0; i < numberOfVerticesPerAxis - 1; i++){
+            unsigned int topA;
+            unsigned int topB;
+            switch (edge){
+                case 0:
+                    topA = i;
+                    topB = i + 1;
+                    break;
+                case 1:
+                    topA = (numberOfVerticesPerAxis - 1) * numberOfVerticesPerAxis + i;
+                    topB = topA + 1;
+                    break;
+                case 2:
+                    topA = i * numberOfVerticesPerAxis;
+                    topB = topA + numberOfVerticesPerAxis;
+                    break;
+                default:
+                    topA = i * numberOfVerticesPerAxis + numberOfVerticesPerAxis - 1;
+                    topB = topA + numberOfVerticesPerAxis;
+                    break;
+            }
+            unsigned int bottomA = firstSkirtIndex + edge * numberOfVerticesPerAxis + i;
+            unsigned int bottomB = bottomA + 1;
+            skirtIndices.insert(skirtIndices.end(), {topA, topB, bottomB, topA, bottomB, bottomA});
+            skirtIndices.insert(skirtIndices.end(), {topA, bottomB, topB, topA, bottomA, bottomB});
         }
     }
-    return normals;
+    return skirtIndices;
 }
 
 /**
- * @brief This function will flatten a 2D vector into a 1D vector
+ * @brief This function will generate the adaptive index buffer of a terrain mesh
  * 
- * @details This function will flatten a 2D vector into a 1D vector. It will iterate through the
- * 2D vector and add each element to the 1D vector.
+ * @details The grid is triangulated with as few triangles as keep every vertex within maxError of
+ * the surface, so flat ground is covered by a handful of large triangles. The vertices are not
+ * changed and the ones that are no longer used are simply not drawn, which keeps the vertex order
+ * the same as the uniform grid for the skirts. The skirts hide the T-junctions along the edges
+ * where a neighbouring subchunk keeps vertices that this one drops.
  * 
- * @param inVector [in] std::vector<std::vector<glm::vec3>> The 2D vector to flatten
+ * @param inHeights [in] const float* The heights of the cropped vertices of the terrain in grid order
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the cropped mesh
+ * @param maxError [in] float The largest height error allowed in world units
  * 
- * @return std::vector<glm::vec3> The flattened 1D vector
+ * @return std::shared_ptr<const std::vector<unsigned int>> The index buffer including the skirts
  * 
  */
-vector<glm::vec3> Terrain::flatten2DVector(vector<vector<glm::vec3>> inVector){
-    // We assume that the 2D vector is a square matrix
-    vector<glm::vec3> flattenedVector = vector<glm::vec3>(inVector.size() * inVector[0].size());
-    #pragma omp parallel for
-    for (int i = 0; i < static_cast<int> (inVector.size()); i++){
-        for (int j = 0; j < static_cast<int> (inVector[0].size()); j++){
-            flattenedVector[i * inVector[0].size() + j] = inVector[i][j];
+shared_ptr<const vector<unsigned int>> Terrain::generateAdaptiveIndices(
+    const float *inHeights,
+    int numberOfVerticesPerAxis,
+    float maxError
+){
+    vector<unsigned int> generated = AdaptiveTriangulation::generateIndices(inHeights, numberOfVerticesPerAxis, maxError);
+    vector<unsigned int> skirtIndices = generateSkirtIndices(numberOfVerticesPerAxis);
+    generated.insert(generated.end(), skirtIndices.begin(), skirtIndices.end());
+    return make_shared<const vector<unsigned int>>(std::move(generated));
+}
+
+/**
+ * @brief This function will return the index buffer shared by every terrain mesh of a given size
+ * 
+ * @details The topology of a terrain mesh only depends on the number of vertices per axis, which
+ * is fixed by the subchunk size and resolution. The index buffer for each size is generated the
+ * first time it is needed and the same buffer is handed to every later terrain, which also lets
+ * the buffer pool upload it to the GPU once. This is safe to call from the mesh workers.
+ * 
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the mesh
+ * @param withSkirts [in] bool Whether the skirt triangles are appended to the grid triangles
+ * 
+ * @return std::shared_ptr<const std::vector<unsigned int>> The shared index buffer
+ * 
+ */
+shared_ptr<const vector<unsigned int>> Terrain::getSharedIndexBuffer(int numberOfVerticesPerAxis, bool withSkirts){
+    static mutex cacheMutex;
+    static map<pair<int, bool>, shared_ptr<const vector<unsigned int>>> cache;
+    pair<int, bool> key = make_pair(numberOfVerticesPerAxis, withSkirts);
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        auto cached = cache.find(key);
+        if (cached != cache.end()){
+            return cached->second;
         }
     }
-    return flattenedVector;
+    // The buffer is generated outside the lock, if two threads race for the same size then the
+    // first one to finish wins and the other result is discarded
+    vector<unsigned int> generated = generateIndexBuffer(numberOfVerticesPerAxis);
+    if (withSkirts){
+        vector<unsigned int> skirtIndices = generateSkirtIndices(numberOfVerticesPerAxis);
+        generated.insert(generated.end(), skirtIndices.begin(), skirtIndices.end());
+    }
+    shared_ptr<const vector<unsigned int>> shared = make_shared<const vector<unsigned int>>(std::move(generated));
+    lock_guard<mutex> lock(cacheMutex);
+    return cache.emplace(key, shared).first->second;
 }
 
 /**
- * @brief This function will crop the border vertices and normals from the terrain
+ * @brief This function will return the flat grid shared by every displaced terrain of a given size and resolution
  * 
- * @details This function will crop the border vertices and normals from the terrain. It will
- * remove the 1*resolution wide vertex border around the edge of the subchunk.
+ * @details The grid has the same vertex order as the meshes built on the CPU, followed by one row
+ * of skirt vertices for each edge, so it can use the same shared index buffer. The x and z of each
+ * position are in heightmap units of the terrain and the height is left at zero as it is read from
+ * the heightmap texture in the vertex shader. The second texture coordinate marks the skirt
+ * vertices. This is safe to call from the mesh workers.
  * 
- * @param inVertices [in] std::vector<std::vector<glm::vec3>> The vertices of the terrain
- * @param inNormals [in] std::vector<std::vector<glm::vec3>> The normals of the terrain
+ * @param numberOfVerticesPerAxis [in] int The number of vertices per axis of the grid
+ * @param resolution [in] float The number of vertices per heightmap value
  * 
- * @return std::vector<std::vector<std::vector<glm::vec3>>> The cropped vertices and normals
+ * @return std::shared_ptr<const std::vector<Vertex>> The shared flat grid
  * 
  */
-vector<vector<vector<glm::vec3>>> Terrain::cropBorderVerticesAndNormals(
-    vector<vector<glm::vec3>> inVertices,
-    vector<vector<glm::vec3>> inNormals
-){
-    vector<vector<vector<glm::vec3>>> croppedData = vector<vector<vector<glm::vec3>>>(2);
-    // We want to extract the (size x size) centred region of the subchunk. This will remove the
-    // 1*resolution wide vertex border around the edge.
-    int numberOfVerticesPerAxis = (size + 2) * resolution;
-    croppedData[0] = vector<vector<glm::vec3>>((size - 1) * resolution + 1, vector<glm::vec3>((size - 1) * resolution + 1));
-    croppedData[1] = vector<vector<glm::vec3>>((size - 1) * resolution + 1, vector<glm::vec3>((size - 1) * resolution + 1));
-    // We want to iterate through the 2D mesh aonly keep the central (size*resolution x size*resolution)
-    //
-    float stepSize = static_cast<float>(size + 2) / static_cast<float>(numberOfVerticesPerAxis);
-    #pragma omp parallel for
+shared_ptr<const vector<Vertex>> Terrain::getSharedFlatGrid(int numberOfVerticesPerAxis, float resolution){
+    static mutex cacheMutex;
+    // Grids with the same number of vertices are spaced differently at different resolutions
+    static map<pair<int, float>, shared_ptr<const vector<Vertex>>> cache;
+    pair<int, float> key = make_pair(numberOfVerticesPerAxis, resolution);
+    {
+        lock_guard<mutex> lock(cacheMutex);
+        auto cached = cache.find(key);
+        if (cached != cache.end()){
+            return cached->second;
+        }
+    }
+    float stepSize = 1.0f / resolution;
+    glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+    vector<Vertex> grid;
+    grid.reserve(numberOfVerticesPerAxis * numberOfVerticesPerAxis + 4 * numberOfVerticesPerAxis);
     for (int z = 0; z < numberOfVerticesPerAxis; z++){
         for (int x = 0; x < numberOfVerticesPerAxis; x++){
-            if (
-                x >= resolution && x < numberOfVerticesPerAxis - (2 * resolution) + 1 &&
-                z >= resolution && z < numberOfVerticesPerAxis - (2 * resolution) + 1
-            ){
-                croppedData[0][z - resolution][x - resolution] = glm::vec3(
-                    (x - resolution) * stepSize,
-                    inVertices[z][x].y,
-                    (z - resolution) * stepSize
-                );
-                croppedData[1][z - resolution][x - resolution] = inNormals[z][x];
+            grid.push_back(Vertex(glm::vec3(x * stepSize, 0.0f, z * stepSize), up, glm::vec2(0.0f, 0.0f)));
+        }
+    }
+    // The skirts follow the edges in the same order as buildCompactVertices
+    for (int edge = 0; edge < 4; edge++){
+        for (int i = 0; i < numberOfVerticesPerAxis; i++){
+            glm::vec3 position;
+            switch (edge){
+                case 0: position = grid[i].getPosition(); break;
+                case 1: position = grid[(numberOfVerticesPerAxis - 1) * numberOfVerticesPerAxis + i].getPosition(); break;
+                case 2: position = grid[i * numberOfVerticesPerAxis].getPosition(); break;
+                default: position = grid[i * numberOfVerticesPerAxis + numberOfVerticesPerAxis - 1].getPosition(); break;
             }
+            grid.push_back(Vertex(position, up, glm::vec2(0.0f, 1.0f)));
         }
     }
-    return croppedData;
+    shared_ptr<const vector<Vertex>> shared = make_shared<const vector<Vertex>>(std::move(grid));
+    lock_guard<mutex> lock(cacheMutex);
+    return cache.emplace(key, shared).first->second;
 }
 
 /**
@@ -296,72 +449,102 @@ glm::mat4 Terrain::generateTransformMatrix(){
 /**
  * @brief This function will create the mesh for the terrain
  * 
- * @details This function will create the mesh for the terrain. It will generate the vertices,
- * indices and normals for the terrain. It will then crop the border of the terrain out and
- * flatten the vertices and normals into a 1D vector. It will then create the size of the vertices
- * array and use the utility function to write the mesh to an obj file.
+ * @details This function will create the mesh for the terrain. It will generate the heights of
+ * the render vertices including the border, then build the compact vertices of the cropped grid
+ * and its skirts from them in a single kernel. The morph target height of each vertex is blended
+ * towards in the vertex shader as the vertex approaches the next coarser level of detail. The
+ * intermediate heights live in the scratch arena of the building thread and are given back when
+ * the mesh is done, so only the compact vertices are allocated for each build.
  * 
- * @param inHeights [in] std::vector<std::vector<float>> The heightmap values
+ * @param inHeights [in] const HeightView& The heightmap values including the border
  * @param heightScalingFactor [in] float The height scaling factor
  * 
  * @return void
  * 
  */
-void Terrain::createMesh(vector<vector<float>> inHeights, float heightScalingFactor){
-    // Generate the vertices, indices and normals for the terrain
-    vector<vector<glm::vec3>> renderVertices = generateRenderVertices(inHeights, heightScalingFactor);
-    vector<unsigned int> tempIndices = generateIndexBuffer((size + 2) * resolution);
-    vector<vector<glm::vec3>> normals = generateNormals(renderVertices, tempIndices);
-
-    // Crop the border of the terrain out
-    vector<vector<vector<glm::vec3>>> croppedData = cropBorderVerticesAndNormals(renderVertices, normals);
-    vector<vector<glm::vec3>> croppedVertices = croppedData[0];
-    vector<vector<glm::vec3>> croppedNormals = croppedData[1];
-    vector<unsigned int> croppedIndices;
-    if (resolution == 1){
-        croppedIndices = generateIndexBuffer(size);
-    } else {
-        croppedIndices = generateIndexBuffer(size * resolution - resolution + 1);
+void Terrain::createMesh(const HeightView &inHeights, float heightScalingFactor){
+    if (settings->getGpuHeightDisplacement() || settings->getHardwareTessellation()){
+        createDisplacedMesh(inHeights, heightScalingFactor);
+        return;
     }
-    vector<glm::vec3> flattenedVertices = flatten2DVector(croppedVertices);
-    vector<glm::vec3> flattenedNormals = flatten2DVector(croppedNormals);
-
-    // Create the size of the vertices array
-    vertices = vector<Vertex>(flattenedVertices.size());
-    #pragma omp parallel for
-    for (int i = 0; i < static_cast<int> (flattenedVertices.size()); i++){
-        vertices[i] = Vertex(flattenedVertices[i], flattenedNormals[i], glm::vec2(0.0f, 0.0f));
-        // vertices.push_back(Vertex(flattenedVertices[i], flattenedNormals[i], glm::vec2(0.0f, 0.0f)));
+    ScratchArena &arena = ScratchArena::forThread();
+    ScratchArena::Scope scope(arena);
+    float *renderHeights = generateRenderHeights(inHeights, heightScalingFactor, arena);
+    buildCompactVertices(renderHeights);
+
+    // Every terrain with the same number of vertices has the same triangles so the index buffer is
+    // shared rather than generated for each subchunk, unless the grid is triangulated adaptively
+    int numberOfVerticesPerAxis = static_cast<int>((size - 1) * resolution + 1);
+    float adaptiveMeshError = settings->getAdaptiveMeshError();
+    adaptiveIndices = adaptiveMeshError > 0.0f;
+    if (adaptiveIndices){
+        int border = static_cast<int>(resolution);
+        int borderedVerticesPerAxis = static_cast<int>((size + 2) * resolution);
+        float *croppedHeights = arena.allocate<float>(numberOfVerticesPerAxis * numberOfVerticesPerAxis);
+        for (int z = 0; z < numberOfVerticesPerAxis; z++){
+            const float *row = renderHeights + (z + border) * borderedVerticesPerAxis + border;
+            copy(row, row + numberOfVerticesPerAxis, croppedHeights + z * numberOfVerticesPerAxis);
+        }
+        indices = generateAdaptiveIndices(croppedHeights, numberOfVerticesPerAxis, adaptiveMeshError);
+    } else {
+        indices = getSharedIndexBuffer(numberOfVerticesPerAxis, true);
     }
-    indices = croppedIndices;
+}
 
-    // Use the utility function to write the mesh to an obj file
-    // string outputPath = getenv("DATA_ROOT");
-    // string filename = outputPath + settings.getFilePathDelimitter() + "terrain.obj";
-    // Utility::storeHeightmapToObj(filename.c_str(), flattenedVertices, flattenedNormals, indices);
+/**
+ * @brief This function will set up the terrain to be displaced on the GPU
+ * 
+ * @details No vertices are built for the terrain, instead it draws the shared flat grid for its
+ * size and the heights, morph targets and normals are read from the heightmap texture of the
+ * parent chunk in the vertex shader. Only the height of the bottom of the skirts is worked out
+ * here, which is lodSkirtDepth below the lowest height of the terrain. Tessellated terrain draws
+ * the grid at the heightmap resolution as patches, which the tessellation shaders refine by their
+ * size on screen and displace with bicubic filtering of the heightmap texture.
+ * 
+ * @param inHeights [in] const HeightView& The heightmap values including the border
+ * @param heightScalingFactor [in] float The height scaling factor
+ * 
+ * @return void
+ * 
+ */
+void Terrain::createDisplacedMesh(const HeightView &inHeights, float heightScalingFactor){
+    float lowestHeight = inHeights.at(0, 0);
+    for (int z = 0; z < inHeights.height; z++){
+        const float *row = inHeights.data + z * inHeights.stride;
+        lowestHeight = min(lowestHeight, *min_element(row, row + inHeights.width));
+    }
+    skirtHeight = Utility::height_scaling(lowestHeight, heightScalingFactor) - settings->getLodSkirtDepth();
+    tessellated = settings->getHardwareTessellation();
+    float gridResolution = tessellated ? 1.0f : resolution;
+    int numberOfVerticesPerAxis = static_cast<int>((size - 1) * gridResolution + 1);
+    gridVertices = getSharedFlatGrid(numberOfVerticesPerAxis, gridResolution);
+    indices = getSharedIndexBuffer(numberOfVerticesPerAxis, true);
 }
 
 /**
  * @brief Construct a new Terrain object with the given arguments
  * 
- * @param inHeights [in] std::vector<std::vector<float>> The heightmap values
- * @param inBiomes [in] std::shared_ptr<std::vector<std::vector<uint8_t>>> The biomes of the terrain
- * @param inSettings [in] std::shared_ptr<Settings> The settings object
+ * @details Only the CPU side of the terrain is built here so that it can be constructed on a
+ * worker thread. The GPU buffers are created by setupData, which must be called on the thread
+ * that owns the OpenGL context before the terrain is rendered.
+ * 
+ * @param inHeights [in] const HeightView& The heightmap values including the border
+ * @param inSettings [in] Settings* The settings object, owned by the parent chunk
  * @param inWorldCoords [in] std::vector<float> The world coordinates of the subchunk
- * @param inShader [in] std::shared_ptr<Shader> The shader for the terrain
- * @param inTextures [in] std::vector<std::shared_ptr<Texture>> The textures for the terrain
- * @param inTextureArrays [in] std::vector<std::shared_ptr<TextureArray>> The texture arrays for the terrain
+ * @param inShader [in] Shader* The shader for the terrain, owned by the parent chunk
+ * @param inTextures [in] const std::vector<std::shared_ptr<Texture>>* The textures for the terrain, owned by the parent chunk
+ * @param inTextureArrays [in] const std::vector<std::shared_ptr<TextureArray>>* The texture arrays for the terrain, owned
+ * by the parent chunk
  * @param inSubbiomeTextureArrayMap [in] const int* The subbiome texture array map
  * 
  */
 Terrain::Terrain(
-    vector<vector<float>> inHeights,
-    shared_ptr<vector<vector<uint8_t>>> inBiomes,
-    shared_ptr<Settings> inSettings,
+    const HeightView &inHeights,
+    Settings *inSettings,
     vector<float> inWorldCoords,
-    shared_ptr<Shader> inShader,
-    vector<shared_ptr<Texture>> inTextures,
-    vector<shared_ptr<TextureArray>> inTextureArrays,
+    Shader *inShader,
+    const vector<shared_ptr<Texture>> *inTextures,
+    const vector<shared_ptr<TextureArray>> *inTextureArrays,
     const int* inSubbiomeTextureArrayMap
 ){
     // Use the settings to set the size and resolution of the subchunk terrain
@@ -369,9 +552,21 @@ Terrain::Terrain(
     resolution = settings->getSubChunkResolution();
     size = settings->getSubChunkSize();
     worldCoords = inWorldCoords;
-
-    // Setting the subchunk biome data
-    biomes = inBiomes;
+    spacing = 1.0f;
+    morphOffset = vector<int>{0, 0};
+    fade = 1.0f;
+    fadeOut = false;
+    morphRange = TerrainLod::getMorphRange(resolution, *settings);
+    biomeMapOrigin = glm::vec2(0.0f);
+    skirtHeight = 0.0f;
+    heightRange = glm::vec2(0.0f);
+    indexType = GL_UNSIGNED_INT;
+    adaptiveIndices = false;
+    tessellated = false;
+    heightMapOrigin = glm::vec2(0.0f);
+    normalMapped = false;
+    normalMapOrigin = glm::vec2(0.0f);
+    bufferPool = nullptr;
 
     createMesh(inHeights, settings->getMaximumHeight());
 
@@ -383,43 +578,60 @@ Terrain::Terrain(
     // Generate the transform matrix for the terrain
     model = generateTransformMatrix();
     normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
-    setupData();
 }
 
 /**
  * @brief Construct a new Terrain object with the given arguments
  * 
- * @param inHeights [in] std::vector<std::vector<float>> The heightmap values
- * @param inBiomes [in] std::shared_ptr<std::vector<std::vector<uint8_t>>> The biomes of the terrain
+ * @details Only the CPU side of the terrain is built here so that it can be constructed on a
+ * worker thread. The GPU buffers are created by setupData, which must be called on the thread
+ * that owns the OpenGL context before the terrain is rendered.
+ * 
+ * @param inHeights [in] const HeightView& The heightmap values including the border
  * @param inResolution [in] float The resolution of the subchunk
- * @param inSettings [in] std::shared_ptr<Settings> The settings object
+ * @param inSettings [in] Settings* The settings object, owned by the parent chunk
  * @param inWorldCoords [in] std::vector<float> The world coordinates of the subchunk
- * @param inShader [in] std::shared_ptr<Shader> The shader for the terrain
- * @param inTextures [in] std::vector<std::shared_ptr<Texture>> The textures for the terrain
- * @param inTextureArrays [in] std::vector<std::shared_ptr<TextureArray>> The texture arrays for the terrain
+ * @param inShader [in] Shader* The shader for the terrain, owned by the parent chunk
+ * @param inTextures [in] const std::vector<std::shared_ptr<Texture>>* The textures for the terrain, owned by the parent chunk
+ * @param inTextureArrays [in] const std::vector<std::shared_ptr<TextureArray>>* The texture arrays for the terrain, owned
+ * by the parent chunk
  * @param inSubbiomeTextureArrayMap [in] const int* The subbiome texture array map
+ * @param inSpacing [in] float The number of world units between the heightmap values
+ * @param inMorphOffset [in] std::vector<int> The parity offset of the next coarser grid along each axis
  * 
  */
 Terrain::Terrain(
-    vector<vector<float>> inHeights,
-    shared_ptr<vector<vector<uint8_t>>> inBiomes,
+    const HeightView &inHeights,
     float inResolution,
-    shared_ptr<Settings> inSettings,
+    Settings *inSettings,
     vector<float> inWorldCoords,
-    shared_ptr<Shader> inShader,
-    vector<shared_ptr<Texture>> inTextures,
-    vector<shared_ptr<TextureArray>> inTextureArrays,
-    const int* inSubbiomeTextureArrayMap
+    Shader *inShader,
+    const vector<shared_ptr<Texture>> *inTextures,
+    const vector<shared_ptr<TextureArray>> *inTextureArrays,
+    const int* inSubbiomeTextureArrayMap,
+    float inSpacing,
+    vector<int> inMorphOffset
 ){
     // Use the settings to set the size and resolution of the subchunk terrain
     settings = inSettings;
     resolution = inResolution;
     size = settings->getSubChunkSize();
     worldCoords = inWorldCoords;
-
-    // Setting the subchunk biome data
-    biomes = inBiomes;
-
+    spacing = inSpacing;
+    morphOffset = inMorphOffset;
+    fade = 1.0f;
+    fadeOut = false;
+    morphRange = TerrainLod::getMorphRange(resolution, *settings);
+    biomeMapOrigin = glm::vec2(0.0f);
+    skirtHeight = 0.0f;
+    heightRange = glm::vec2(0.0f);
+    indexType = GL_UNSIGNED_INT;
+    adaptiveIndices = false;
+    tessellated = false;
+    heightMapOrigin = glm::vec2(0.0f);
+    normalMapped = false;
+    normalMapOrigin = glm::vec2(0.0f);
+    bufferPool = nullptr;
 
     createMesh(inHeights, settings->getMaximumHeight());
 
@@ -431,15 +643,88 @@ Terrain::Terrain(
     // Generate the transform matrix for the terrain
     model = generateTransformMatrix();
     normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
-    setupData();
 }
 
 /**
- * @brief Destroy the Terrain object by the standard destructor
+ * @brief Destroy the Terrain object and return its GPU buffers to the pool
+ * 
+ * @details Terrain that was never set up has nothing to return. The subchunks are destroyed on the
+ * thread that owns the OpenGL context so the pool can be used here.
  * 
  */
 Terrain::~Terrain(){
-    // Do nothing
+    releaseData();
+}
+
+/**
+ * @brief This function will return the texture unit the heightmap of the chunk is bound to
+ * 
+ * @details The biome map takes unit 0 and the textures and texture arrays follow it. The heightmap
+ * sampler always gets its own unit as samplers of different types must not share a unit even if
+ * they are not read, and the normal map takes the unit after it for the same reason.
+ * 
+ * @param textureCount [in] int The number of terrain textures
+ * @param textureArrayCount [in] int The number of terrain texture arrays
+ * 
+ * @return int The texture unit of the heightmap
+ * 
+ */
+int Terrain::getHeightMapUnit(int textureCount, int textureArrayCount){
+    return 1 + textureCount + textureArrayCount;
+}
+
+/**
+ * @brief This function will return the GPU buffers of the terrain to the pool
+ * 
+ * @details The packed vertices are kept, so the terrain can be uploaded again later by
+ * calling setupData. This must be called on the thread that owns the OpenGL context.
+ * 
+ * @return void
+ * 
+ */
+void Terrain::releaseData(){
+    if (bufferPool != nullptr){
+        // The shared flat grid belongs to the pool
+        if (gridVertices == nullptr){
+            bufferPool->releaseMesh(meshBuffers);
+        }
+    }
+    meshBuffers = MeshBuffers();
+    VAO = 0;
+    VBO = 0;
+    EBO = 0;
+}
+
+/**
+ * @brief This function will return the GPU memory used by the terrain
+ * 
+ * @details The shared index buffer and the shared flat grid are not counted as they stay on the
+ * GPU for as long as any terrain of their size exists.
+ * 
+ * @return size_t The size in bytes of the vertex buffer and adaptive index buffer
+ * of the terrain
+ * 
+ */
+size_t Terrain::getGpuBytes(){
+    size_t bytes = 0;
+    if (gridVertices == nullptr){
+        bytes += meshBuffers.vertexBytes + meshBuffers.indexBytes;
+    }
+    return bytes;
+}
+
+/**
+ * @brief This function will return the CPU memory used to upload the terrain again
+ * 
+ * @return size_t The size in bytes of the packed vertices and adaptive indices of the terrain
+ * 
+ */
+size_t Terrain::getCpuBytes(){
+    size_t bytes = compactVertices.capacity() * sizeof(TerrainVertex);
+    if (adaptiveIndices){
+        bytes += indices->capacity() * sizeof(unsigned int);
+    }
+    return bytes;
 }
 
 #pragma GCC diagnostic push
@@ -474,6 +759,7 @@ void Terrain::render(
     shader->setMat3("normalMatrix", normalMatrix);
     shader->setVec3("colour", glm::vec3(1.0f, 0.5f, 0.31f));
     shader->setVec2("chunkOrigin", glm::vec2(worldCoords[0], worldCoords[1]));
+    shader->setFloat("biomeScale", spacing);
 
     // Set the light properties
     shared_ptr<Light> sun = lights[0];
@@ -508,35 +794,73 @@ void Terrain::render(
     // Set the clipping plane
     shader->setVec4("clippingPlane", plane);
 
+    // Set the camera distances over which the vertices morph to the next level of detail
+    shader->setVec2("morphRange", morphRange);
+
+    // Set the cross-fade state used while replacing placeholder terrain
+    shader->setFloat("fade", fade);
+    shader->setBool("fadeOut", fadeOut);
+
     // Set the subbiome to texture array index map
     shader->setIntArray("subbiomeTextureArrayMap", subbiomeTextureArrayMap, 34);
 
-    // Bind the biome map for this subchunk
-    glActiveTexture(GL_TEXTURE0); 
-    glBindTexture(GL_TEXTURE_2D, biomeTextureID);
+    // Set up the displacement of the flat grid, the heightmap of the chunk is bound by the chunk
+    int heightMapUnit = getHeightMapUnit(textures->size(), textureArrays->size());
+    shader->setBool("gpuDisplacement", gridVertices != nullptr);
+    shader->setBool("compactVertices", gridVertices == nullptr);
+    shader->setInt("heightMap", heightMapUnit);
+    shader->setFloat("heightMapSpacing", spacing);
+    shader->setFloat("gridResolution", resolution);
+    shader->setVec2("heightRange", heightRange);
+    if (gridVertices != nullptr){
+        shader->setVec2("heightMapOrigin", heightMapOrigin);
+        shader->setVec2("morphOffset", glm::vec2(morphOffset[0], morphOffset[1]));
+        shader->setFloat("skirtHeight", skirtHeight);
+        shader->setFloat("maximumHeight", settings->getMaximumHeight());
+    }
+
+    // Light the terrain from the baked normal map of the chunk when it has one, which is bound by
+    // the chunk to the unit after the heightmap
+    shader->setBool("useNormalMap", normalMapped);
+    shader->setInt("normalMap", heightMapUnit + 1);
+    if (normalMapped){
+        shader->setVec2("normalMapOrigin", normalMapOrigin);
+    }
+
+    // The biome map of the chunk is bound to unit 0 by the chunk, the terrain reads its part of it from the origin
     shader->setInt("biomeMap", 0); 
+    shader->setVec2("biomeMapOrigin", biomeMapOrigin);
 
     // We need to iterate through the list of textures and set their uniforms in order
-    for (int i = 0; i < static_cast<int> (textures.size()); i++){
-        shader->setInt(textures[i]->getName(), i + 1);
+    for (int i = 0; i < static_cast<int> (textures->size()); i++){
+        shader->setInt((*textures)[i]->getName(), i + 1);
     }
     
     // We need to iterate through the list of texture arrays and set their uniforms in order
-    for (int i = 0; i < static_cast<int> (textureArrays.size()); i++){
-        shader->setInt(textureArrays[i]->getName(), i + 1 + textures.size()); 
+    for (int i = 0; i < static_cast<int> (textureArrays->size()); i++){
+        shader->setInt((*textureArrays)[i]->getName(), i + 1 + textures->size()); 
+    }
+
+    // Set the target size of the tessellated edges in pixels of the current render target
+    if (tessellated){
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        shader->setVec2("viewportSize", glm::vec2(viewport[2], viewport[3]));
+        shader->setFloat("tessellationEdgePixels", settings->getTessellationEdgePixels());
     }
 
     // Bind the VAO
     glBindVertexArray(VAO);
-    // Draw the terrain
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    // Draw the terrain, each triangle of the grid is a patch when it is tessellated
+    if (tessellated){
+        glPatchParameteri(GL_PATCH_VERTICES, 3);
+        glDrawElements(GL_PATCHES, indices->size(), indexType, 0);
+    } else {
+        glDrawElements(GL_TRIANGLES, indices->size(), indexType, 0);
+    }
     // Unbind the VAO
     glBindVertexArray(0);
     shader->deactivate();
-
-    // Unbind the biome map
-    glActiveTexture(GL_TEXTURE0); // Activate texture unit 0
-    glBindTexture(GL_TEXTURE_2D, 0); // Unbind from that unit
 }
 #pragma GCC diagnostic pop
 
@@ -544,69 +868,66 @@ void Terrain::render(
 /**
  * @brief This function will set up the data for the terrain
  * 
- * @details This function will set up the data for the terrain. This includes setting up the
- * vertex array object, vertex buffer object, and element buffer object. It will also set up the
- * vertex attribute pointers for the position, normal, and texture coordinates.
+ * @details This function will check out the vertex array and vertex buffer for the terrain from
+ * the buffer pool and fill them with the mesh. The element buffer is the copy of the shared index
+ * buffer that the pool keeps on the GPU, so it is only uploaded by the first terrain of each
+ * size, apart from adaptively triangulated terrain which uploads its own. The biome map is not
+ * uploaded here as it is shared with the rest of the chunk, which binds it before drawing.
+ * The pool must be given to the terrain by setBufferPool first.
  * 
  * @return void
  * 
  */
 void Terrain::setupData(){
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    // Bind the VAO
-    glBindVertexArray(VAO);
-
-    // Bind the VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-    // Bind the EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-    // Set the vertex attribute pointers
-    // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3)));
-    glEnableVertexAttribArray(1);
-    // Texture coordinates
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(2 * sizeof(glm::vec3)));
-    glEnableVertexAttribArray(2);
-
-    // Unbind the VAO
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    
-    // We need to create a 2D texture for the biome map. 
-    int height = biomes->size() - 2;      
-    int width  = (*biomes)[0].size() - 2;     
-
-    // We need to flatten the 2D vector of biomes into a 1D vector
-    std::vector<uint8_t> flatBiomeData;
-    flatBiomeData.reserve(width * height);
+    // Return anything from an earlier upload before checking out the new storage
+    if (gridVertices == nullptr){
+        bufferPool->releaseMesh(meshBuffers);
+    }
 
-    for (int z = 1; z < 33; ++z) {
-        for (int x = 1; x < 33; ++x) {
-            flatBiomeData.push_back((*biomes)[z][x]);
+    if (gridVertices != nullptr){
+        // The displaced terrain draws the flat grid that is shared by every terrain of its size
+        meshBuffers = bufferPool->getSharedMesh(gridVertices, indices);
+    } else if (adaptiveIndices){
+        // The adaptive triangles are different for every terrain so they get an element buffer of
+        // their own, which is sized in whole pages so that it can be reused by other terrains
+        const size_t indexPageBytes = 4096;
+        unsigned int largestIndex = *max_element(indices->begin(), indices->end());
+        size_t indexSize = largestIndex <= 0xFFFF ? sizeof(uint16_t) : sizeof(unsigned int);
+        size_t indexBytes = (indices->size() * indexSize + indexPageBytes - 1) / indexPageBytes * indexPageBytes;
+        meshBuffers = bufferPool->acquireMesh(
+            compactVertices.size() * sizeof(TerrainVertex),
+            indexBytes,
+            VertexLayout::COMPACT_TERRAIN
+        );
+        if (indexSize == sizeof(uint16_t)){
+            vector<uint16_t> narrowIndices = vector<uint16_t>(indexBytes / indexSize, 0);
+            copy(indices->begin(), indices->end(), narrowIndices.begin());
+            bufferPool->uploadMesh(meshBuffers, compactVertices, narrowIndices);
+            indexType = GL_UNSIGNED_SHORT;
+        } else {
+            vector<unsigned int> paddedIndices = vector<unsigned int>(indexBytes / indexSize, 0);
+            copy(indices->begin(), indices->end(), paddedIndices.begin());
+            bufferPool->uploadMesh(meshBuffers, compactVertices, paddedIndices);
+            indexType = GL_UNSIGNED_INT;
         }
+    } else {
+        // The terrain has no element buffer of its own, the shared index buffer is attached instead
+        meshBuffers = bufferPool->acquireMesh(
+            compactVertices.size() * sizeof(TerrainVertex),
+            0,
+            VertexLayout::COMPACT_TERRAIN
+        );
+        bufferPool->uploadMesh(meshBuffers, compactVertices);
+        bufferPool->attachIndexBuffer(meshBuffers, bufferPool->getSharedIndexBuffer(indices));
     }
-
-    glGenTextures(1, &biomeTextureID);
-    glBindTexture(GL_TEXTURE_2D, biomeTextureID);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, flatBiomeData.data());
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
+    if (adaptiveIndices){
+        EBO = meshBuffers.EBO;
+    } else {
+        EBO = bufferPool->getSharedIndexBuffer(indices);
+        indexType = bufferPool->getSharedIndexType(indices);
+    }
+    VAO = meshBuffers.VAO;
+    VBO = meshBuffers.VBO;
 }
 
 /**
@@ -0,0 +1,123 @@
+/**
+ * @file TerrainLod.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the TerrainLod class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <cmath>
+#include <algorithm>
+
+#ifdef DEPARTMENT_BUILD
+    #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
+#else
+    #include <glm/glm.hpp>
+#endif
+
+#include "TerrainLod.hpp"
+#include "Settings.hpp"
+
+using namespace std;
+
+/**
+ * @brief This function will return the resolution used for the closest level of detail
+ *
+ * @details The resolutions have to be powers of two so that every vertex of a coarser level is
+ * also a vertex of the finer level, which is what allows the finer level to morph into it.
+ *
+ * @param settings [in] Settings& The settings object
+ *
+ * @return int The largest power of two that does not exceed the subchunk resolution
+ *
+ */
+int TerrainLod::getMaxResolution(Settings &settings){
+    int resolution = 1;
+    while (resolution * 2 <= settings.getSubChunkResolution()){
+        resolution *= 2;
+    }
+    return resolution;
+}
+
+/**
+ * @brief This function will return the number of levels of detail
+ *
+ * @param settings [in] Settings& The settings object
+ *
+ * @return int The number of levels, where the last level has a resolution of 1
+ *
+ */
+int TerrainLod::getLevelCount(Settings &settings){
+    int levels = 1;
+    for (int resolution = getMaxResolution(settings); resolution > 1; resolution /= 2){
+        levels++;
+    }
+    return levels;
+}
+
+/**
+ * @brief This function will return the distance from the camera to the outer edge of a level
+ *
+ * @param level [in] int The level of detail, where 0 is the finest level
+ * @param settings [in] Settings& The settings object
+ *
+ * @return float The distance in world units at which the level ends
+ *
+ */
+float TerrainLod::getLevelDistance(int level, Settings &settings){
+    float renderDistance = static_cast<float>(settings.getRenderDistance() * settings.getSubChunkSize());
+    return renderDistance / pow(2.0f, static_cast<float>(getLevelCount(settings) - 1 - level));
+}
+
+/**
+ * @brief This function will select the mesh resolution for a subchunk
+ *
+ * @details The distance should be measured to the closest point of the subchunk. This guarantees
+ * that every vertex of the subchunk has fully morphed into the next coarser level by the time the
+ * subchunk switches to it.
+ *
+ * @param distance [in] float The distance from the camera to the closest point of the subchunk
+ * @param settings [in] Settings& The settings object
+ *
+ * @return int The resolution of the mesh for the subchunk
+ *
+ */
+int TerrainLod::selectResolution(float distance, Settings &settings){
+    int levels = getLevelCount(settings);
+    int resolution = getMaxResolution(settings);
+    for (int level = 0; level < levels - 1; level++){
+        if (distance < getLevelDistance(level, settings)){
+            return resolution;
+        }
+        resolution /= 2;
+    }
+    return 1;
+}
+
+/**
+ * @brief This function will return the camera distances over which a mesh morphs to the next level
+ *
+ * @details The morph starts lodMorphRatio of the way from the outer edge of the level back towards
+ * its inner edge and completes at the outer edge. The coarsest level has nothing to morph into so
+ * its range is pushed beyond anything that is loaded.
+ *
+ * @param resolution [in] float The resolution of the mesh
+ * @param settings [in] Settings& The settings object
+ *
+ * @return glm::vec2 The start and end distance of the morph in world units
+ *
+ */
+glm::vec2 TerrainLod::getMorphRange(float resolution, Settings &settings){
+    int level = 0;
+    for (int levelResolution = getMaxResolution(settings); levelResolution > resolution && levelResolution > 1; levelResolution /= 2){
+        level++;
+    }
+    if (resolution <= 1.0f || level >= getLevelCount(settings) - 1){
+        float farAway = 4.0f * getLevelDistance(getLevelCount(settings) - 1, settings);
+        return glm::vec2(farAway, farAway + 1.0f);
+    }
+    float outer = getLevelDistance(level, settings);
+    float inner = level > 0 ? getLevelDistance(level - 1, settings) : 0.0f;
+    float ratio = clamp(settings.getLodMorphRatio(), 0.01f, 1.0f);
+    return glm::vec2(outer - ratio * (outer - inner), outer);
+}
@@ -211,14 +211,14 @@ float Utility::cubic_interpolation(
  * @brief This function will compute the bicubic interpolation of between sixteen points
  * 
  * @param position [in] glm::vec2 The position to interpolate
- * @param heightmap [in] vector<vector<float>> The heightmap to interpolate from
+ * @param heightmap [in] const vector<vector<float>>& The heightmap to interpolate from
  * 
  * @return float The interpolated y value at the given x and z values
  * 
  */
 float Utility::bicubic_interpolation(
     glm::vec2 position,
-    vector<vector<float>> heightmap
+    const vector<vector<float>> &heightmap
 ) {
     // We are implementing the bicubic interpolation algorithm to better improve the quality
     // of the terrain mesh between the heightmap specified vertices
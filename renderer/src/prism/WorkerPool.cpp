@@ -0,0 +1,134 @@
+/**
+ * @file WorkerPool.cpp
+ * @author King Attalus II
+ * @brief This file contains the implementation of the WorkerPool class.
+ * @version 1.0
+ * @date 2025
+ *
+ */
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <utility>
+
+#include "WorkerPool.hpp"
+
+using namespace std;
+
+/**
+ * @brief Construct a new Worker Pool object and start its threads
+ *
+ * @param threadCount [in] int The number of worker threads, at least one thread is always started
+ *
+ */
+WorkerPool::WorkerPool(int threadCount):
+    stopping(false)
+{
+    threadCount = threadCount > 0 ? threadCount : 1;
+    for (int i = 0; i < threadCount; i++){
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Destroy the Worker Pool object
+ *
+ * @details The pool is shut down if that has not been done already.
+ *
+ */
+WorkerPool::~WorkerPool(){
+    shutdown();
+}
+
+/**
+ * @brief This function will stop the pool
+ *
+ * @details The queued tasks are discarded and this waits for the running tasks to finish before
+ * joining the threads. Tasks submitted afterwards are discarded straight away. Calling this more
+ * than once has no further effect.
+ *
+ * @return void
+ *
+ */
+void WorkerPool::shutdown(){
+    {
+        lock_guard<mutex> lock(taskMutex);
+        stopping = true;
+        tasks.clear();
+    }
+    taskCondition.notify_all();
+    for (thread &worker : workers){
+        if (worker.joinable()){
+            worker.join();
+        }
+    }
+}
+
+/**
+ * @brief This function will add a task to the end of the queue
+ *
+ * @param task [in] std::function<void()> The task to run on a worker thread
+ * @param token [in] CancellationToken The token of the work the task belongs to, the task is
+ * skipped if it is cancelled before the task starts
+ *
+ * @return void
+ *
+ */
+void WorkerPool::submit(function<void()> task, CancellationToken token){
+    {
+        lock_guard<mutex> lock(taskMutex);
+        if (stopping){
+            return;
+        }
+        tasks.emplace_back(std::move(task), std::move(token));
+    }
+    taskCondition.notify_one();
+}
+
+/**
+ * @brief This function will return the number of tasks that are waiting to run
+ *
+ * @return int The number of queued tasks
+ *
+ */
+int WorkerPool::getQueuedTaskCount(){
+    lock_guard<mutex> lock(taskMutex);
+    return static_cast<int>(tasks.size());
+}
+
+/**
+ * @brief This function is run by every worker thread and takes tasks off the queue until the pool
+ * is stopped
+ *
+ * @details Exceptions thrown by a task are reported and swallowed so that a single failed task
+ * does not take down the worker. Tasks whose token has been cancelled are dropped without running.
+ *
+ * @return void
+ *
+ */
+void WorkerPool::workerLoop(){
+    while (true){
+        pair<function<void()>, CancellationToken> task;
+        {
+            unique_lock<mutex> lock(taskMutex);
+            taskCondition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping){
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        if (task.second.isCancelled()){
+            continue;
+        }
+        try {
+            task.first();
+        } catch (const exception &e) {
+            cerr << "ERROR: Worker task failed: " << e.what() << endl;
+        }
+    }
+}
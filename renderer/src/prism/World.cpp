@@ -17,6 +17,10 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+#include <functional>
 #include <curl/curl.h> // This will be used to complete the http requests
 #include <nlohmann/json.hpp> // This will be used to parse the json data
 
@@ -24,14 +28,21 @@
     #include "/dcs/large/efogahlewem/.local/include/glm/glm.hpp"
     #include "/dcs/large/efogahlewem/.local/include/glm/gtc/matrix_transform.hpp"
     #include "/dcs/large/efogahlewem/.local/include/glad/glad.h"
+    #include "/dcs/large/efogahlewem/.local/include/GLFW/glfw3.h"
 #else
     #include <glm/glm.hpp>
     #include <glm/gtc/matrix_transform.hpp>
     #include <glad/glad.h>
+    #include <GLFW/glfw3.h>
 #endif
 
 #include "IRenderable.hpp"
+#include "CancellationToken.hpp"
 #include "Chunk.hpp"
+#include "PlaceholderTerrain.hpp"
+#include "WorkerPool.hpp"
+#include "GpuBufferPool.hpp"
+#include "SubChunkCache.hpp"
 #include "Terrain.hpp"
 #include "Settings.hpp"
 #include "Utility.hpp"
@@ -67,9 +78,22 @@ World::World(
     reflectionBuffer(inReflectionBuffer),
     refractionBuffer(inRefractionBuffer)
 {
+    generationEpoch = std::make_shared<std::atomic<uint64_t>>(0);
+    inFlightRequests = 0;
     seed = settings->getParameters()->getSeed();
     seaLevel = settings->getSeaLevel();
     maxHeight = settings->getMaximumHeight();  //This is the renderers max height not the generator
+    placeholderTerrain = std::make_shared<PlaceholderTerrain>(seed, settings);
+    // Subchunk meshes are built on the workers and uploaded on the main thread, with no workers
+    // they are built on the main thread as they are needed
+    if (settings->getMeshBuildThreads() > 0){
+        meshWorkers = std::make_shared<WorkerPool>(settings->getMeshBuildThreads());
+    }
+    bufferPool = std::make_shared<GpuBufferPool>(settings->getBufferPoolLimit());
+    subChunkCache = std::make_shared<SubChunkCache>(
+        static_cast<size_t>(settings->getGpuCacheBudget()) * 1024 * 1024,
+        static_cast<size_t>(settings->getCpuCacheBudget()) * 1024 * 1024
+    );
     // Ensure that the vector of chunks and requests is empty
     std::lock_guard<std::mutex> lock(chunkMutex);
     std::lock_guard<std::mutex> lock2(requestMutex);
@@ -90,10 +114,25 @@ World::World(
         (textureRoot + settings->getFilePathDelimitter() + "skybox" + settings->getFilePathDelimitter() + "back.png"),
     };
     skyBox = make_shared<SkyBox>(skyboxTextures, settings);
-    terrainShader = make_shared<Shader>(
-        shaderRoot + settings->getFilePathDelimitter() + "terrain_shader.vs",
-        shaderRoot + settings->getFilePathDelimitter() + "terrain_shader.fs"
-    );
+    // The tessellation stages need OpenGL 4.0, without it the terrain falls back to the meshes
+    // refined on the CPU
+    if (settings->getHardwareTessellation() && !GLAD_GL_VERSION_4_0){
+        cout << "Hardware tessellation needs OpenGL 4.0, using CPU refined terrain instead" << endl;
+        settings->setHardwareTessellation(false);
+    }
+    if (settings->getHardwareTessellation()){
+        terrainShader = make_shared<Shader>(
+            shaderRoot + settings->getFilePathDelimitter() + "terrain_tessellation_shader.vs",
+            shaderRoot + settings->getFilePathDelimitter() + "terrain_tessellation_shader.tcs",
+            shaderRoot + settings->getFilePathDelimitter() + "terrain_tessellation_shader.tes",
+            shaderRoot + settings->getFilePathDelimitter() + "terrain_shader.fs"
+        );
+    } else {
+        terrainShader = make_shared<Shader>(
+            shaderRoot + settings->getFilePathDelimitter() + "terrain_shader.vs",
+            shaderRoot + settings->getFilePathDelimitter() + "terrain_shader.fs"
+        );
+    }
     oceanShader = make_shared<Shader>(
         shaderRoot + settings->getFilePathDelimitter() + "ocean_shader.vs",
         shaderRoot + settings->getFilePathDelimitter() + "ocean_shader.fs"
@@ -125,6 +164,27 @@ World::World(
     ));
 }
 
+/**
+ * @brief Destroy the World object
+ * 
+ * @details The destructor cancels all of the in-flight chunk requests and waits for the detached
+ * request threads to finish. The threads hold a pointer to the world, so they must not outlive it.
+ * Cancelled curl transfers are aborted by the progress callback so this does not wait for the
+ * server to finish generating the chunk. Cancelling the work also stops the subchunk builds, and
+ * the mesh workers are shut down so that no task is left to hold a chunk, which means the chunks
+ * are destroyed here on the main thread rather than by the last task to let go of them.
+ * 
+ */
+World::~World(){
+    cancelInFlightWork();
+    {
+        std::unique_lock<std::mutex> lock(inFlightMutex);
+        inFlightCondition.wait(lock, [this]() { return inFlightRequests == 0; });
+    }
+    // The queued mesh tasks were cancelled above, so this only waits for the running ones
+    meshWorkers->shutdown();
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 /**
@@ -156,12 +216,80 @@ void World::render(
     // We are going to render the skybox first
     skyBox->render(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
     std::lock_guard<std::mutex> lock(chunkMutex);  //Lock the guard to ensure safe access
+    // The water passes clip the terrain at sea level, which can remove the ridges that hide the
+    // terrain behind them, so the subchunks are only culled for the final pass
+    if (!isWaterPass){
+        cullHiddenSubChunks(viewPos);
+    }
     for (auto chunk : chunks){
         chunk->render(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
     }
+    for (auto chunk : placeholderChunks){
+        chunk->render(view, projection, lights, viewPos, isWaterPass, isShadowPass, plane);
+    }
 }
 #pragma GCC diagnostic pop
 
+/**
+ * @brief This function will evict the cached subchunks of the chunks that have been removed
+ * 
+ * @details Their memory would otherwise keep counting against the budgets of the subchunk cache
+ * until it reached them. Every chunk still in the world keeps its entries. The chunk mutex must be
+ * held by the caller.
+ * 
+ * @return void
+ * 
+ */
+void World::releaseCachedSubChunks(){
+    std::vector<const void *> owners;
+    for (const std::vector<std::shared_ptr<Chunk>> *chunkList : {&chunks, &placeholderChunks}){
+        for (const auto &chunk : *chunkList){
+            owners.push_back(chunk.get());
+        }
+    }
+    subChunkCache->retainOwners(owners);
+}
+
+/**
+ * @brief This function will mark the subchunks that are hidden behind the horizon
+ * 
+ * @details Every loaded subchunk of the generated and placeholder chunks is passed to the horizon
+ * culler together, so ridges in one chunk can hide the terrain of the chunks behind it. Chunks that
+ * are cross-fading or are placeholders are partly transparent or approximate and so they are
+ * tested but never hide anything. The chunk mutex must be held by the caller. Nothing is done
+ * when horizon culling is turned off, as the chunks then ignore the occluded flags, and the lists
+ * of the pass are kept so that culling every frame does not allocate.
+ * 
+ * @param viewPos [in] glm::vec3 The position of the camera
+ * 
+ * @return void
+ * 
+ */
+void World::cullHiddenSubChunks(glm::vec3 viewPos){
+    if (!settings->getHorizonCulling()){
+        return;
+    }
+    cullSubChunks.clear();
+    cullBounds.clear();
+    for (const vector<shared_ptr<Chunk>> *chunkList : {&chunks, &placeholderChunks}){
+        for (const auto &chunk : *chunkList){
+            bool occluder = !chunk->isPlaceholder() && !chunk->isFading();
+            size_t first = cullSubChunks.size();
+            chunk->appendLoadedSubChunks(cullSubChunks);
+            for (size_t i = first; i < cullSubChunks.size(); i++){
+                cullBounds.push_back(cullSubChunks[i]->getHorizonBounds());
+                cullBounds.back().occluder = occluder;
+            }
+        }
+    }
+    const vector<bool> &visible = horizonCuller.cull(cullBounds, viewPos);
+    for (size_t i = 0; i < cullSubChunks.size(); i++){
+        cullSubChunks[i]->setOccluded(!visible[i]);
+    }
+    // The subchunks are not held between passes
+    cullSubChunks.clear();
+}
+
 /**
  * @brief This function will set up the data for the world
  * 
@@ -324,6 +452,7 @@ void World::updateData(bool regenerate){
     skyBox->updateData(regenerate);
     // Update the chunks
     updateLoadedChunks();
+    double currentTime = glfwGetTime();
     for (size_t i = 0; i < chunks.size(); i++){
         std::shared_ptr<Chunk> chunkPtr;
         {
@@ -331,7 +460,46 @@ void World::updateData(bool regenerate){
             chunkPtr = chunks[i];
         }
         // Update the chunk's subchunks
-        chunkPtr->updateLoadedSubChunks(player->getPosition(), *settings);
+        chunkPtr->updateFade(currentTime, settings->getChunkFadeDuration());
+        chunkPtr->updateLoadedSubChunks(player->getPosition(), player->getCamera()->getZoom(), *settings);
+    }
+    updatePlaceholderChunks();
+    releaseRetiredChunks();
+}
+
+/**
+ * @brief This function will update the placeholder chunks within the world
+ * 
+ * @details This function will start fading out every placeholder whose real chunk has arrived
+ * and remove the placeholders that have finished fading out. The remaining placeholders have their
+ * subchunks updated in the same way as the real chunks. This must be called on the main thread
+ * as it is the only thread that touches the fade state of a published chunk.
+ * 
+ * @return void
+ * 
+ */
+void World::updatePlaceholderChunks(){
+    double currentTime = glfwGetTime();
+    std::vector<std::shared_ptr<Chunk>> activePlaceholders;
+    {
+        std::lock_guard<std::mutex> lock(chunkMutex);  //Lock the guard to ensure safe access
+        for (auto placeholder : placeholderChunks){
+            bool isFound;
+            getChunk(placeholder->getChunkCoords()[0], placeholder->getChunkCoords()[1], isFound);
+            if (isFound && !placeholder->isFadingOut()){
+                placeholder->startFade(true);
+            }
+        }
+        // Drop the placeholders that are now completely hidden by their real chunk
+        retireChunks(placeholderChunks, [](const std::shared_ptr<Chunk>& placeholder) {
+            return placeholder->isFadingOut() && placeholder->getFade() >= 1.0f;
+        });
+        releaseCachedSubChunks();
+        activePlaceholders = placeholderChunks;
+    }
+    for (auto placeholder : activePlaceholders){
+        placeholder->updateFade(currentTime, settings->getChunkFadeDuration());
+        placeholder->updateLoadedSubChunks(player->getPosition(), player->getCamera()->getZoom(), *settings);
     }
 }
 
@@ -366,6 +534,15 @@ void World::updateLoadedChunks(){
                 chunksToRemove.push_back(chunkCoords);
             }
         }
+        for (auto chunk : placeholderChunks){
+            std::pair<int, int> chunkCoords = {
+                chunk->getChunkCoords()[0],
+                chunk->getChunkCoords()[1]
+            };
+            if (distanceToChunkCenter(chunkCoords) > settings->getRequestDistance()){
+                chunksToRemove.push_back(chunkCoords);
+            }
+        }
     }
     // Remove the chunks that are too far away
     for (auto chunkCoords : chunksToRemove){
@@ -451,14 +628,23 @@ float World::distanceToChunkCenter(std::pair<int, int> chunkCoords){
 /**
  * @brief This function will clear the loaded chunks from the world
  * 
- * @details This function will clear the loaded chunks in a thread safe manner.
+ * @details This function will clear the loaded chunks in a thread safe manner. Any requests that
+ * are still in flight belong to the previous world, so they are cancelled and forgotten. The cached
+ * subchunks of the cleared chunks are removed when the retired chunks are released on the main
+ * thread, as this may be called from the loading thread.
  * 
  * @return void
  * 
  */
 void World::clearChunks(){
-    std::lock_guard<std::mutex> lock(chunkMutex);  //Lock the guard to ensure safe access
-    chunks.clear();
+    std::scoped_lock lock(chunkMutex, requestMutex);  //Lock the guards to ensure safe access
+    generationEpoch->fetch_add(1, std::memory_order_acq_rel);
+    auto all = [](const std::shared_ptr<Chunk>&) { return true; };
+    retireChunks(chunks, all);
+    retireChunks(placeholderChunks, all);
+    chunkRequests.clear();
+    // The seed or parameters may have changed so the placeholders need a fresh generator
+    placeholderTerrain = std::make_shared<PlaceholderTerrain>(settings->getParameters()->getSeed(), settings);
     std::lock_guard<std::mutex> lock2(terrainTextureArraysMutex);  //Lock the guard to ensure safe access
     terrainTextureArrays.clear();
 }
@@ -491,6 +677,48 @@ void World::addChunk(shared_ptr<Chunk> chunk){
     chunks.push_back(chunk);
 }
 
+/**
+ * @brief This function will add a requested chunk to the world if its request is still current
+ * 
+ * @details This function will add the chunk and remove its request in a single critical section.
+ * Both mutexes are held while the token is checked, so a concurrent call to clearChunks cannot
+ * slip in between the check and the insertion and leave a chunk from the old world behind. The
+ * subchunk cache is only attached once the chunk is accepted, so a rejected chunk that is destroyed
+ * on its request thread never reaches the cache.
+ * 
+ * @param chunk [in] std::shared_ptr<Chunk> The chunk to add
+ * @param token [in] const CancellationToken& The token of the request that produced the chunk
+ * 
+ * @return bool Whether or not the chunk was added
+ * 
+ */
+bool World::commitChunk(shared_ptr<Chunk> chunk, const CancellationToken &token){
+    std::scoped_lock lock(chunkMutex, requestMutex);  //Lock the guards to ensure safe access
+    if (token.isCancelled()){
+        return false;
+    }
+    // Fade the real chunk in over the placeholder if one is being shown
+    for (const auto& placeholder : placeholderChunks){
+        if (
+            placeholder->getChunkCoords()[0] == chunk->getChunkCoords()[0] &&
+            placeholder->getChunkCoords()[1] == chunk->getChunkCoords()[1]
+        ){
+            chunk->startFade(false);
+            break;
+        }
+    }
+    chunk->setSubChunkCache(subChunkCache);
+    chunks.push_back(chunk);
+    int cx = chunk->getChunkCoords()[0];
+    int cz = chunk->getChunkCoords()[1];
+    chunkRequests.erase(std::remove_if(chunkRequests.begin(), chunkRequests.end(),
+        [cx, cz](const std::pair<int, int>& request) {
+            return request.first == cx && request.second == cz;
+        }), chunkRequests.end()
+    );
+    return true;
+}
+
 /**
  * @brief This function will remove a chunk from the world
  * 
@@ -504,11 +732,64 @@ void World::addChunk(shared_ptr<Chunk> chunk){
  */
 void World::removeChunk(int cx, int cz){
     std::lock_guard<std::mutex> lock(chunkMutex);  //Lock the guard to ensure safe access
-    chunks.erase(std::remove_if(chunks.begin(), chunks.end(),
-        [cx, cz](const std::shared_ptr<Chunk>& chunk) {
-            return chunk->getChunkCoords()[0] == cx && chunk->getChunkCoords()[1] == cz;
-        }), chunks.end()
+    auto atCoords = [cx, cz](const std::shared_ptr<Chunk>& chunk) {
+        return chunk->getChunkCoords()[0] == cx && chunk->getChunkCoords()[1] == cz;
+    };
+    retireChunks(chunks, atCoords);
+    retireChunks(placeholderChunks, atCoords);
+    releaseCachedSubChunks();
+}
+
+/**
+ * @brief This function will move the chunks that the world no longer shows into the retired chunks
+ * 
+ * @details The mesh tasks of a retired chunk stop before their next subchunk. The chunk is kept
+ * until releaseRetiredChunks finds that none of its tasks are left, as a task that held the last
+ * reference would destroy the chunk on a worker thread. The chunk mutex must be held.
+ * 
+ * @param list [in] std::vector<std::shared_ptr<Chunk>>& The chunks to remove the retired chunks from
+ * @param shouldRetire [in] const std::function<bool(const std::shared_ptr<Chunk>&)>& Whether a chunk is retired
+ * 
+ * @return void
+ * 
+ */
+void World::retireChunks(
+    std::vector<std::shared_ptr<Chunk>> &list,
+    const std::function<bool(const std::shared_ptr<Chunk>&)> &shouldRetire
+){
+    auto retiredBegin = std::stable_partition(list.begin(), list.end(),
+        [&shouldRetire](const std::shared_ptr<Chunk>& chunk) {
+            return !shouldRetire(chunk);
+        }
     );
+    for (auto it = retiredBegin; it != list.end(); ++it){
+        (*it)->retire();
+        retiredChunks.push_back(*it);
+    }
+    list.erase(retiredBegin, list.end());
+}
+
+/**
+ * @brief This function will let go of the retired chunks that no mesh task holds any more
+ * 
+ * @details This must be called on the main thread, as destroying a chunk frees its textures.
+ * 
+ * @return void
+ * 
+ */
+void World::releaseRetiredChunks(){
+    std::vector<std::shared_ptr<Chunk>> released;
+    {
+        std::lock_guard<std::mutex> lock(chunkMutex);  //Lock the guard to ensure safe access
+        auto releasedBegin = std::stable_partition(retiredChunks.begin(), retiredChunks.end(),
+            [](const std::shared_ptr<Chunk>& chunk) {
+                return chunk->hasBuildsInFlight();
+            }
+        );
+        released.assign(releasedBegin, retiredChunks.end());
+        retiredChunks.erase(releasedBegin, retiredChunks.end());
+    }
+    // The chunks are destroyed here, outside of the lock
 }
 
 /**
@@ -580,17 +861,20 @@ bool World::isChunkRequested(int cx, int cz){
 /**
  * @brief This function will add a chunk request
  * 
- * @details This function will add a chunk request in a thread safe manner.
+ * @details This function will add a chunk request in a thread safe manner. The token for the
+ * request is taken under the same lock that clearChunks uses to advance the generation epoch, so
+ * a request can never be recorded against a generation that has already been cleared.
  * 
  * @param cx [in] int The chunk x coordinate
  * @param cz [in] int The chunk z coordinate
  * 
- * @return void
+ * @return CancellationToken The token that the work for this request must observe
  * 
  */
-void World::addChunkRequest(int cx, int cz){
+CancellationToken World::addChunkRequest(int cx, int cz){
     std::lock_guard<std::mutex> lock(requestMutex);  //Lock the guard to ensure safe access
     chunkRequests.push_back(std::make_pair(cx, cz));
+    return CancellationToken(generationEpoch);
 }
 
 /**
@@ -613,6 +897,58 @@ void World::removeChunkRequest(int cx, int cz){
     );
 }
 
+/**
+ * @brief This function will remove a chunk request if the request is still current
+ * 
+ * @details This is used when a request fails. If the request has been cancelled the request list
+ * has already been cleared and a new request for the same chunk may have been made, so the list
+ * is left untouched.
+ * 
+ * @param cx [in] int The chunk x coordinate
+ * @param cz [in] int The chunk z coordinate
+ * @param token [in] const CancellationToken& The token of the failed request
+ * 
+ * @return void
+ * 
+ */
+void World::releaseChunkRequest(int cx, int cz, const CancellationToken &token){
+    std::lock_guard<std::mutex> lock(requestMutex);  //Lock the guard to ensure safe access
+    if (token.isCancelled()){
+        return;
+    }
+    chunkRequests.erase(std::remove_if(chunkRequests.begin(), chunkRequests.end(),
+        [cx, cz](const std::pair<int, int>& request) {
+            return request.first == cx && request.second == cz;
+        }), chunkRequests.end()
+    );
+}
+
+/**
+ * @brief This function will cancel all of the chunk requests that are currently in flight
+ * 
+ * @details This function will advance the generation epoch so that every token handed out so far
+ * reports that it has been cancelled. Curl transfers are aborted on their next progress callback
+ * and the decoding and chunk creation steps bail out when they next check their token.
+ * 
+ * @return void
+ * 
+ */
+void World::cancelInFlightWork(){
+    std::lock_guard<std::mutex> lock(requestMutex);  //Lock the guard to ensure safe access
+    generationEpoch->fetch_add(1, std::memory_order_acq_rel);
+    chunkRequests.clear();
+}
+
+/**
+ * @brief This function will get a cancellation token for the current generation of the world
+ * 
+ * @return CancellationToken The token tied to the current generation epoch
+ * 
+ */
+CancellationToken World::getCancellationToken(){
+    return CancellationToken(generationEpoch);
+}
+
 /**
  * @brief This function will read the packet data from the server
  * 
@@ -625,12 +961,13 @@ void World::removeChunkRequest(int cx, int cz){
  * 
  * @param data [in] char* The data received from the server
  * @param len [in] int The length of the data received from the server
+ * @param token [in] const CancellationToken& The token of the request being decoded
  * 
  * @return std::unique_ptr<PacketData> The packet data
- * @return nullptr if the length of the data does not match
+ * @return nullptr if the length of the data does not match or the request was cancelled
  * 
  */
-std::unique_ptr<PacketData> World::readPacketData(char *data, int len){
+std::unique_ptr<PacketData> World::readPacketData(char *data, int len, const CancellationToken &token){
     std::unique_ptr<PacketData> packetData = make_unique<PacketData>();
     // We are going to iterate through the data that we have received and extract each field
     // in turn
@@ -661,7 +998,6 @@ std::unique_ptr<PacketData> World::readPacketData(char *data, int len){
         return nullptr;
         cerr << "ERROR: The length of the heightmap data does not match the expected length" << endl;
     }
-    packetData->heightmapData = vector<vector<float>>();
     packetData->biomeDataSize = *reinterpret_cast<int*>(data + index);
     index += sizeof(int);
     packetData->lenBiomeData = *reinterpret_cast<uint32_t*>(data + index);
@@ -670,37 +1006,35 @@ std::unique_ptr<PacketData> World::readPacketData(char *data, int len){
     index += sizeof(int);
     packetData->treesCount = *reinterpret_cast<uint32_t*>(data + index);
     index += sizeof(uint32_t);
-    // Extract the heightmap data
+    // Extract the heightmap data. The rows are allocated at their final size and decoded in place,
+    // so the only allocations are the ones the chunk keeps rather than rows that grow and are copied
+    packetData->heightmapData = vector<vector<float>>(packetData->vz, vector<float>(packetData->vx));
     for (int z = 0; z < packetData->vz; z++){
-        vector<float> heightmapRow = vector<float>();
+        if (token.isCancelled()){
+            return nullptr;
+        }
+        float *heightmapRow = packetData->heightmapData[z].data();
         for (int x = 0; x < packetData->vx; x++){
             // We know that each element in the heightmap data is size bits long (16 bits)
             uint16_t entry = *reinterpret_cast<uint16_t*>(data + index);
             index += sizeof(uint16_t);
             // We need to ensure that the value ranges from 0 to 1
-            float entryFloat = static_cast<float>(entry) / 65535.0f;
-
-            heightmapRow.push_back(entryFloat);
+            heightmapRow[x] = static_cast<float>(entry) / 65535.0f;
         }
-        packetData->heightmapData.push_back(heightmapRow);
     }
-    // Extract the biome data
+    // Extract the biome data, each element of which is 8 bits long
+    packetData->biomeData = vector<vector<uint8_t>>(packetData->vz);
     for (int z = 0; z < packetData->vz; z++){
-        vector<uint8_t> biomeRow = vector<uint8_t>();
-        for (int x = 0; x < packetData->vx; x++){
-            // We know that each element in the biome data is 8 bits long
-            uint8_t entry = *reinterpret_cast<uint8_t*>(data + index);
-            index += sizeof(uint8_t);
-            // We need to ensure that the value ranges from 0 to 1
-            biomeRow.push_back(entry);
-        }
-        packetData->biomeData.push_back(biomeRow);
+        const uint8_t *biomeRow = reinterpret_cast<const uint8_t*>(data + index);
+        packetData->biomeData[z].assign(biomeRow, biomeRow + packetData->vx);
+        index += packetData->vx * sizeof(uint8_t);
     }
     // Extract the trees data
     /*
         We know that there is packetData->treesCount number of values 
         Each two values form a pair of coordinates (x, z) for the tree
     */
+    packetData->treesCoords.reserve(std::max(packetData->treesCount, 0) / 2 + 1);
     for (int i = 0; i < packetData->treesCount; i+=2){
         // We know that each coordinate is 16 bits long
         float x = *reinterpret_cast<float*>(data + index);
@@ -778,20 +1112,48 @@ size_t World::writeCallback(void* contents, size_t size, size_t nmemb, void* use
     return totalSize;
 }
 
+/**
+ * @brief This callback function will be called periodically by libcurl while a transfer is active
+ * 
+ * @details Returning a non-zero value aborts the transfer with CURLE_ABORTED_BY_CALLBACK. This is
+ * used to stop downloading chunks that belong to a previous generation of the world.
+ * 
+ * @param clientp [in] void* The cancellation token of the request
+ * @param dltotal [in] curl_off_t The total number of bytes expected to be downloaded
+ * @param dlnow [in] curl_off_t The number of bytes downloaded so far
+ * @param ultotal [in] curl_off_t The total number of bytes expected to be uploaded
+ * @param ulnow [in] curl_off_t The number of bytes uploaded so far
+ * 
+ * @return int 1 if the transfer should be aborted, 0 otherwise
+ */
+int World::progressCallback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow){
+    (void)dltotal;
+    (void)dlnow;
+    (void)ultotal;
+    (void)ulnow;
+    const auto *token = static_cast<const CancellationToken*>(clientp);
+    return token->isCancelled() ? 1 : 0;
+}
+
 /**
  * @brief This function will request a new chunk from the server
  * 
  * @details This function will request a new chunk from the server. It will create a JSON
  * object with the parameters and send it to the server. It will also set the request to be
- * asynchronous.
+ * asynchronous. The transfer is aborted as soon as the token is cancelled.
  * 
  * @param cx [in] int The chunk x coordinate
  * @param cz [in] int The chunk z coordinate
+ * @param token [in] CancellationToken The token tied to the generation the request belongs to
  * 
  * @return std::unique_ptr<PacketData> The packet data received from the server
+ * @return nullptr if the request failed or was cancelled
  * 
  */
-std::unique_ptr<PacketData> World::requestNewChunk(int cx, int cz){
+std::unique_ptr<PacketData> World::requestNewChunk(int cx, int cz, CancellationToken token){
+    if (token.isCancelled()){
+        return nullptr;
+    }
     /*Create the JSON Request Object (This format needs to match the servers expected format)*/
     nlohmann::json payload = {
         {"mock_data", false},
@@ -1088,15 +1450,23 @@ std::unique_ptr<PacketData> World::requestNewChunk(int cx, int cz){
     std::unique_ptr<PacketData> packetData = std::make_unique<PacketData>();
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, World::writeCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, packetData.get());
+    // Setting the progress callback so that stale requests can be aborted mid-transfer
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, World::progressCallback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &token);
 
     // Perform the request
     CURLcode res = curl_easy_perform(curl);
     if (res != CURLE_OK) {
-        std::cerr << "ERROR: Failed to perform curl request: " << curl_easy_strerror(res) << std::endl;
+        if (res != CURLE_ABORTED_BY_CALLBACK){
+            std::cerr << "ERROR: Failed to perform curl request: " << curl_easy_strerror(res) << std::endl;
+        }
+        curl_slist_free_all(headers);
+        curl_easy_cleanup(curl);
         return nullptr;
     } else {
         // Parse the response data
-        packetData =std::move(readPacketData(packetData->rawData.data(), packetData->rawData.size()));
+        packetData =std::move(readPacketData(packetData->rawData.data(), packetData->rawData.size(), token));
     }
 
     /*Debug output*/
@@ -1141,6 +1511,133 @@ std::unique_ptr<PacketData> World::requestNewChunk(int cx, int cz){
     return packetData;
 }
 
+/**
+ * @brief This function will create a chunk from the packet data received from the server
+ * 
+ * @details The token is checked before the chunk is built so that no work is spent on chunks
+ * that belong to a previous generation of the world.
+ * 
+ * @param packetData [in] std::unique_ptr<PacketData> The decoded packet data
+ * @param token [in] const CancellationToken& The token of the request that produced the data
+ * 
+ * @return std::shared_ptr<Chunk> The new chunk
+ * @return nullptr if the request was cancelled
+ * 
+ */
+std::shared_ptr<Chunk> World::createChunk(std::unique_ptr<PacketData> packetData, const CancellationToken &token){
+    if (token.isCancelled()){
+        return nullptr;
+    }
+    std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(
+        packetData->cx + packetData->cz * std::numeric_limits<int>::max(),
+        settings,
+        std::vector<int>{packetData->cx, packetData->cz},
+        packetData->heightmapData,
+        packetData->biomeData,
+        terrainShader,
+        oceanShader,
+        terrainTextures,
+        terrainTextureArrays,
+        reflectionBuffer,
+        refractionBuffer,
+        oceanTextures,
+        subbiomeTextureArrayMap
+    );
+    chunk->setMeshWorkers(meshWorkers);
+    chunk->setBuildToken(token);
+    chunk->setBufferPool(bufferPool);
+    return chunk;
+}
+
+/**
+ * @brief This function will create a placeholder chunk for a chunk that is still being generated
+ * 
+ * @details The placeholder uses an approximate heightmap and biome map from the placeholder
+ * generator so that the area is not empty while the server generates the real chunk.
+ * 
+ * @param cx [in] int The chunk x coordinate
+ * @param cz [in] int The chunk z coordinate
+ * @param generator [in] std::shared_ptr<PlaceholderTerrain> The placeholder generator
+ * @param token [in] const CancellationToken& The token of the request for the real chunk
+ * 
+ * @return std::shared_ptr<Chunk> The placeholder chunk
+ * @return nullptr if the request was cancelled
+ * 
+ */
+std::shared_ptr<Chunk> World::createPlaceholderChunk(
+    int cx,
+    int cz,
+    std::shared_ptr<PlaceholderTerrain> generator,
+    const CancellationToken &token
+){
+    if (token.isCancelled()){
+        return nullptr;
+    }
+    std::vector<std::vector<float>> heightmap = generator->generateHeightmap(cx, cz);
+    std::vector<std::vector<uint8_t>> biomes = generator->generateBiomes(heightmap);
+    if (token.isCancelled()){
+        return nullptr;
+    }
+    std::shared_ptr<Chunk> placeholder = std::make_shared<Chunk>(
+        cx + cz * std::numeric_limits<int>::max(),
+        settings,
+        std::vector<int>{cx, cz},
+        heightmap,
+        biomes,
+        terrainShader,
+        oceanShader,
+        terrainTextures,
+        terrainTextureArrays,
+        reflectionBuffer,
+        refractionBuffer,
+        oceanTextures,
+        subbiomeTextureArrayMap
+    );
+    placeholder->setPlaceholder(true);
+    placeholder->setMeshWorkers(meshWorkers);
+    placeholder->setBuildToken(token);
+    placeholder->setBufferPool(bufferPool);
+    return placeholder;
+}
+
+/**
+ * @brief This function will add a placeholder chunk to the world
+ * 
+ * @details The placeholder is only added if its request is still current and neither the real
+ * chunk nor another placeholder for the same coordinates is already in the world. Like the real
+ * chunks, the placeholder is only given the subchunk cache once it has been accepted.
+ * 
+ * @param chunk [in] std::shared_ptr<Chunk> The placeholder chunk
+ * @param token [in] const CancellationToken& The token of the request for the real chunk
+ * 
+ * @return bool Whether or not the placeholder was added
+ * 
+ */
+bool World::addPlaceholderChunk(std::shared_ptr<Chunk> chunk, const CancellationToken &token){
+    if (chunk == nullptr){
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(chunkMutex);  //Lock the guard to ensure safe access
+    if (token.isCancelled()){
+        return false;
+    }
+    int cx = chunk->getChunkCoords()[0];
+    int cz = chunk->getChunkCoords()[1];
+    bool isFound;
+    getChunk(cx, cz, isFound);
+    if (isFound){
+        return false;
+    }
+    for (const auto& placeholder : placeholderChunks){
+        if (placeholder->getChunkCoords()[0] == cx && placeholder->getChunkCoords()[1] == cz){
+            return false;
+        }
+    }
+    chunk->setSubChunkCache(subChunkCache);
+    placeholderChunks.push_back(chunk);
+    return true;
+}
+
 /**
  * @brief This function will request the initial chunks to be loaded
  * 
@@ -1150,85 +1647,63 @@ std::unique_ptr<PacketData> World::requestNewChunk(int cx, int cz){
  * 
  * @param initialChunks [in] std::vector<std::pair<int, int>> The initial chunks to be loaded
  * 
- * @return int 0 if successful, -1 if failed
+ * @return int 0 if successful, -1 if the requests were cancelled
  * 
  */
 int World::requestInitialChunks(std::vector<std::pair<int, int>> initialChunks){
     //Launch the initial chunk requests asynchronously
     std::vector<std::future<std::unique_ptr<PacketData>>> futures;
+    std::vector<CancellationToken> tokens;
     for (const auto& [cx, cz] : initialChunks) {
-        addChunkRequest(cx, cz);
+        tokens.push_back(addChunkRequest(cx, cz));
         futures.push_back(
-            std::async(std::launch::async, &World::requestNewChunk, this, cx, cz)
+            std::async(std::launch::async, &World::requestNewChunk, this, cx, cz, tokens.back())
         );
     }
     // We are going also going to track the requests that failed
-    std::vector<std::pair<int, int>> failedRequests;
+    std::vector<size_t> failedRequests;
     std::vector<std::future<std::unique_ptr<PacketData>>> failedFutures;
     for (size_t i = 0; i < futures.size(); ++i) {
         auto packetData = futures[i].get();
+        if (tokens[i].isCancelled()) {
+            // The world has been regenerated again while we were waiting
+            return -1;
+        }
         if (packetData == nullptr) {
             std::cerr << "ERROR: Failed to get packet data" << std::endl;
             // We are going to add the request to the failed requests
-            failedRequests.push_back(initialChunks[i]);
+            failedRequests.push_back(i);
             continue;
         }
-        // If the request was successful, we are going to create the chunk
-        std::shared_ptr<Chunk> newChunk = std::make_shared<Chunk>(
-            packetData->cx + packetData->cz * std::numeric_limits<int>::max(),
-            settings,
-            std::vector<int>{packetData->cx, packetData->cz},
-            packetData->heightmapData,
-            packetData->biomeData,
-            terrainShader,
-            oceanShader,
-            terrainTextures,
-            terrainTextureArrays,
-            reflectionBuffer,
-            refractionBuffer,
-            oceanTextures,
-            subbiomeTextureArrayMap
-        );
-        // We are going to add the chunk to the world
-        addChunk(newChunk);
-        // We are going to remove the request from the list of requests
-        removeChunkRequest(packetData->cx, packetData->cz);
+        // If the request was successful, we are going to create the chunk and add it to the world
+        std::shared_ptr<Chunk> newChunk = createChunk(std::move(packetData), tokens[i]);
+        if (newChunk == nullptr || !commitChunk(newChunk, tokens[i])) {
+            return -1;
+        }
     }
-    // We are going to try to request the failed requests again
-    for (const auto& [cx, cz] : failedRequests) {
-        std::cerr << "Retrying initial chunk request at (" << cx << ", " << cz << ")" << std::endl;
-        addChunkRequest(cx, cz);
+    // We are going to try to request the failed requests again (the requests are still recorded)
+    for (size_t i : failedRequests) {
+        std::cerr << "Retrying initial chunk request at (" << initialChunks[i].first << ", " << initialChunks[i].second << ")" << std::endl;
         failedFutures.push_back(
-            std::async(std::launch::async, &World::requestNewChunk, this, cx, cz)
+            std::async(std::launch::async, &World::requestNewChunk, this, initialChunks[i].first, initialChunks[i].second, tokens[i])
         );
     }
     // We are going to wait for the failed requests to finish
     for (size_t i = 0; i < failedFutures.size(); ++i) {
+        const CancellationToken &token = tokens[failedRequests[i]];
         auto packetData = failedFutures[i].get();
+        if (token.isCancelled()) {
+            return -1;
+        }
         if (packetData == nullptr) {
             std::cerr << "ERROR: Failed to get packet data" << std::endl;
+            releaseChunkRequest(initialChunks[failedRequests[i]].first, initialChunks[failedRequests[i]].second, token);
             continue;
         }
-        // If the request was successful, we are going to create the chunk
-        std::shared_ptr<Chunk> newChunk = std::make_shared<Chunk>(
-            packetData->cx + packetData->cz * std::numeric_limits<int>::max(),
-            settings,
-            std::vector<int>{packetData->cx, packetData->cz},
-            packetData->heightmapData,
-            packetData->biomeData,
-            terrainShader,
-            oceanShader,
-            terrainTextures,
-            terrainTextureArrays,
-            reflectionBuffer,
-            refractionBuffer,
-            oceanTextures,
-            subbiomeTextureArrayMap
-        );
-        // We are going to add the chunk to the world
-        addChunk(newChunk);
-        // We are going to remove the request from the list of requests
-        removeChunkRequest(packetData->cx, packetData->cz);
+        std::shared_ptr<Chunk> newChunk = createChunk(std::move(packetData), token);
+        if (newChunk == nullptr || !commitChunk(newChunk, token)) {
+            return -1;
+        }
     }
     return 0;
 }
@@ -1289,7 +1764,10 @@ int World::regenerateSpawnChunks(glm::vec3 playerPos){
         {cx - 1, cz},
         {cx, cz}
     };
-    requestInitialChunks(initialChunks);
+    if (requestInitialChunks(initialChunks) != 0){
+        // The world was cleared again before the spawn chunks arrived so there is nothing to place
+        return -1;
+    }
     // We are going to need to set the players position to the height of the vertex at chunk (0,0)
     // and coordinate (0,0)
     // Acquire the chunk lock
@@ -1333,41 +1811,46 @@ int World::requestNewChunkAsync(int cx, int cz){
         return 1;
     }
     // Add the chunk request to the list of requests
-    addChunkRequest(cx, cz);
+    CancellationToken token = addChunkRequest(cx, cz);
+    {
+        std::lock_guard<std::mutex> lock(inFlightMutex);
+        inFlightRequests++;
+    }
+    std::shared_ptr<PlaceholderTerrain> generator = nullptr;
+    if (settings->getPlaceholderTerrain()){
+        std::lock_guard<std::mutex> lock(requestMutex);  //Lock the guard to ensure safe access
+        generator = placeholderTerrain;
+    }
     // Request the chunk asynchronously
     std::future<std::unique_ptr<PacketData>> future = std::async(
-        std::launch::async, &World::requestNewChunk, this, cx, cz
+        std::launch::async, &World::requestNewChunk, this, cx, cz, token
     );
-    std::thread([this, future=std::move(future), cx, cz]() mutable {
+    std::thread([this, future=std::move(future), cx, cz, token, generator]() mutable {
+        // Show approximate terrain while the server generates the real chunk
+        if (generator != nullptr){
+            addPlaceholderChunk(createPlaceholderChunk(cx, cz, generator, token), token);
+        }
         // Wait for the request to finish
         auto packetData = future.get();
         // Check that the request was successful
         if (packetData == nullptr){
-            std::cerr << "ERROR: Failed to get packet data" << std::endl;
+            if (!token.isCancelled()){
+                std::cerr << "ERROR: Failed to get packet data" << std::endl;
+            }
             // Remove the request from the list of requests
-            removeChunkRequest(cx, cz);
-            return;
+            releaseChunkRequest(cx, cz, token);
+        } else {
+            // Create the new chunk and add it to the world if it still belongs to this generation
+            std::shared_ptr<Chunk> newChunk = createChunk(std::move(packetData), token);
+            if (newChunk != nullptr){
+                commitChunk(newChunk, token);
+            }
         }
-        // Create the new chunk
-        std::shared_ptr<Chunk> newChunk = std::make_shared<Chunk>(
-            packetData->cx + packetData->cz * std::numeric_limits<int>::max(),
-            settings,
-            std::vector<int>{packetData->cx, packetData->cz},
-            packetData->heightmapData,
-            packetData->biomeData,
-            terrainShader,
-            oceanShader,
-            terrainTextures,
-            terrainTextureArrays,
-            reflectionBuffer,
-            refractionBuffer,
-            oceanTextures,
-            subbiomeTextureArrayMap
-        );
-        // Add the chunk to the world
-        addChunk(newChunk);
-        // Remove the request from the list of requests
-        removeChunkRequest(cx, cz);
+        // The notify must happen while the lock is held as the world may be destroyed as soon as
+        // the count reaches zero
+        std::lock_guard<std::mutex> lock(inFlightMutex);
+        inFlightRequests--;
+        inFlightCondition.notify_all();
     }).detach();
     return 0;
 }
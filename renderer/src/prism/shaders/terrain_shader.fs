@@ -46,11 +46,28 @@ uniform FogParams fogParams;
 uniform vec3 viewPos;  // This is the camera world position
 uniform vec3 colour;
 uniform vec2 chunkOrigin;
+uniform float biomeScale; // The number of world units (and texels of the biome map) between the biomes of the terrain
+
+uniform float fade; // The visible fraction of the terrain while it is cross-fading
+uniform bool fadeOut; // Whether the terrain is fading out rather than in
+
+uniform usampler2D biomeMap; // The biomes of the whole chunk including its border
+uniform vec2 biomeMapOrigin; // The texel under the origin of the terrain
+
+// The normals baked at the full resolution of the heightmap of the chunk, holding the x and z components
+uniform bool useNormalMap;
+uniform sampler2D normalMap;
+uniform vec2 normalMapOrigin; // The texel under the origin of the terrain
 
-uniform usampler2D biomeMap;
 uniform sampler2DArray diffuseTextureArray;
 uniform int subbiomeTextureArrayMap[34]; // index 0 unused
 
+// Reads the biome of the terrain at the given cell from the biome map of the chunk
+uint sampleBiome(vec2 cell) {
+    ivec2 texel = ivec2(floor(biomeMapOrigin + cell * biomeScale + 0.5));
+    return texelFetch(biomeMap, clamp(texel, ivec2(0), textureSize(biomeMap, 0) - 1), 0).r;
+}
+
 // The linear fog factor function
 float calculateFogFactor() {
     float distance = length(fragPos - viewPos);
@@ -114,13 +131,36 @@ vec4 triplanarMapping(vec3 position, vec3 normal, sampler2DArray texArray, int l
     return texX * blendWeights.x + texY * blendWeights.y + texZ * blendWeights.z;
 }
 
+// A 4x4 ordered dither threshold. Two chunks that overlap while cross-fading use complementary
+// thresholds so every pixel is covered by exactly one of them without needing blending or sorting
+float ditherThreshold() {
+    const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    int x = int(mod(gl_FragCoord.x, 4.0));
+    int y = int(mod(gl_FragCoord.y, 4.0));
+    return (bayer[y * 4 + x] + 0.5) / 16.0;
+}
+
 int getTextureIndexForSubbiome(int subbiomeId) {
     return subbiomeTextureArrayMap[subbiomeId];
 }
 
 void main()
 {
+    // Discard the dithered fraction of the fragments that should not be visible during a cross-fade
+    if (fade < 1.0 || fadeOut) {
+        float threshold = ditherThreshold();
+        if (fadeOut ? threshold < fade : threshold >= fade) {
+            discard;
+        }
+    }
+
     vec3 normal = normalize(fragNormal);
+    if (useNormalMap) {
+        // The terrain is only translated so the baked normals are already in world space
+        vec2 texel = normalMapOrigin + fragPos.xz - chunkOrigin;
+        vec2 baked = texture(normalMap, (texel + 0.5) / vec2(textureSize(normalMap, 0))).rg;
+        normal = normalize(vec3(baked.x, sqrt(max(1.0 - dot(baked, baked), 0.0)), baked.y));
+    }
 
     // vec4 noise =  texture2D(noiseTexture, fragPos.xz + chunkOrigin); // Sample the noise texture
     // float noiseValue = noise.r; // Get the red channel
@@ -129,16 +169,15 @@ void main()
     float noiseValue = 0.0; // May be used for future texture coordinate offsetting
 
     // Calculate the biome map index
-    vec2 uv = fragPos.xz - chunkOrigin; 
-    vec2 texelSize = 1.0 / vec2(32.0);
+    vec2 uv = (fragPos.xz - chunkOrigin) / biomeScale; 
     vec2 baseUV = floor(uv);
     vec2 f = fract(uv);
 
     // Sample 2×2 neighborhood of biome map to find neighboring biomes
-    uint b00 = texture(biomeMap, (baseUV + vec2(0, 0)) / 32.0).r;
-    uint b10 = texture(biomeMap, (baseUV + vec2(1, 0)) / 32.0).r;
-    uint b01 = texture(biomeMap, (baseUV + vec2(0, 1)) / 32.0).r;
-    uint b11 = texture(biomeMap, (baseUV + vec2(1, 1)) / 32.0).r;
+    uint b00 = sampleBiome(baseUV + vec2(0, 0));
+    uint b10 = sampleBiome(baseUV + vec2(1, 0));
+    uint b01 = sampleBiome(baseUV + vec2(0, 1));
+    uint b11 = sampleBiome(baseUV + vec2(1, 1));
 
     float flatnessWeight;
     float midGroundWeight;
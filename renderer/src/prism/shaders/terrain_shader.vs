@@ -10,16 +10,89 @@ uniform mat3 normalMatrix;
 
 uniform vec4 clippingPlane;
 
+// The camera distances over which vertices morph towards the next coarser level of detail
+uniform vec2 morphRange;
+uniform vec3 viewPos;
+
+// When the terrain is displaced on the GPU the vertices are a flat grid in heightmap units and the
+// heights are read from the heightmap texture of the chunk
+uniform bool gpuDisplacement;
+uniform sampler2D heightMap;
+uniform vec2 heightMapOrigin; // The texel under the first vertex of the grid
+uniform float heightMapSpacing; // The number of texels (and world units) between heightmap values of the terrain
+uniform float gridResolution; // The number of grid vertices per heightmap value
+uniform vec2 morphOffset; // The parity offset of the next coarser grid
+uniform float skirtHeight; // The height of the bottom of the skirts
+uniform float maximumHeight;
+
+// The meshes built on the CPU use the compact terrain layout, where aPos.xy holds the grid indices,
+// aNormal.xy holds the height and morph target as fractions of the height range and aTexCoords
+// holds the octahedral normal
+uniform bool compactVertices;
+uniform vec2 heightRange; // The lowest height and the size of the height range
+
 out vec3 fragPos;
 out vec3 fragNormal;
 
+float sampleHeight(vec2 gridPos)
+{
+    vec2 texel = heightMapOrigin + gridPos * heightMapSpacing;
+    return texture(heightMap, (texel + 0.5) / vec2(textureSize(heightMap, 0))).r * maximumHeight;
+}
+
+vec3 decodeNormal(vec2 encoded)
+{
+    vec3 normal = vec3(encoded.x, 1.0 - abs(encoded.x) - abs(encoded.y), encoded.y);
+    if (normal.y < 0.0) {
+        normal.xz = (1.0 - abs(normal.zx)) * vec2(normal.x >= 0.0 ? 1.0 : -1.0, normal.z >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(normal);
+}
+
 void main()
 {
-    fragPos = vec3(model * vec4(aPos, 1.0));
+    vec3 position = aPos;
+    float morphTarget = aTexCoords.x;
+    vec3 normal = aNormal;
+    if (compactVertices) {
+        vec2 localPos = aPos.xy / gridResolution * heightMapSpacing;
+        position = vec3(localPos.x, heightRange.x + aNormal.x * heightRange.y, localPos.y);
+        morphTarget = heightRange.x + aNormal.y * heightRange.y;
+        normal = decodeNormal(aTexCoords);
+    } else if (gpuDisplacement) {
+        vec2 gridPos = aPos.xz;
+        float gridStep = 1.0 / gridResolution;
+        // Follow the same rules as the meshes built on the CPU, the morph target of a vertex that
+        // is not on the coarser grid is the average of the coarser vertices along its edge
+        vec2 parity = mod(round(gridPos * gridResolution) + morphOffset, 2.0);
+        position = vec3(gridPos.x * heightMapSpacing, sampleHeight(gridPos), gridPos.y * heightMapSpacing);
+        morphTarget = position.y;
+        if (parity.x + parity.y > 0.0) {
+            morphTarget = 0.5 * (sampleHeight(gridPos - parity * gridStep) + sampleHeight(gridPos + parity * gridStep));
+        }
+        // The skirt vertices are marked by the second texture coordinate and do not morph
+        if (aTexCoords.y > 0.5) {
+            position.y = skirtHeight;
+            morphTarget = skirtHeight;
+        }
+        float left = sampleHeight(gridPos - vec2(gridStep, 0.0));
+        float right = sampleHeight(gridPos + vec2(gridStep, 0.0));
+        float down = sampleHeight(gridPos - vec2(0.0, gridStep));
+        float up = sampleHeight(gridPos + vec2(0.0, gridStep));
+        float worldStep = 2.0 * gridStep * heightMapSpacing;
+        normal = normalize(vec3((left - right) / worldStep, 1.0, (down - up) / worldStep));
+    }
+
+    // The morph target height of the vertex is stored in the first texture coordinate
+    vec3 worldPos = vec3(model * vec4(position, 1.0));
+    float morph = clamp((distance(worldPos.xz, viewPos.xz) - morphRange.x) / (morphRange.y - morphRange.x), 0.0, 1.0);
+    position.y = mix(position.y, morphTarget, morph);
+
+    fragPos = vec3(model * vec4(position, 1.0));
 
     gl_ClipDistance[0] = dot(fragPos, clippingPlane.xyz) + clippingPlane.w;
 
-    fragNormal = normalMatrix * aNormal;
+    fragNormal = normalMatrix * normal;
 
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * model * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,15 @@
+#version 410 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+// The vertices are the flat grid in heightmap units, the heights are added after tessellation
+out vec2 controlGridPos;
+out float controlSkirt;
+
+void main()
+{
+    controlGridPos = aPos.xz;
+    // The skirt vertices are marked by the second texture coordinate
+    controlSkirt = aTexCoords.y;
+}
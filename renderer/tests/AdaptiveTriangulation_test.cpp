@@ -0,0 +1,124 @@
+// AdaptiveTriangulation_test.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "AdaptiveTriangulation.hpp"
+#include "MeshIndexing.hpp"
+
+// --- Helpers ---
+
+// Returns the signed area of a triangle in x and z, negative for the winding of the grid triangles
+static long signedArea(const std::vector<unsigned int>& indices, size_t i, int n) {
+    long ax = indices[i] % n, az = indices[i] / n;
+    long bx = indices[i + 1] % n, bz = indices[i + 1] / n;
+    long cx = indices[i + 2] % n, cz = indices[i + 2] / n;
+    return (bx - ax) * (cz - az) - (bz - az) * (cx - ax);
+}
+
+// Returns the largest distance between the heights and the triangles that cover them
+static float measureError(const std::vector<unsigned int>& indices, const std::vector<float>& heights, int n) {
+    float error = 0.0f;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        int ax = indices[i] % n, az = indices[i] / n;
+        int bx = indices[i + 1] % n, bz = indices[i + 1] / n;
+        int cx = indices[i + 2] % n, cz = indices[i + 2] / n;
+        float area = static_cast<float>((bx - ax) * (cz - az) - (bz - az) * (cx - ax));
+        for (int z = std::min({az, bz, cz}); z <= std::max({az, bz, cz}); z++) {
+            for (int x = std::min({ax, bx, cx}); x <= std::max({ax, bx, cx}); x++) {
+                float weightA = static_cast<float>((bx - x) * (cz - z) - (bz - z) * (cx - x)) / area;
+                float weightB = static_cast<float>((cx - x) * (az - z) - (cz - z) * (ax - x)) / area;
+                float weightC = 1.0f - weightA - weightB;
+                if (weightA < 0.0f || weightB < 0.0f || weightC < -1e-6f) {
+                    continue;
+                }
+                float plane = weightA * heights[indices[i]] + weightB * heights[indices[i + 1]] +
+                              weightC * heights[indices[i + 2]];
+                error = std::max(error, std::abs(heights[z * n + x] - plane));
+            }
+        }
+    }
+    return error;
+}
+
+// Builds rolling hills with a flat plain across half of the grid
+static std::vector<float> makeHills(int n, unsigned int seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+    std::vector<float> heights(n * n);
+    for (int z = 0; z < n; z++) {
+        for (int x = 0; x < n; x++) {
+            float hills = 20.0f * std::sin(x * 0.2f) * std::cos(z * 0.15f) + noise(generator);
+            heights[z * n + x] = x < n / 2 ? 10.0f : hills;
+        }
+    }
+    return heights;
+}
+
+// --- Tests ---
+
+TEST(AdaptiveTriangulationTest, GridSizeTest) {
+    EXPECT_EQ(AdaptiveTriangulation::getGridSize(2), 2);
+    EXPECT_EQ(AdaptiveTriangulation::getGridSize(32), 33);
+    EXPECT_EQ(AdaptiveTriangulation::getGridSize(33), 33);
+    EXPECT_EQ(AdaptiveTriangulation::getGridSize(63), 65);
+    EXPECT_EQ(AdaptiveTriangulation::getGridSize(125), 129);
+}
+
+TEST(AdaptiveTriangulationTest, FlatGridTest) {
+    // A plane on a 2^k + 1 grid needs only the two root triangles
+    std::vector<float> heights(33 * 33);
+    for (int i = 0; i < 33 * 33; i++) {
+        heights[i] = 0.5f * (i % 33) + 0.25f * (i / 33);
+    }
+    EXPECT_EQ(AdaptiveTriangulation::generateIndices(heights.data(), 33, 0.0f).size(), 6u);
+}
+
+TEST(AdaptiveTriangulationTest, CoverageAndWindingTest) {
+    // Every triangulation covers the whole grid once with the winding of the grid triangles
+    for (int n : {2, 9, 32, 33, 63}) {
+        std::vector<float> heights = makeHills(n, 1);
+        for (float maxError : {0.0f, 0.5f, 100.0f}) {
+            std::vector<unsigned int> indices = AdaptiveTriangulation::generateIndices(heights.data(), n, maxError);
+            long area = 0;
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                long triangleArea = signedArea(indices, i, n);
+                EXPECT_LT(triangleArea, 0);
+                area += triangleArea;
+            }
+            EXPECT_EQ(-area, 2L * (n - 1) * (n - 1));
+        }
+    }
+    std::vector<unsigned int> grid = MeshIndexing::generateRowOrderIndices(9);
+    EXPECT_LT(signedArea(grid, 0, 9), 0);
+    EXPECT_LT(signedArea(grid, 3, 9), 0);
+}
+
+TEST(AdaptiveTriangulationTest, ErrorBoundTest) {
+    for (int n : {32, 63}) {
+        std::vector<float> heights = makeHills(n, 2);
+        for (float maxError : {0.0f, 0.1f, 1.0f, 4.0f}) {
+            std::vector<unsigned int> indices = AdaptiveTriangulation::generateIndices(heights.data(), n, maxError);
+            EXPECT_LE(measureError(indices, heights, n), maxError + 1e-4f);
+        }
+    }
+}
+
+TEST(AdaptiveTriangulationTest, TriangleCountBenchmarkTest) {
+    // Reports the triangles kept for the mesh sizes used by the terrain at a few maximum errors
+    for (int n : {32, 63, 125}) {
+        std::vector<float> heights = makeHills(n, 3);
+        std::vector<float> errors = AdaptiveTriangulation::computeErrors(heights.data(), n);
+        size_t gridTriangles = 2 * (n - 1) * (n - 1);
+        size_t previous = gridTriangles + 1;
+        for (float maxError : {0.1f, 0.5f, 2.0f}) {
+            size_t triangles = AdaptiveTriangulation::generateIndicesFromErrors(errors, n, maxError).size() / 3;
+            RecordProperty("triangles_" + std::to_string(n) + "_" + std::to_string(maxError), std::to_string(triangles));
+            EXPECT_LE(triangles, previous);
+            previous = triangles;
+        }
+        EXPECT_LT(previous, gridTriangles / 2);
+    }
+}
@@ -0,0 +1,98 @@
+// ChunkLifetime_test.cpp
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Chunk.hpp"
+#include "SubChunk.hpp"
+#include "Settings.hpp"
+#include "WorkerPool.hpp"
+#include "CancellationToken.hpp"
+#include "TestHelpers.hpp"
+
+// --- Helpers ---
+
+// Builds a chunk of flat terrain without any shaders or textures, nothing here touches OpenGL as
+// long as the subchunks are never set up
+static std::shared_ptr<Chunk> makeChunk(std::shared_ptr<Settings> settings) {
+    int width = settings->getChunkSize() + 2;
+    return std::make_shared<Chunk>(
+        0,
+        settings,
+        std::vector<int>{0, 0},
+        std::vector<std::vector<float>>(width, std::vector<float>(width, 0.5f)),
+        std::vector<std::vector<uint8_t>>(width, std::vector<uint8_t>(width, 1)),
+        nullptr,
+        nullptr,
+        std::vector<std::shared_ptr<Texture>>(),
+        std::vector<std::shared_ptr<TextureArray>>(),
+        nullptr,
+        nullptr,
+        std::vector<std::shared_ptr<Texture>>(),
+        nullptr
+    );
+}
+
+// --- Tests ---
+
+TEST(ChunkLifetimeTest, SubChunkDoesNotOwnItsParentTest) {
+    auto settings = std::make_shared<Settings>();
+    std::shared_ptr<Chunk> chunk = makeChunk(settings);
+    std::shared_ptr<SubChunk> subChunk = chunk->buildSubChunk(0, 1.0f);
+    EXPECT_EQ(subChunk->getParentChunk(), chunk.get());
+    EXPECT_EQ(chunk.use_count(), 1);
+}
+
+TEST(ChunkLifetimeTest, RemovedChunkIsDestroyedTest) {
+    auto settings = std::make_shared<Settings>();
+    auto workers = std::make_shared<WorkerPool>(1);
+    std::shared_ptr<Chunk> chunk = makeChunk(settings);
+    chunk->setMeshWorkers(workers);
+    chunk->requestSubChunkBuilds({std::make_pair(0, 1.0f), std::make_pair(1, 1.0f)});
+    waitForWorkers(*workers);
+    // The built subchunks are held by the chunk until they are collected, which must not keep the
+    // chunk alive once the world lets go of it
+    std::weak_ptr<Chunk> weakChunk = chunk;
+    chunk.reset();
+    EXPECT_TRUE(weakChunk.expired());
+}
+
+TEST(ChunkLifetimeTest, MeshTasksAreCountedUntilDestroyedTest) {
+    auto settings = std::make_shared<Settings>();
+    auto workers = std::make_shared<WorkerPool>(1);
+    std::shared_ptr<Chunk> chunk = makeChunk(settings);
+    chunk->setMeshWorkers(workers);
+    // Hold the worker so that the build is still queued
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    workers->submit([opened]() { opened.wait(); });
+    chunk->requestSubChunkBuilds({std::make_pair(0, 1.0f)});
+    EXPECT_TRUE(chunk->hasBuildsInFlight());
+    gate.set_value();
+    waitForWorkers(*workers);
+    EXPECT_FALSE(chunk->hasBuildsInFlight());
+}
+
+TEST(ChunkLifetimeTest, CancelledBuildsDoNotHoldTheChunkTest) {
+    auto settings = std::make_shared<Settings>();
+    auto workers = std::make_shared<WorkerPool>(1);
+    auto epoch = std::make_shared<std::atomic<uint64_t>>(0);
+    std::shared_ptr<Chunk> chunk = makeChunk(settings);
+    chunk->setMeshWorkers(workers);
+    chunk->setBuildToken(CancellationToken(epoch));
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    workers->submit([opened]() { opened.wait(); });
+    chunk->requestSubChunkBuilds({std::make_pair(0, 1.0f), std::make_pair(1, 1.0f)});
+    // The queued build is dropped once the world generation moves on
+    epoch->fetch_add(1);
+    EXPECT_EQ(chunk.use_count(), 1);
+    gate.set_value();
+    waitForWorkers(*workers);
+    EXPECT_FALSE(chunk->hasBuildsInFlight());
+    EXPECT_EQ(chunk.use_count(), 1);
+}
@@ -0,0 +1,78 @@
+// ChunkQuadtree_test.cpp
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "ChunkQuadtree.hpp"
+#include "TestHelpers.hpp"
+
+// --- Helpers ---
+
+// Counts how many selected nodes cover each subchunk
+static std::vector<int> coverage(const ChunkQuadtree& tree, const std::vector<QuadtreeNode>& nodes) {
+    int leaves = tree.getLeavesPerAxis();
+    std::vector<int> counts(leaves * leaves, 0);
+    for (const QuadtreeNode& node : nodes) {
+        for (int z = node.z; z < node.z + (1 << node.level); z++) {
+            for (int x = node.x; x < node.x + (1 << node.level); x++) {
+                if (x < leaves && z < leaves) {
+                    counts[z * leaves + x]++;
+                }
+            }
+        }
+    }
+    return counts;
+}
+
+// --- Tests ---
+
+TEST(ChunkQuadtreeTest, NodeKeyRoundTripTest) {
+    ChunkQuadtree tree(makeWaveHeightmap(1024, 0.0f), 1024, 32, 256.0f);
+
+    EXPECT_EQ(tree.getLeavesPerAxis(), 33);
+    EXPECT_EQ(tree.getLevelCount(), 7);
+    QuadtreeNode node{2, 8, 12};
+    QuadtreeNode decoded = tree.getNodeFromKey(tree.getNodeKey(node));
+    EXPECT_EQ(decoded.level, 2);
+    EXPECT_EQ(decoded.x, 8);
+    EXPECT_EQ(decoded.z, 12);
+    // Subchunk keys are the same as the subchunk ids
+    EXPECT_EQ(tree.getNodeKey(QuadtreeNode{0, 5, 3}), 3 * 33 + 5);
+}
+
+TEST(ChunkQuadtreeTest, ErrorNeverDecreasesUpTheTreeTest) {
+    ChunkQuadtree tree(makeWaveHeightmap(1024, 0.05f), 1024, 32, 256.0f);
+
+    for (int level = 1; level < tree.getLevelCount(); level++) {
+        for (int z = 0; z < tree.getLeavesPerAxis(); z += 1 << level) {
+            for (int x = 0; x < tree.getLeavesPerAxis(); x += 1 << level) {
+                float parentError = tree.getNodeError(QuadtreeNode{level, x, z});
+                float childError = tree.getNodeError(QuadtreeNode{level - 1, x, z});
+                EXPECT_GE(parentError, childError);
+            }
+        }
+    }
+}
+
+TEST(ChunkQuadtreeTest, SelectionCoversEachSubchunkOnceTest) {
+    ChunkQuadtree tree(makeWaveHeightmap(1024, 0.05f), 1024, 32, 256.0f);
+    float projectionScale = ChunkQuadtree::getProjectionScale(1080.0f, 45.0f);
+
+    std::vector<QuadtreeNode> nodes = tree.selectNodes(glm::vec2(100.0f, 700.0f), 1e6f, projectionScale, 2.0f);
+    for (int count : coverage(tree, nodes)) {
+        EXPECT_EQ(count, 1);
+    }
+    for (const QuadtreeNode& node : nodes) {
+        EXPECT_TRUE(tree.isInsideChunk(node));
+    }
+}
+
+TEST(ChunkQuadtreeTest, FlatTerrainUsesFewerNodesTest) {
+    ChunkQuadtree flat(makeWaveHeightmap(1024, 0.0f), 1024, 32, 256.0f);
+    ChunkQuadtree rough(makeWaveHeightmap(1024, 0.3f), 1024, 32, 256.0f);
+    float projectionScale = ChunkQuadtree::getProjectionScale(1080.0f, 45.0f);
+
+    size_t flatNodes = flat.selectNodes(glm::vec2(512.0f, 512.0f), 1e6f, projectionScale, 2.0f).size();
+    size_t roughNodes = rough.selectNodes(glm::vec2(512.0f, 512.0f), 1e6f, projectionScale, 2.0f).size();
+    EXPECT_LT(flatNodes, roughNodes);
+    EXPECT_LT(flatNodes, static_cast<size_t>(33 * 33));
+}
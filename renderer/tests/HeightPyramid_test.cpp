@@ -0,0 +1,91 @@
+// HeightPyramid_test.cpp
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "HeightPyramid.hpp"
+#include "TestHelpers.hpp"
+
+// --- Helpers ---
+
+// Finds the bounds of a rectangle of the heightmap by scanning every height
+static glm::vec2 scanBounds(const std::vector<std::vector<float>>& heightmap, int minX, int minZ, int maxX, int maxZ) {
+    glm::vec2 bounds(1e30f, -1e30f);
+    for (int z = minZ; z <= maxZ; z++) {
+        for (int x = minX; x <= maxX; x++) {
+            bounds.x = std::min(bounds.x, heightmap[z][x]);
+            bounds.y = std::max(bounds.y, heightmap[z][x]);
+        }
+    }
+    return bounds;
+}
+
+// Compares the lowest and highest heights of two bounds
+static void expectBoundsEq(const glm::vec2& actual, const glm::vec2& expected) {
+    EXPECT_EQ(actual.x, expected.x);
+    EXPECT_EQ(actual.y, expected.y);
+}
+
+// --- Tests ---
+
+TEST(HeightPyramidTest, LevelsTest) {
+    // 1026 heights give 129 tiles on the first level and need nine merges to reach a single tile
+    std::vector<std::vector<float>> heightmap = makeRandomHeightmap(1026, 1026, 1);
+    HeightPyramid pyramid(heightmap);
+    EXPECT_EQ(pyramid.getLevelCount(), 9);
+    EXPECT_EQ(pyramid.getTilesPerAxisX(0), 129);
+    EXPECT_EQ(pyramid.getTilesPerAxisZ(0), 129);
+    EXPECT_EQ(pyramid.getTilesPerAxisX(8), 1);
+    glm::vec2 whole = scanBounds(heightmap, 0, 0, 1025, 1025);
+    expectBoundsEq(pyramid.getBounds(), whole);
+    expectBoundsEq(pyramid.getBounds(0, 0, 1025, 1025), whole);
+}
+
+TEST(HeightPyramidTest, ExactRectanglesTest) {
+    std::vector<std::vector<float>> heightmap = makeRandomHeightmap(100, 70, 2);
+    HeightPyramid pyramid(heightmap);
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<int> columns(0, 99);
+    std::uniform_int_distribution<int> rows(0, 69);
+    for (int i = 0; i < 500; i++) {
+        int x0 = columns(generator), x1 = columns(generator);
+        int z0 = rows(generator), z1 = rows(generator);
+        int minX = std::min(x0, x1), maxX = std::max(x0, x1);
+        int minZ = std::min(z0, z1), maxZ = std::max(z0, z1);
+        expectBoundsEq(pyramid.getBounds(heightmap, minX, minZ, maxX, maxZ), scanBounds(heightmap, minX, minZ, maxX, maxZ));
+    }
+}
+
+TEST(HeightPyramidTest, ConservativeRectanglesTest) {
+    std::vector<std::vector<float>> heightmap = makeRandomHeightmap(100, 70, 4);
+    HeightPyramid pyramid(heightmap);
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<int> columns(0, 99);
+    std::uniform_int_distribution<int> rows(0, 69);
+    for (int i = 0; i < 500; i++) {
+        int x0 = columns(generator), x1 = columns(generator);
+        int z0 = rows(generator), z1 = rows(generator);
+        int minX = std::min(x0, x1), maxX = std::max(x0, x1);
+        int minZ = std::min(z0, z1), maxZ = std::max(z0, z1);
+        glm::vec2 exact = scanBounds(heightmap, minX, minZ, maxX, maxZ);
+        glm::vec2 bounds = pyramid.getBounds(minX, minZ, maxX, maxZ);
+        EXPECT_LE(bounds.x, exact.x);
+        EXPECT_GE(bounds.y, exact.y);
+    }
+}
+
+TEST(HeightPyramidTest, TileAlignedRectangleIsExactTest) {
+    // A rectangle made of whole tiles needs no heightmap to be exact
+    std::vector<std::vector<float>> heightmap = makeRandomHeightmap(64, 64, 6);
+    HeightPyramid pyramid(heightmap);
+    expectBoundsEq(pyramid.getBounds(8, 16, 39, 31), scanBounds(heightmap, 8, 16, 39, 31));
+}
+
+TEST(HeightPyramidTest, ClampedRectangleTest) {
+    std::vector<std::vector<float>> heightmap = makeRandomHeightmap(20, 20, 7);
+    HeightPyramid pyramid(heightmap);
+    expectBoundsEq(pyramid.getBounds(heightmap, -5, -5, 30, 30), pyramid.getBounds());
+    glm::vec2 outside = pyramid.getBounds(heightmap, 25, 25, 30, 30);
+    EXPECT_GT(outside.x, outside.y);
+}
@@ -0,0 +1,85 @@
+// HeightUpsampler_test.cpp
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "HeightUpsampler.hpp"
+#include "Utility.hpp"
+#include "TestHelpers.hpp"
+
+// --- Helpers ---
+
+// Copies a heightmap into one block stored row by row
+static std::vector<float> flatten(const std::vector<std::vector<float>>& heightmap) {
+    std::vector<float> heights;
+    for (const auto& row : heightmap) {
+        heights.insert(heights.end(), row.begin(), row.end());
+    }
+    return heights;
+}
+
+// Checks every upsampled height against interpolating that vertex on its own
+static void expectMatchesBicubic(int size, int factor, unsigned int seed) {
+    std::vector<std::vector<float>> heightmap = makeRandomHeightmap(size, size, seed);
+    std::vector<float> heights = flatten(heightmap);
+    HeightView view{heights.data(), size, size, size};
+    std::vector<float> upsampled = HeightUpsampler::upsample(view, factor);
+    int outputSize = size * factor;
+    ASSERT_EQ(upsampled.size(), static_cast<size_t>(outputSize * outputSize));
+    for (int j = 0; j < outputSize; j++) {
+        for (int i = 0; i < outputSize; i++) {
+            glm::vec2 position(static_cast<float>(i) / factor, static_cast<float>(j) / factor);
+            float expected = Utility::bicubic_interpolation(position, heightmap);
+            ASSERT_NEAR(upsampled[j * outputSize + i], expected, 1e-5f) << "at " << i << ", " << j;
+        }
+    }
+}
+
+// --- Tests ---
+
+TEST(HeightUpsamplerTest, WeightsSumToOneTest) {
+    for (int factor = 1; factor <= 8; factor++) {
+        std::vector<float> weights = HeightUpsampler::computeWeights(factor);
+        ASSERT_EQ(weights.size(), static_cast<size_t>(factor * 4));
+        for (int phase = 0; phase < factor; phase++) {
+            float sum = weights[phase * 4] + weights[phase * 4 + 1] + weights[phase * 4 + 2] + weights[phase * 4 + 3];
+            EXPECT_NEAR(sum, 1.0f, 1e-6f);
+        }
+    }
+}
+
+TEST(HeightUpsamplerTest, FactorOneIsExactTest) {
+    std::vector<std::vector<float>> heightmap = makeRandomHeightmap(34, 34, 1);
+    std::vector<float> heights = flatten(heightmap);
+    HeightView view{heights.data(), 34, 34, 34};
+    EXPECT_EQ(HeightUpsampler::upsample(view, 1), heights);
+}
+
+TEST(HeightUpsamplerTest, MatchesBicubicInterpolationTest) {
+    expectMatchesBicubic(34, 2, 2);
+    expectMatchesBicubic(34, 4, 3);
+    expectMatchesBicubic(7, 3, 4);
+    expectMatchesBicubic(34, 1, 6);
+    expectMatchesBicubic(33, 2, 7);
+}
+
+TEST(HeightUpsamplerTest, StridedViewTest) {
+    // A view of the middle of a larger heightmap only reads the heights inside the view
+    std::vector<std::vector<float>> heightmap = makeRandomHeightmap(20, 20, 5);
+    std::vector<float> heights = flatten(heightmap);
+    HeightView view{&heights[3 * 20 + 2], 8, 8, 20};
+    std::vector<float> upsampled = HeightUpsampler::upsample(view, 2);
+    ASSERT_EQ(upsampled.size(), static_cast<size_t>(16 * 16));
+    for (int z = 0; z < 8; z++) {
+        for (int x = 0; x < 8; x++) {
+            EXPECT_FLOAT_EQ(upsampled[(z * 2) * 16 + x * 2], heightmap[z + 3][x + 2]);
+        }
+    }
+    // Heights between the view and the rest of the heightmap are interpolated from the view alone
+    std::vector<std::vector<float>> inside(8, std::vector<float>(8));
+    for (int z = 0; z < 8; z++) {
+        for (int x = 0; x < 8; x++) {
+            inside[z][x] = heightmap[z + 3][x + 2];
+        }
+    }
+    EXPECT_NEAR(upsampled[15 * 16 + 15], Utility::bicubic_interpolation(glm::vec2(7.5f, 7.5f), inside), 1e-5f);
+}
@@ -0,0 +1,97 @@
+// HorizonCuller_test.cpp
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "HorizonCuller.hpp"
+
+// --- Helpers ---
+
+// Builds a row of 31 unit wide subchunks along the positive x axis with the given heights
+static std::vector<HorizonBounds> makeRow(const std::vector<float>& heights, bool occluders = true) {
+    std::vector<HorizonBounds> bounds;
+    for (size_t i = 0; i < heights.size(); i++) {
+        float minX = 31.0f * static_cast<float>(i);
+        bounds.push_back(HorizonBounds{minX, -15.5f, minX + 31.0f, 15.5f, heights[i], heights[i], occluders});
+    }
+    return bounds;
+}
+
+// --- Tests ---
+
+TEST(HorizonCullerTest, RidgeHidesValleyTest) {
+    HorizonCuller culler;
+    // The camera stands in a valley, a ridge two subchunks away hides the low ground behind it
+    std::vector<HorizonBounds> bounds = makeRow({10.0f, 10.0f, 150.0f, 10.0f, 20.0f, 10.0f});
+    std::vector<bool> visible = culler.cull(bounds, glm::vec3(15.5f, 12.0f, 0.0f));
+    EXPECT_TRUE(visible[0]);
+    EXPECT_TRUE(visible[1]);
+    EXPECT_TRUE(visible[2]);
+    // The subchunk right behind the ridge overlaps it in distance so the ridge is not yet known to
+    // be in front of it
+    EXPECT_TRUE(visible[3]);
+    EXPECT_FALSE(visible[4]);
+    EXPECT_FALSE(visible[5]);
+    EXPECT_EQ(culler.getCulledCount(), 2);
+}
+
+TEST(HorizonCullerTest, PeakBehindRidgeVisibleTest) {
+    HorizonCuller culler;
+    // A peak far behind the ridge rises above the horizon and is still drawn
+    std::vector<HorizonBounds> bounds = makeRow({10.0f, 50.0f, 10.0f, 10.0f, 400.0f});
+    std::vector<bool> visible = culler.cull(bounds, glm::vec3(15.5f, 12.0f, 0.0f));
+    EXPECT_TRUE(visible[2]);
+    EXPECT_FALSE(visible[3]);
+    EXPECT_TRUE(visible[4]);
+}
+
+TEST(HorizonCullerTest, CameraAboveRidgeTest) {
+    HorizonCuller culler;
+    std::vector<HorizonBounds> bounds = makeRow({10.0f, 10.0f, 150.0f, 10.0f, 20.0f, 10.0f});
+    std::vector<bool> visible = culler.cull(bounds, glm::vec3(15.5f, 1000.0f, 0.0f));
+    for (bool isVisible : visible) {
+        EXPECT_TRUE(isVisible);
+    }
+    EXPECT_EQ(culler.getCulledCount(), 0);
+}
+
+TEST(HorizonCullerTest, NonOccludersTest) {
+    HorizonCuller culler;
+    // Fading or placeholder terrain is tested but never hides anything
+    std::vector<HorizonBounds> bounds = makeRow({10.0f, 10.0f, 150.0f, 10.0f, 20.0f, 10.0f}, false);
+    std::vector<bool> visible = culler.cull(bounds, glm::vec3(15.5f, 12.0f, 0.0f));
+    for (bool isVisible : visible) {
+        EXPECT_TRUE(isVisible);
+    }
+}
+
+TEST(HorizonCullerTest, NarrowRidgeDoesNotHideWiderTerrainTest) {
+    HorizonCuller culler;
+    // A single tall subchunk cannot hide a wider row of subchunks behind it at the sides
+    std::vector<HorizonBounds> bounds = makeRow({10.0f, 10.0f, 150.0f});
+    for (int i = -3; i <= 3; i++) {
+        float minZ = -15.5f + 31.0f * static_cast<float>(i);
+        bounds.push_back(HorizonBounds{124.0f, minZ, 155.0f, minZ + 31.0f, 10.0f, 10.0f, true});
+    }
+    std::vector<bool> visible = culler.cull(bounds, glm::vec3(15.5f, 12.0f, 0.0f));
+    EXPECT_FALSE(visible[6]);
+    EXPECT_TRUE(visible[3]);
+    EXPECT_TRUE(visible[9]);
+}
+
+TEST(HorizonCullerTest, PassesDoNotShareStateTest) {
+    HorizonCuller culler;
+    // The buffers kept between passes must not leak the horizon or the results of an earlier pass
+    std::vector<HorizonBounds> ridge = makeRow({10.0f, 10.0f, 150.0f, 10.0f, 20.0f, 10.0f});
+    std::vector<HorizonBounds> flat = makeRow({10.0f, 10.0f, 10.0f});
+    culler.cull(ridge, glm::vec3(15.5f, 12.0f, 0.0f));
+    std::vector<bool> visible = culler.cull(flat, glm::vec3(15.5f, 12.0f, 0.0f));
+    ASSERT_EQ(visible.size(), 3u);
+    for (bool isVisible : visible) {
+        EXPECT_TRUE(isVisible);
+    }
+    EXPECT_EQ(culler.getCulledCount(), 0);
+    visible = culler.cull(ridge, glm::vec3(15.5f, 12.0f, 0.0f));
+    EXPECT_FALSE(visible[4]);
+    EXPECT_FALSE(visible[5]);
+    EXPECT_EQ(culler.getCulledCount(), 2);
+}
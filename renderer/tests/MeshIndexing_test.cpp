@@ -0,0 +1,56 @@
+// MeshIndexing_test.cpp
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+#include "MeshIndexing.hpp"
+
+// --- Helpers ---
+
+// Returns the triangles of an index buffer rotated to start at their smallest index, so the
+// winding is kept but the order the triangles are emitted in is ignored
+static std::vector<std::array<unsigned int, 3>> sortedTriangles(const std::vector<unsigned int>& indices) {
+    std::vector<std::array<unsigned int, 3>> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<unsigned int, 3> triangle = {indices[i], indices[i + 1], indices[i + 2]};
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// --- Tests ---
+
+TEST(MeshIndexingTest, SameTrianglesTest) {
+    for (int n : {2, 9, 32, 33, 63}) {
+        std::vector<unsigned int> rowOrder = MeshIndexing::generateRowOrderIndices(n);
+        std::vector<unsigned int> stripeOrder = MeshIndexing::generateStripeOrderIndices(n, 15);
+        EXPECT_EQ(rowOrder.size(), static_cast<size_t>((n - 1) * (n - 1) * 6));
+        EXPECT_EQ(sortedTriangles(rowOrder), sortedTriangles(stripeOrder));
+    }
+}
+
+TEST(MeshIndexingTest, EmptyGridTest) {
+    EXPECT_TRUE(MeshIndexing::generateStripeOrderIndices(1, 15).empty());
+    EXPECT_FLOAT_EQ(MeshIndexing::computeAcmr({}, 32), 0.0f);
+}
+
+TEST(MeshIndexingTest, AcmrBenchmarkTest) {
+    // Reports the average cache miss ratio of both orders for the mesh sizes used by the terrain
+    // at the low, medium and high quality resolutions
+    int cacheSize = MeshIndexing::DEFAULT_CACHE_SIZE;
+    int stripeWidth = MeshIndexing::getStripeWidth(cacheSize);
+    for (int n : {32, 63, 125}) {
+        float rowAcmr = MeshIndexing::computeAcmr(MeshIndexing::generateRowOrderIndices(n), cacheSize);
+        float stripeAcmr = MeshIndexing::computeAcmr(
+            MeshIndexing::generateStripeOrderIndices(n, stripeWidth), cacheSize
+        );
+        RecordProperty("row_acmr_" + std::to_string(n), std::to_string(rowAcmr));
+        RecordProperty("stripe_acmr_" + std::to_string(n), std::to_string(stripeAcmr));
+        EXPECT_LT(stripeAcmr, rowAcmr);
+        EXPECT_LT(stripeAcmr, 0.7f);
+    }
+}
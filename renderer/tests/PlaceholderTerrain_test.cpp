@@ -0,0 +1,66 @@
+// PlaceholderTerrain_test.cpp
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "PlaceholderTerrain.hpp"
+#include "Settings.hpp"
+
+// --- Tests ---
+
+TEST(PlaceholderTerrainTest, HeightmapDimensionsTest) {
+    auto settings = std::make_shared<Settings>();
+    PlaceholderTerrain generator(1234, settings);
+
+    std::vector<std::vector<float>> heightmap = generator.generateHeightmap(0, 0);
+
+    ASSERT_EQ(static_cast<int>(heightmap.size()), settings->getChunkSize() + 2);
+    ASSERT_EQ(static_cast<int>(heightmap[0].size()), settings->getChunkSize() + 2);
+    for (const auto& row : heightmap) {
+        for (float height : row) {
+            EXPECT_GE(height, 0.0f);
+            EXPECT_LE(height, 1.0f);
+        }
+    }
+}
+
+TEST(PlaceholderTerrainTest, DeterministicTest) {
+    auto settings = std::make_shared<Settings>();
+    PlaceholderTerrain first(42, settings);
+    PlaceholderTerrain second(42, settings);
+    PlaceholderTerrain other(43, settings);
+
+    EXPECT_EQ(first.generateHeightmap(3, -2), second.generateHeightmap(3, -2));
+    EXPECT_NE(first.generateHeightmap(3, -2), other.generateHeightmap(3, -2));
+}
+
+TEST(PlaceholderTerrainTest, SeamlessBorderTest) {
+    auto settings = std::make_shared<Settings>();
+    PlaceholderTerrain generator(7, settings);
+    int size = settings->getChunkSize();
+
+    // Chunk (0, 0) and chunk (1, 0) share the column of vertices along their common edge, which is
+    // index size - 1 + x in the first heightmap and index x in the second (both include a border)
+    std::vector<std::vector<float>> left = generator.generateHeightmap(0, 0);
+    std::vector<std::vector<float>> right = generator.generateHeightmap(1, 0);
+    for (int z = 0; z < size + 2; z++) {
+        EXPECT_FLOAT_EQ(left[z][size - 1], right[z][0]);
+        EXPECT_FLOAT_EQ(left[z][size], right[z][1]);
+        EXPECT_FLOAT_EQ(left[z][size + 1], right[z][2]);
+    }
+}
+
+TEST(PlaceholderTerrainTest, BiomesFollowSeaLevelTest) {
+    auto settings = std::make_shared<Settings>();
+    PlaceholderTerrain generator(99, settings);
+
+    std::vector<std::vector<float>> heightmap = generator.generateHeightmap(-1, 5);
+    std::vector<std::vector<uint8_t>> biomes = generator.generateBiomes(heightmap);
+
+    ASSERT_EQ(biomes.size(), heightmap.size());
+    for (size_t z = 0; z < heightmap.size(); z++) {
+        for (size_t x = 0; x < heightmap[z].size(); x++) {
+            EXPECT_EQ(heightmap[z][x] < settings->getSeaLevel(), biomes[z][x] == 30);
+        }
+    }
+}
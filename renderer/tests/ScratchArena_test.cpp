@@ -0,0 +1,65 @@
+// ScratchArena_test.cpp
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+#include "ScratchArena.hpp"
+
+// --- Tests ---
+
+TEST(ScratchArenaTest, AllocationsAreAlignedAndDistinctTest) {
+    ScratchArena arena;
+    float *first = arena.allocate<float>(3);
+    float *second = arena.allocate<float>(5);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 64, 0u);
+    EXPECT_GE(second, first + 3);
+}
+
+TEST(ScratchArenaTest, ScopeRewindsAndReusesMemoryTest) {
+    ScratchArena arena;
+    float *outer = arena.allocate<float>(16);
+    float *inner;
+    {
+        ScratchArena::Scope scope(arena);
+        inner = arena.allocate<float>(1024);
+    }
+    // Memory given back by the scope is handed out again without growing the arena
+    size_t capacity = arena.getCapacity();
+    {
+        ScratchArena::Scope scope(arena);
+        EXPECT_EQ(arena.allocate<float>(1024), inner);
+    }
+    EXPECT_EQ(arena.getCapacity(), capacity);
+    EXPECT_EQ(arena.allocate<float>(1), outer + 64 / sizeof(float));
+}
+
+TEST(ScratchArenaTest, LargeAllocationsAddBlocksTest) {
+    ScratchArena arena;
+    {
+        ScratchArena::Scope scope(arena);
+        arena.allocate<uint8_t>(1000);
+        arena.allocate<uint8_t>(3 << 20);
+        EXPECT_EQ(arena.getBlockCount(), 2);
+        EXPECT_GE(arena.getPeakBytes(), static_cast<size_t>(3 << 20));
+    }
+    // Once the arena has grown to a build no more blocks are needed for the same build
+    {
+        ScratchArena::Scope scope(arena);
+        arena.allocate<uint8_t>(1000);
+        arena.allocate<uint8_t>(3 << 20);
+    }
+    EXPECT_EQ(arena.getBlockCount(), 2);
+    arena.reset();
+    EXPECT_EQ(arena.getMarker().block, 0u);
+    EXPECT_EQ(arena.getMarker().used, 0u);
+}
+
+TEST(ScratchArenaTest, EachThreadHasItsOwnArenaTest) {
+    ScratchArena *mainArena = &ScratchArena::forThread();
+    ScratchArena *workerArena = nullptr;
+    std::thread worker([&workerArena]() { workerArena = &ScratchArena::forThread(); });
+    worker.join();
+    EXPECT_EQ(&ScratchArena::forThread(), mainArena);
+    EXPECT_NE(workerArena, mainArena);
+}
@@ -0,0 +1,107 @@
+// SlabPool_test.cpp
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+#include "SlabPool.hpp"
+
+// --- Helpers ---
+
+// An object that records how many of it are alive
+struct Tracked {
+    static int alive;
+    int value;
+    explicit Tracked(int inValue) : value(inValue) { alive++; }
+    ~Tracked() { alive--; }
+};
+int Tracked::alive = 0;
+
+// An object that is too large for the slots of the pools in these tests
+struct Large {
+    char bytes[4096];
+};
+
+// --- Tests ---
+
+TEST(SlabPoolTest, SlotsAreAlignedDistinctAndContiguousTest) {
+    SlabPool pool(100, 8);
+    EXPECT_EQ(pool.getSlotSize(), 128u);
+    std::vector<unsigned char *> slots;
+    for (int i = 0; i < 8; i++) {
+        slots.push_back(static_cast<unsigned char *>(pool.allocate()));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(slots.back()) % 64, 0u);
+    }
+    // The slots of a slab are handed out in address order
+    for (int i = 1; i < 8; i++) {
+        EXPECT_EQ(slots[i], slots[i - 1] + pool.getSlotSize());
+    }
+    EXPECT_EQ(pool.getSlabCount(), 1);
+    EXPECT_EQ(pool.getUsedCount(), 8);
+    EXPECT_EQ(pool.getFreeCount(), 0);
+    for (unsigned char *slot : slots) {
+        pool.deallocate(slot);
+    }
+}
+
+TEST(SlabPoolTest, ReleasedSlotsAreReusedBeforeGrowingTest) {
+    SlabPool pool(64, 4);
+    std::set<void *> first;
+    for (int i = 0; i < 4; i++) {
+        first.insert(pool.allocate());
+    }
+    for (void *slot : first) {
+        pool.deallocate(slot);
+    }
+    EXPECT_EQ(pool.getUsedCount(), 0);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(first.count(pool.allocate()), 1u);
+    }
+    EXPECT_EQ(pool.getSlabCount(), 1);
+    // Only a fifth slot needs another slab
+    pool.allocate();
+    EXPECT_EQ(pool.getSlabCount(), 2);
+    EXPECT_EQ(pool.getFreeCount(), 3);
+}
+
+TEST(SlabPoolTest, SharedObjectsLiveInThePoolTest) {
+    std::shared_ptr<SlabPool> pool = std::make_shared<SlabPool>(sizeof(Tracked) + 64, 16);
+    {
+        std::vector<std::shared_ptr<Tracked>> objects;
+        for (int i = 0; i < 20; i++) {
+            objects.push_back(std::allocate_shared<Tracked>(SlabAllocator<Tracked>(pool), i));
+        }
+        EXPECT_EQ(Tracked::alive, 20);
+        EXPECT_EQ(pool->getUsedCount(), 20);
+        EXPECT_EQ(pool->getSlabCount(), 2);
+        for (int i = 0; i < 20; i++) {
+            EXPECT_EQ(objects[i]->value, i);
+        }
+    }
+    EXPECT_EQ(Tracked::alive, 0);
+    EXPECT_EQ(pool->getUsedCount(), 0);
+}
+
+TEST(SlabPoolTest, PoolOutlivesItsOwnerTest) {
+    std::shared_ptr<Tracked> object;
+    std::weak_ptr<SlabPool> weakPool;
+    {
+        std::shared_ptr<SlabPool> pool = std::make_shared<SlabPool>(sizeof(Tracked) + 64, 4);
+        weakPool = pool;
+        object = std::allocate_shared<Tracked>(SlabAllocator<Tracked>(pool), 7);
+    }
+    // The allocator held by the object keeps the pool alive until the object is freed
+    EXPECT_FALSE(weakPool.expired());
+    EXPECT_EQ(object->value, 7);
+    object.reset();
+    EXPECT_TRUE(weakPool.expired());
+}
+
+TEST(SlabPoolTest, OversizedObjectsFallBackToTheHeapTest) {
+    std::shared_ptr<SlabPool> pool = std::make_shared<SlabPool>(64, 4);
+    std::shared_ptr<Large> large = std::allocate_shared<Large>(SlabAllocator<Large>(pool));
+    large->bytes[4095] = 1;
+    EXPECT_EQ(pool->getUsedCount(), 0);
+    EXPECT_EQ(pool->getSlabCount(), 0);
+}
@@ -0,0 +1,109 @@
+// SubChunkCache_test.cpp
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "SubChunkCache.hpp"
+
+// --- Helpers ---
+
+// Records which subchunks the cache demoted and evicted
+struct CacheLog {
+    std::vector<int> demoted;
+    std::vector<int> evicted;
+};
+
+static void insertEntry(SubChunkCache& cache, CacheLog& log, int id, size_t gpuBytes, size_t cpuBytes) {
+    static int owner = 0;
+    cache.insert(
+        &owner,
+        id,
+        gpuBytes,
+        cpuBytes,
+        [&log, id]() { log.demoted.push_back(id); },
+        [&log, id]() { log.evicted.push_back(id); }
+    );
+}
+
+// --- Tests ---
+
+TEST(SubChunkCacheTest, DemotesLeastRecentlyUsedTest) {
+    SubChunkCache cache(250, 1000);
+    CacheLog log;
+    insertEntry(cache, log, 1, 100, 10);
+    insertEntry(cache, log, 2, 100, 10);
+    EXPECT_TRUE(log.demoted.empty());
+    insertEntry(cache, log, 3, 100, 10);
+    // Only the oldest subchunk has to leave the GPU tier to fit the budget
+    ASSERT_EQ(log.demoted.size(), 1u);
+    EXPECT_EQ(log.demoted[0], 1);
+    EXPECT_EQ(cache.getGpuTierBytes(), 200u);
+    EXPECT_EQ(cache.getCpuTierBytes(), 10u);
+    EXPECT_EQ(cache.getEntryCount(), 3);
+    EXPECT_EQ(cache.getDemotions(), 1);
+}
+
+TEST(SubChunkCacheTest, EvictsFromCpuTierTest) {
+    SubChunkCache cache(0, 25);
+    CacheLog log;
+    insertEntry(cache, log, 1, 100, 10);
+    insertEntry(cache, log, 2, 100, 10);
+    insertEntry(cache, log, 3, 100, 10);
+    // With no GPU budget everything is demoted and the oldest is evicted from the CPU tier
+    EXPECT_EQ(log.demoted.size(), 3u);
+    ASSERT_EQ(log.evicted.size(), 1u);
+    EXPECT_EQ(log.evicted[0], 1);
+    EXPECT_EQ(cache.getEntryCount(), 2);
+    EXPECT_EQ(cache.getCpuTierBytes(), 20u);
+    EXPECT_EQ(cache.getEvictions(), 1);
+}
+
+TEST(SubChunkCacheTest, TakeRecordsTierTest) {
+    SubChunkCache cache(150, 1000);
+    int owner = 0;
+    cache.insert(&owner, 1, 100, 10, []() {}, []() {});
+    cache.insert(&owner, 2, 100, 10, []() {}, []() {});
+    EXPECT_EQ(cache.getTier(&owner, 1), CacheTier::CPU);
+    EXPECT_EQ(cache.getTier(&owner, 2), CacheTier::GPU);
+    cache.take(&owner, 1);
+    cache.take(&owner, 2);
+    // Taking a subchunk that is not cached is not counted
+    cache.take(&owner, 7);
+    cache.recordMiss();
+    EXPECT_EQ(cache.getCpuHits(), 1);
+    EXPECT_EQ(cache.getGpuHits(), 1);
+    EXPECT_FLOAT_EQ(cache.getHitRate(), 2.0f / 3.0f);
+    EXPECT_EQ(cache.getEntryCount(), 0);
+    EXPECT_EQ(cache.getGpuTierBytes(), 0u);
+    EXPECT_EQ(cache.getCpuTierBytes(), 0u);
+}
+
+TEST(SubChunkCacheTest, RemoveOwnerTest) {
+    SubChunkCache cache(1000, 1000);
+    int first = 0;
+    int second = 0;
+    int evicted = 0;
+    cache.insert(&first, 1, 100, 10, []() {}, [&evicted]() { evicted++; });
+    cache.insert(&second, 1, 100, 10, []() {}, [&evicted]() { evicted++; });
+    cache.insert(&first, 2, 100, 10, []() {}, [&evicted]() { evicted++; });
+    cache.removeOwner(&first);
+    // The chunk destroys its own subchunks so nothing is evicted through the callbacks
+    EXPECT_EQ(evicted, 0);
+    EXPECT_FALSE(cache.contains(&first, 1));
+    EXPECT_TRUE(cache.contains(&second, 1));
+    EXPECT_EQ(cache.getGpuTierBytes(), 100u);
+}
+
+TEST(SubChunkCacheTest, RetainOwnersTest) {
+    SubChunkCache cache(1000, 1000);
+    int first = 0;
+    int second = 0;
+    int evicted = 0;
+    cache.insert(&first, 1, 100, 10, []() {}, [&evicted]() { evicted++; });
+    cache.insert(&second, 1, 100, 10, []() {}, [&evicted]() { evicted++; });
+    cache.retainOwners({&second});
+    // The subchunks of removed chunks are evicted so their memory is freed
+    EXPECT_EQ(evicted, 1);
+    EXPECT_FALSE(cache.contains(&first, 1));
+    EXPECT_TRUE(cache.contains(&second, 1));
+    EXPECT_EQ(cache.getEvictions(), 1);
+}
@@ -0,0 +1,53 @@
+// TerrainVertex_test.cpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include "TerrainVertex.hpp"
+
+// --- Tests ---
+
+TEST(TerrainVertexTest, CompactSizeTest) {
+    EXPECT_EQ(sizeof(TerrainVertex), 12u);
+}
+
+TEST(TerrainVertexTest, HeightQuantisationTest) {
+    float minimum = -3.0f;
+    float range = 200.0f;
+    for (float height = minimum; height <= minimum + range; height += 7.3f) {
+        uint16_t quantised = TerrainVertex::quantiseHeight(height, minimum, range);
+        EXPECT_NEAR(TerrainVertex::dequantiseHeight(quantised, minimum, range), height, range / 65535.0f);
+    }
+    // Heights outside the range are clamped and an empty range maps to the lowest height
+    EXPECT_EQ(TerrainVertex::quantiseHeight(minimum - 1.0f, minimum, range), 0);
+    EXPECT_EQ(TerrainVertex::quantiseHeight(minimum + range + 1.0f, minimum, range), 65535);
+    EXPECT_EQ(TerrainVertex::quantiseHeight(5.0f, 5.0f, 0.0f), 0);
+}
+
+TEST(TerrainVertexTest, NormalRoundTripTest) {
+    // Cover both hemispheres as the skirts and overhanging slopes can face downwards
+    for (int i = 0; i < 16; i++) {
+        for (int j = 0; j <= 8; j++) {
+            float azimuth = i * 0.3927f;
+            float elevation = -1.5708f + j * 0.3927f;
+            glm::vec3 normal = glm::vec3(
+                std::cos(elevation) * std::cos(azimuth),
+                std::sin(elevation),
+                std::cos(elevation) * std::sin(azimuth)
+            );
+            TerrainVertex vertex = TerrainVertex(0, 0, 0, 0, normal);
+            glm::vec3 decoded = vertex.getNormal();
+            EXPECT_NEAR(decoded.x, normal.x, 1e-3f);
+            EXPECT_NEAR(decoded.y, normal.y, 1e-3f);
+            EXPECT_NEAR(decoded.z, normal.z, 1e-3f);
+        }
+    }
+}
+
+TEST(TerrainVertexTest, GridIndicesTest) {
+    TerrainVertex vertex = TerrainVertex(123, 4000, 17, 65535, glm::vec3(0.0f, 1.0f, 0.0f));
+    EXPECT_EQ(vertex.getGridX(), 123);
+    EXPECT_EQ(vertex.getGridZ(), 4000);
+    EXPECT_EQ(vertex.getHeight(), 17);
+    EXPECT_EQ(vertex.getMorphTarget(), 65535);
+}
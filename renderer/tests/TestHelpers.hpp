@@ -0,0 +1,45 @@
+// TestHelpers.hpp
+//
+// Helpers shared by the unit tests
+
+#ifndef TESTHELPERS_HPP
+#define TESTHELPERS_HPP
+
+#include <cmath>
+#include <future>
+#include <random>
+#include <vector>
+#include "WorkerPool.hpp"
+
+// Builds a heightmap of random heights between 0 and 1
+inline std::vector<std::vector<float>> makeRandomHeightmap(int width, int height, unsigned int seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<std::vector<float>> heightmap(height, std::vector<float>(width));
+    for (auto& row : heightmap) {
+        for (float& value : row) {
+            value = distribution(generator);
+        }
+    }
+    return heightmap;
+}
+
+// Builds the heightmap of a chunk, including its border, from a smooth wave around the middle height
+inline std::vector<std::vector<float>> makeWaveHeightmap(int chunkSize, float frequency) {
+    std::vector<std::vector<float>> heightmap(chunkSize + 2, std::vector<float>(chunkSize + 2));
+    for (int z = 0; z < chunkSize + 2; z++) {
+        for (int x = 0; x < chunkSize + 2; x++) {
+            heightmap[z][x] = 0.5f + 0.25f * std::sin(x * frequency) * std::cos(z * frequency);
+        }
+    }
+    return heightmap;
+}
+
+// Waits for every task submitted to a single threaded pool so far to finish
+inline void waitForWorkers(WorkerPool &workers) {
+    std::promise<void> done;
+    workers.submit([&done]() { done.set_value(); });
+    done.get_future().wait();
+}
+
+#endif // TESTHELPERS_HPP
@@ -0,0 +1,78 @@
+// WorkerPool_test.cpp
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <thread>
+#include "WorkerPool.hpp"
+#include "CancellationToken.hpp"
+#include "TestHelpers.hpp"
+
+// --- Tests ---
+
+TEST(WorkerPoolTest, TasksRunInOrderTest) {
+    WorkerPool workers(1);
+    std::vector<int> order;
+    for (int i = 0; i < 4; i++) {
+        workers.submit([&order, i]() { order.push_back(i); });
+    }
+    waitForWorkers(workers);
+    EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST(WorkerPoolTest, CancelledTasksAreSkippedTest) {
+    WorkerPool workers(1);
+    auto epoch = std::make_shared<std::atomic<uint64_t>>(0);
+    // Hold the worker so that the tasks are still queued when the epoch moves on
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    workers.submit([opened]() { opened.wait(); });
+    bool staleRan = false;
+    bool currentRan = false;
+    workers.submit([&staleRan]() { staleRan = true; }, CancellationToken(epoch));
+    epoch->fetch_add(1);
+    workers.submit([&currentRan]() { currentRan = true; }, CancellationToken(epoch));
+    gate.set_value();
+    waitForWorkers(workers);
+    EXPECT_FALSE(staleRan);
+    EXPECT_TRUE(currentRan);
+}
+
+TEST(WorkerPoolTest, SkippedTasksAreDestroyedTest) {
+    WorkerPool workers(1);
+    auto epoch = std::make_shared<std::atomic<uint64_t>>(0);
+    auto held = std::make_shared<int>(0);
+    std::weak_ptr<int> weakHeld = held;
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    workers.submit([opened]() { opened.wait(); });
+    workers.submit([held]() {}, CancellationToken(epoch));
+    held.reset();
+    epoch->fetch_add(1);
+    gate.set_value();
+    waitForWorkers(workers);
+    // A skipped task lets go of what it captured as soon as it is dropped
+    EXPECT_TRUE(weakHeld.expired());
+}
+
+TEST(WorkerPoolTest, ShutdownWaitsForRunningTasksTest) {
+    WorkerPool workers(1);
+    std::promise<void> started;
+    std::atomic<bool> finished(false);
+    workers.submit([&started, &finished]() {
+        started.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        finished = true;
+    });
+    started.get_future().wait();
+    workers.shutdown();
+    EXPECT_TRUE(finished);
+    // Tasks submitted after the shutdown are discarded
+    bool lateRan = false;
+    workers.submit([&lateRan]() { lateRan = true; });
+    workers.shutdown();
+    EXPECT_FALSE(lateRan);
+}